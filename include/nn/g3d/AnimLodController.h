@@ -0,0 +1,115 @@
+#pragma once
+
+#include <nn/os.h>
+
+#include "nn/g3d/SkeletonEvaluator.h"
+
+namespace nn::g3d {
+
+// throttles the animation of a skeleton by its size on screen. every lod level evaluates the
+// skeleton once per update interval, a pose ahead of time, and interpolates the world matrices
+// of the frames in between. bones whose whole subtree has ResBone::Flag_Visibility cleared are
+// always collapsed into their parent, and below the leaf collapse size so are the leaf bones.
+// the time spent from Update to CalculateWorld is measured to report what the throttling saves.
+//
+//     controller.Update(screenSize);
+//     if (controller.IsEvaluationFrame()) {
+//         // animate the skeleton GetLookAheadFrameCount() frames ahead of the current frame
+//     }
+//     controller.CalculateWorld(baseMtx);
+class AnimLodController {
+public:
+    static const int LodLevelCountMax = 4;
+
+    class InitializeArgument {
+    public:
+        explicit InitializeArgument(SkeletonEvaluator* pSkeleton)
+            : m_Skeleton(pSkeleton), m_MinScreenSize(), m_UpdateInterval(), m_LodLevelCount(1),
+              m_LeafCollapseScreenSize(0.0f) {
+            m_UpdateInterval[0] = 1;
+        }
+
+        // levels go from the nearest to the farthest. screenSize at or above minScreenSize
+        // selects the level, the last level taking what is left
+        void SetLodLevel(int level, float minScreenSize, int updateInterval) {
+            m_MinScreenSize[level] = minScreenSize;
+            m_UpdateInterval[level] = updateInterval;
+        }
+        void SetLodLevelCount(int value) { m_LodLevelCount = value; }
+        void SetLeafCollapseScreenSize(float value) { m_LeafCollapseScreenSize = value; }
+
+        SkeletonEvaluator* GetSkeleton() const { return m_Skeleton; }
+        float GetMinScreenSize(int level) const { return m_MinScreenSize[level]; }
+        int GetUpdateInterval(int level) const { return m_UpdateInterval[level]; }
+        int GetLodLevelCount() const { return m_LodLevelCount; }
+        float GetLeafCollapseScreenSize() const { return m_LeafCollapseScreenSize; }
+
+    private:
+        SkeletonEvaluator* m_Skeleton;
+        float m_MinScreenSize[LodLevelCountMax];
+        int m_UpdateInterval[LodLevelCountMax];
+        int m_LodLevelCount;
+        float m_LeafCollapseScreenSize;
+    };
+
+    static size_t CalculateBufferSize(const InitializeArgument& arg);
+    static size_t GetBufferAlignment();
+
+    AnimLodController();
+
+    bool Initialize(const InitializeArgument& arg, void* buffer, size_t bufferSize);
+
+    // selects the lod level of screenSize and advances the frame. screenSize is the projected
+    // size of the model relative to the screen, in the unit of the thresholds
+    void Update(float screenSize);
+
+    // the skeleton has to be animated this frame, to the pose GetLookAheadFrameCount() frames
+    // later than the current frame
+    bool IsEvaluationFrame() const { return m_IsEvaluationFrame; }
+    int GetLookAheadFrameCount() const { return m_LookAheadFrameCount; }
+
+    // calculates the world matrices on evaluation frames and interpolates them otherwise. levels
+    // with an update interval above 1 keep their poses relative to the model so baseMtx may move
+    // every frame, the callback then runs on evaluation frames and sees matrices without baseMtx
+    void CalculateWorld(const nn::util::FloatColumnMajor4x3& baseMtx,
+                        ICalculateWorldCallback* pCallback = nullptr);
+
+    // the estimated cost of a full evaluation minus what the last frame took, never negative
+    nn::os::Tick GetSavedTick() const { return m_SavedTick; }
+    nn::os::Tick GetElapsedTick() const { return m_ElapsedTick; }
+
+    int GetLodLevel() const { return m_LodLevel; }
+    SkeletonEvaluator* GetSkeleton() const { return m_Skeleton; }
+    bool IsInitialized() const { return m_Skeleton != nullptr; }
+
+private:
+    enum CollapseMode {
+        CollapseMode_Invisible,
+        CollapseMode_InvisibleAndLeaf,
+        CollapseMode_Count
+    };
+
+    void Reset();
+
+    SkeletonEvaluator* m_Skeleton;
+    nn::util::FloatColumnMajor4x3* m_PrevMtxArray;
+    nn::util::FloatColumnMajor4x3* m_NextMtxArray;
+    bool* m_ActiveArray[CollapseMode_Count];
+    float m_MinScreenSize[LodLevelCountMax];
+    int m_UpdateInterval[LodLevelCountMax];
+    int m_LodLevelCount;
+    float m_LeafCollapseScreenSize;
+    int m_LodLevel;
+    int m_CollapseMode;
+    int m_SegmentFrame;
+    int m_LookAheadFrameCount;
+    bool m_IsEvaluationFrame;
+    bool m_IsPrevValid;
+    bool m_IsNextValid;
+    nn::os::Tick m_BeginTick;
+    nn::os::Tick m_ElapsedTick;
+    nn::os::Tick m_FullTick;
+    nn::os::Tick m_SavedTick;
+};
+
+}  // namespace nn::g3d
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <nn/types.h>
+
+namespace nn::g3d {
+
+// a hierarchical depth buffer built on the cpu from a depth buffer read back from the gpu, for
+// occlusion tests of screen rectangles. level 0 is a downsampled copy, every texel holding the
+// farthest depth it covers, and each further level halves the previous one the same way. depth
+// goes from 0 at the near plane to 1 at the far plane and row 0 is the top of the screen.
+class HiZBuffer {
+public:
+    static const int LevelCountMax = 16;
+
+    // width and height are those of level 0 and have to be powers of two
+    static size_t CalculateBufferSize(int width, int height);
+    static size_t GetBufferAlignment();
+
+    HiZBuffer();
+
+    bool Initialize(int width, int height, void* buffer, size_t bufferSize);
+
+    // pDepth is depthWidth by depthHeight floats, rows being stride bytes apart
+    void Build(const float* pDepth, int depthWidth, int depthHeight, ptrdiff_t stride);
+
+    // the rectangle is in normalized screen coordinates [0, 1]. true when every texel it covers
+    // is nearer than minDepth; the level is picked so the rectangle spans at most 2x2 texels
+    bool IsOccluded(float left, float top, float right, float bottom, float minDepth) const;
+
+    int GetWidth() const { return m_Width; }
+    int GetHeight() const { return m_Height; }
+    int GetLevelCount() const { return m_LevelCount; }
+    const float* GetLevel(int level) const { return m_LevelArray[level]; }
+    bool IsInitialized() const { return m_LevelCount > 0; }
+
+private:
+    float* m_LevelArray[LevelCountMax];
+    int m_Width;
+    int m_Height;
+    int m_LevelCount;
+};
+
+}  // namespace nn::g3d
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <nn/gfx/gfx_Common.h>
+#include <nn/util.h>
+
+#include "nn/g3d/ResMaterial.h"
+#include "nn/g3d/ResMaterialAnim.h"
+
+namespace nn::g3d {
+
+// plays a ResMaterialAnim on materials: shader parameter, texture pattern and visibility
+// animations. every material is bound with its shader parameters and its uniform block, and
+// Calculate writes the animated parameters straight into the block in its packed layout. a value
+// is only written when its bytes differ from a CPU copy of what was last written, the block being
+// mapped GPU memory that is slow to read back, and the bytes written since the last flush are
+// kept as one dirty range per material, so flushing a block to the GPU costs what the frame
+// changed.
+// curves keep the key they were last evaluated at, as in SkeletalAnimObj.
+class MaterialAnimObj {
+    NN_NO_COPY(MaterialAnimObj);
+
+public:
+    typedef gfx::detail::BufferImpl<gfx::ApiVariationNvn8> BufferType;
+
+    class InitializeArgument {
+    public:
+        explicit InitializeArgument(const ResMaterialAnim* pResAnim) : m_ResAnim(pResAnim) {}
+
+        const ResMaterialAnim* GetResource() const { return m_ResAnim; }
+
+    private:
+        const ResMaterialAnim* m_ResAnim;
+    };
+
+    class BindArgument {
+    public:
+        // pSrcParam holds the source values of the parameters at their srcOffset, pUniformBlock
+        // is the block of the material the parameters are written to at their offset
+        BindArgument(const char* materialName, const ResShaderParam* pShaderParamArray,
+                     int shaderParamCount, const void* pSrcParam, void* pUniformBlock)
+            : m_MaterialName(materialName), m_ShaderParamArray(pShaderParamArray),
+              m_ShaderParamCount(shaderParamCount), m_SrcParam(pSrcParam),
+              m_UniformBlock(pUniformBlock) {}
+
+        const char* GetMaterialName() const { return m_MaterialName; }
+        const ResShaderParam* GetShaderParamArray() const { return m_ShaderParamArray; }
+        int GetShaderParamCount() const { return m_ShaderParamCount; }
+        const void* GetSrcParam() const { return m_SrcParam; }
+        void* GetUniformBlock() const { return m_UniformBlock; }
+
+    private:
+        const char* m_MaterialName;
+        const ResShaderParam* m_ShaderParamArray;
+        int m_ShaderParamCount;
+        const void* m_SrcParam;
+        void* m_UniformBlock;
+    };
+
+    static size_t CalculateBufferSize(const InitializeArgument& arg);
+    static size_t GetBufferAlignment();
+
+    MaterialAnimObj();
+
+    bool Initialize(const InitializeArgument& arg, void* buffer, size_t bufferSize);
+
+    // binds the animation of the material named in arg, matching the shader parameters by id.
+    // the constants of the animation are written to the block right away. returns the index of
+    // the material animation, or -1 when the animation does not drive the material
+    int Bind(const BindArgument& arg);
+
+    // looping animations wrap the frame into [0, GetFrameCount()), the others clamp it
+    void SetFrame(float frame);
+    float GetFrame() const { return m_Frame; }
+    int GetFrameCount() const { return m_Res->GetFrameCount(); }
+
+    // evaluates the animations of every bound material at the current frame
+    void Calculate();
+
+    // materials without a visibility animation are visible
+    bool IsVisible(int materialAnimIndex) const;
+
+    // the index in the texture names of the resource picked by a texture pattern animation
+    int GetTextureIndex(int materialAnimIndex, int patternIndex) const;
+
+    // the bytes of the uniform block written since the last ClearDirtyRange, the size being 0
+    // when nothing changed
+    size_t GetDirtyRange(int materialAnimIndex, ptrdiff_t* pOutOffset) const;
+    void ClearDirtyRange(int materialAnimIndex);
+
+    // flushes the dirty range of the block, which is mapped at blockOffset of pBuffer, and clears
+    // it. returns the bytes flushed
+    size_t FlushDirtyRange(int materialAnimIndex, BufferType* pBuffer, ptrdiff_t blockOffset);
+
+    bool IsBound(int materialAnimIndex) const;
+    int GetMaterialAnimCount() const { return m_Res->GetPerMaterialAnimCount(); }
+    const ResMaterialAnim* GetRes() const { return m_Res; }
+    bool IsInitialized() const { return m_Res != nullptr; }
+
+private:
+    // the largest source value, a Float4x4, which no converted value exceeds
+    static const int SrcParamSizeMax = 64;
+
+    struct MaterialState;
+    struct ParamState;
+
+    void CalculateMaterial(int materialAnimIndex);
+    void WriteParam(MaterialState* pMaterial, ParamState* pParamState);
+
+    const ResMaterialAnim* m_Res;
+    MaterialState* m_MaterialArray;
+    ParamState* m_ParamArray;
+    uint16_t* m_TextureIndexArray;
+    uint16_t* m_CursorArray;
+    float m_Frame;
+};
+
+}  // namespace nn::g3d
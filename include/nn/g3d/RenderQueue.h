@@ -0,0 +1,140 @@
+#pragma once
+
+#include <nn/gfx/gfx_Common.h>
+#include <nn/gfx/gfx_Enum.h>
+#include <nn/gfx/gfx_GpuAddress.h>
+#include <nn/util.h>
+
+namespace nn::g3d {
+
+// the draws of many models for a frame, sorted by a 64 bit key and submitted with as few state
+// changes as the order allows. every draw is a mesh of a shape drawn with a pipeline and a
+// material; the caller gathers the visible ones, from a ShapeCuller for instance, and adds them
+// with a key from MakeSortKey. the keys are radix sorted a byte per pass, passes where every key
+// holds the same byte being skipped, so the pass and pipeline bytes usually cost nothing.
+// on submission the pipeline, the material and the shape are only bound when they differ from
+// the previous draw, and a run of draws of the same mesh with the same state becomes one
+// instanced DrawIndexed. the instance data of every draw, its world matrix for example, is
+// written in sorted order to the instance buffer, which the vertex shader reads from vertex
+// buffer InstanceBufferIndex at the base instance. it is bound again after every shape callback,
+// so a callback binding the vertex buffers of its shape cannot leave another buffer in that slot.
+// skinned shapes are added with a state of their own, their skeleton, so they are never merged.
+class RenderQueue {
+    NN_NO_COPY(RenderQueue);
+
+public:
+    typedef gfx::detail::CommandBufferImpl<gfx::ApiVariationNvn8> CommandBufferType;
+    typedef gfx::detail::BufferImpl<gfx::ApiVariationNvn8> BufferType;
+    typedef gfx::detail::PipelineImpl<gfx::ApiVariationNvn8> PipelineType;
+
+    // binds a material or a shape, pState being what was added with the draw
+    typedef void (*BindCallback)(CommandBufferType* pCommandBuffer, const void* pState,
+                                 void* pUserData);
+
+    // the index buffer range of a mesh. draws of the same Mesh may be merged, so it must stay
+    // alive until Submit
+    struct Mesh {
+        gfx::PrimitiveTopology primitiveTopology;
+        gfx::IndexFormat indexFormat;
+        gfx::GpuAddress indexBufferAddress;
+        int indexCount;
+        int baseVertex;
+    };
+
+    class InitializeArgument {
+    public:
+        InitializeArgument(int maxDrawCount, size_t instanceDataSize)
+            : m_MaxDrawCount(maxDrawCount), m_InstanceDataSize(instanceDataSize),
+              m_InstanceBufferIndex(1) {}
+
+        void SetInstanceBufferIndex(int value) { m_InstanceBufferIndex = value; }
+
+        int GetMaxDrawCount() const { return m_MaxDrawCount; }
+        size_t GetInstanceDataSize() const { return m_InstanceDataSize; }
+        int GetInstanceBufferIndex() const { return m_InstanceBufferIndex; }
+
+    private:
+        int m_MaxDrawCount;
+        size_t m_InstanceDataSize;
+        int m_InstanceBufferIndex;
+    };
+
+    static size_t CalculateBufferSize(const InitializeArgument& arg);
+    static size_t GetBufferAlignment();
+
+    // the pass in the top 4 bits, then 12 bits of pipeline and 16 of material. order fills the
+    // low 32 bits: QuantizeDepth for passes sorted by depth, or the id of the mesh for passes
+    // meant to be instanced so the draws of a mesh end up next to each other
+    static uint64_t MakeSortKey(int pass, int pipelineId, int materialId, uint32_t order) {
+        return (uint64_t(pass & 0xF) << 60) | (uint64_t(pipelineId & 0xFFF) << 48) |
+               (uint64_t(materialId & 0xFFFF) << 32) | order;
+    }
+
+    // depth is the distance from the camera, which must not be negative
+    static uint32_t QuantizeDepth(float depth, bool isBackToFront);
+
+    RenderQueue();
+
+    bool Initialize(const InitializeArgument& arg, void* buffer, size_t bufferSize);
+
+    void SetMaterialCallback(BindCallback pCallback, void* pUserData) {
+        m_pMaterialCallback = pCallback;
+        m_pMaterialUserData = pUserData;
+    }
+    void SetShapeCallback(BindCallback pCallback, void* pUserData) {
+        m_pShapeCallback = pCallback;
+        m_pShapeUserData = pUserData;
+    }
+
+    // removes every draw, to be called once a frame before adding them
+    void Clear();
+
+    // pInstanceData points to GetInstanceDataSize() bytes that are copied by Submit and must stay
+    // alive until then, a null one giving zeros. returns false when the queue is full
+    bool Add(uint64_t sortKey, const PipelineType* pPipeline, const void* pMaterial,
+             const void* pShape, const Mesh* pMesh, const void* pInstanceData);
+
+    void Sort();
+
+    // draws in sorted order, writing the instance data at instanceBufferOffset of pInstanceBuffer,
+    // which pMappedInstanceBuffer maps, and flushing it. the buffer needs GetInstanceDataSize()
+    // bytes per draw
+    void Submit(CommandBufferType* pCommandBuffer, BufferType* pInstanceBuffer,
+                void* pMappedInstanceBuffer, ptrdiff_t instanceBufferOffset);
+
+    // what the last Submit issued
+    int GetDrawCallCount() const { return m_DrawCallCount; }
+    int GetPipelineChangeCount() const { return m_PipelineChangeCount; }
+    int GetMaterialChangeCount() const { return m_MaterialChangeCount; }
+    int GetShapeChangeCount() const { return m_ShapeChangeCount; }
+
+    int GetDrawCount() const { return m_DrawCount; }
+    size_t GetInstanceDataSize() const { return m_InstanceDataSize; }
+    bool IsInitialized() const { return m_pDrawArray != nullptr; }
+
+private:
+    static const int RadixBits = 8;
+    static const int RadixSize = 1 << RadixBits;
+    static const int RadixPassCount = 64 / RadixBits;
+
+    struct DrawRecord;
+
+    DrawRecord* m_pDrawArray;
+    uint64_t* m_KeyArray[2];
+    uint32_t* m_IndexArray[2];
+    BindCallback m_pMaterialCallback;
+    void* m_pMaterialUserData;
+    BindCallback m_pShapeCallback;
+    void* m_pShapeUserData;
+    size_t m_InstanceDataSize;
+    int m_InstanceBufferIndex;
+    int m_MaxDrawCount;
+    int m_DrawCount;
+    int m_SortedBuffer;
+    int m_DrawCallCount;
+    int m_PipelineChangeCount;
+    int m_MaterialChangeCount;
+    int m_ShapeChangeCount;
+};
+
+}  // namespace nn::g3d
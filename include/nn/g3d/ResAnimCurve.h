@@ -0,0 +1,118 @@
+/**
+ * @file ResAnimCurve.h
+ * @brief Resource file for animation curves.
+ */
+
+#pragma once
+
+#include <nn/nn_BitTypes.h>
+#include <nn/util/AccessorBase.h>
+#include <nn/util/util_BinTypes.h>
+
+namespace nn::g3d {
+
+struct ResAnimCurveData {
+    nn::util::BinPtr pFrameArray;
+    nn::util::BinPtr pKeyArray;
+    nn::Bit16 flag;
+    uint16_t keyCount;
+    uint32_t targetOffset;
+    float startFrame;
+    float endFrame;
+    union {
+        float fScale;
+        int32_t iScale;
+    };
+    union {
+        float fOffset;
+        int32_t iOffset;
+    };
+    union {
+        float fDelta;
+        int32_t iDelta;
+    };
+    uint8_t reserved[4];
+};
+
+class ResAnimCurve : public nn::util::AccessorBase<ResAnimCurveData> {
+public:
+    enum Shift {
+        Shift_Frame = 0,
+        Shift_Key = 2,
+        Shift_Curve = 4,
+        Shift_PreWrap = 8,
+        Shift_PostWrap = 12,
+    };
+
+    enum Mask {
+        Mask_Frame = 0x3 << Shift_Frame,
+        Mask_Key = 0x3 << Shift_Key,
+        Mask_Curve = 0x7 << Shift_Curve,
+        Mask_PreWrap = 0x3 << Shift_PreWrap,
+        Mask_PostWrap = 0x3 << Shift_PostWrap,
+    };
+
+    // frames are floats, signed 10.5 fixed point or unsigned bytes
+    enum FrameType {
+        FrameType_Quant32 = 0x0 << Shift_Frame,
+        FrameType_Quant16 = 0x1 << Shift_Frame,
+        FrameType_Quant8 = 0x2 << Shift_Frame,
+    };
+
+    // keys are floats or signed integers scaled by fScale
+    enum KeyType {
+        KeyType_Quant32 = 0x0 << Shift_Key,
+        KeyType_Quant16 = 0x1 << Shift_Key,
+        KeyType_Quant8 = 0x2 << Shift_Key,
+    };
+
+    // cubic keys hold the four coefficients of the hermite segment starting at the key, linear
+    // keys two; baked curves have a key per frame and no frame array
+    enum CurveType {
+        CurveType_Cubic = 0x0 << Shift_Curve,
+        CurveType_Linear = 0x1 << Shift_Curve,
+        CurveType_BakedFloat = 0x2 << Shift_Curve,
+        CurveType_StepInt = 0x4 << Shift_Curve,
+        CurveType_BakedInt = 0x5 << Shift_Curve,
+        CurveType_StepBool = 0x6 << Shift_Curve,
+        CurveType_BakedBool = 0x7 << Shift_Curve,
+    };
+
+    enum WrapMode {
+        WrapMode_Clamp,
+        WrapMode_Repeat,
+        WrapMode_Mirror,
+        WrapMode_RelativeRepeat,
+    };
+
+    ResAnimCurve(const ResAnimCurve&) = delete;
+    auto operator=(const ResAnimCurve&) = delete;
+
+    nn::Bit32 GetFrameType() const { return flag & Mask_Frame; }
+    nn::Bit32 GetKeyType() const { return flag & Mask_Key; }
+    nn::Bit32 GetCurveType() const { return flag & Mask_Curve; }
+    WrapMode GetPreWrapMode() const {
+        return static_cast<WrapMode>((flag & Mask_PreWrap) >> Shift_PreWrap);
+    }
+    WrapMode GetPostWrapMode() const {
+        return static_cast<WrapMode>((flag & Mask_PostWrap) >> Shift_PostWrap);
+    }
+    bool IsFloatCurve() const { return GetCurveType() <= CurveType_BakedFloat; }
+
+    int GetKeyCount() const { return keyCount; }
+    uint32_t GetTargetOffset() const { return targetOffset; }
+    float GetStartFrame() const { return startFrame; }
+    float GetEndFrame() const { return endFrame; }
+
+    // pCursor holds the key found by the previous call and is moved from there, so playback
+    // costs a step or two per call; without a cursor the key is binary searched
+    float EvaluateFloat(float frame, uint16_t* pCursor) const;
+
+private:
+    float WrapFrame(float frame, float* pOutCycle) const;
+    float GetFrame(int keyIndex) const;
+    float GetKey(int index) const;
+    int FindKey(float frame, uint16_t* pCursor) const;
+};
+
+}  // namespace nn::g3d
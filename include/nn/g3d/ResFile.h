@@ -9,6 +9,7 @@
 #include <nn/types.h>
 #include <nn/util.h>
 #include <nn/util/util_BinaryFormat.h>
+#include "nn/g3d/TextureBindTable.h"
 
 namespace nn {
 
@@ -24,6 +25,14 @@ class ResShapeAnim;
 class ResSceneAnim;
 typedef void* TextureRef;
 
+// the gpu buffers of the file, placed in the memory pool given to ResFile::Setup
+struct ResBufferMemoryPoolInfoData {
+    u32 property;
+    u32 size;
+    u64 pMemory;
+    u8 reserved[16];
+};
+
 class ResFile : public nn::util::BinaryFileHeader {
 public:
     static bool IsValid(void const* modelSrc);
@@ -31,12 +40,22 @@ public:
     void Unrelocate();
     static nn::g3d::ResFile* ResCast(void*);
     s32 BindTexture(nn::g3d::TextureRef (*ref)(char const*, void*), void*);
+    s32 BindTexture(nn::g3d::TextureBindTable* pTable) {
+        return BindTexture(TextureBindTable::BindCallback, pTable);
+    }
     void ReleaseTexture();
     void Setup(gfx::Device*);
     void Setup(gfx::Device*, gfx::MemoryPool*, s64, u64);
     void Cleanup(gfx::Device*);
     void Reset();
 
+    // the memory pool size Setup needs for the buffers of the file, valid once relocated
+    size_t GetBufferMemoryPoolSize() const {
+        return mBufferSection == 0
+                   ? 0
+                   : reinterpret_cast<const ResBufferMemoryPoolInfoData*>(mBufferSection)->size;
+    }
+
     u64 mFileNameLength;                  // _20
     nn::g3d::ResModel* mModels;           // _28
     u64 mModelDictOffset;                 // _30
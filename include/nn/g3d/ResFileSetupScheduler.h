@@ -0,0 +1,121 @@
+#pragma once
+
+#include <nn/gfx/gfx_Types.h>
+#include <nn/os/os_ThreadCommon.h>
+#include <nn/util.h>
+
+#include <atomic>
+
+namespace nn::g3d {
+
+class ResFile;
+
+class ResFileSetupSchedulerInfo {
+public:
+    ResFileSetupSchedulerInfo() {}
+
+    void SetDefault() {
+        SetWorkerCount(2);
+        SetMaxFileCount(512);
+        SetMemoryPoolAlignment(4096);
+        SetThreadStackSize(16 * 1024);
+        SetThreadPriority(nn::os::DefaultThreadPriority);
+    }
+
+    void SetWorkerCount(int value) { m_WorkerCount = value; }
+    void SetMaxFileCount(int value) { m_MaxFileCount = value; }
+    void SetMemoryPoolAlignment(size_t value) { m_MemoryPoolAlignment = value; }
+    void SetThreadStackSize(size_t value) { m_ThreadStackSize = value; }
+    void SetThreadPriority(int value) { m_ThreadPriority = value; }
+
+    int GetWorkerCount() const { return m_WorkerCount; }
+    int GetMaxFileCount() const { return m_MaxFileCount; }
+    size_t GetMemoryPoolAlignment() const { return m_MemoryPoolAlignment; }
+    size_t GetThreadStackSize() const { return m_ThreadStackSize; }
+    int GetThreadPriority() const { return m_ThreadPriority; }
+
+private:
+    int m_WorkerCount;
+    int m_MaxFileCount;
+    size_t m_MemoryPoolAlignment;
+    size_t m_ThreadStackSize;
+    int m_ThreadPriority;
+};
+
+// sets up many resource files on worker threads while the loading thread keeps running. Add lays
+// the buffers of every file out in one memory pool up front, Start splits the files into jobs and
+// hands them to the workers, which take the next job as they finish one so large and small jobs
+// even out, and the completed count can be polled for progress.
+// with a memory pool each file is one job, ResFile::Setup being what places the buffers of its
+// models in the pool. without one every model of a file is a job of its own, run by
+// ResModel::Setup, so a level packed into a single file is spread over the workers too. files
+// without models or with embedded files stay whole-file jobs, ResModel::Setup leaving the
+// embedded files out.
+class ResFileSetupScheduler {
+    NN_NO_COPY(ResFileSetupScheduler);
+
+public:
+    typedef ResFileSetupSchedulerInfo InfoType;
+
+    static size_t CalculateMemorySize(const InfoType& info);
+    static size_t GetMemoryAlignment();
+
+    ResFileSetupScheduler();
+    ~ResFileSetupScheduler();
+
+    // fails when memorySize is below CalculateMemorySize, when there is no worker or when a worker
+    // thread cannot be created
+    bool Initialize(const InfoType& info, void* pMemory, size_t memorySize);
+    void Finalize();
+
+    // forgets the files of the last run, which must be done
+    void Clear();
+
+    // pResFile must be relocated. fails when the file list is full
+    bool Add(ResFile* pResFile);
+
+    // the size of the memory pool region holding the buffers of every added file
+    size_t GetRequiredMemoryPoolSize() const { return m_RequiredSize; }
+    ptrdiff_t GetMemoryPoolOffset(int fileIndex) const;
+
+    // the files are set up in the region of pMemoryPool starting at memoryPoolOffset, which must be
+    // at least GetRequiredMemoryPoolSize() bytes. with a null pMemoryPool the models are set up one
+    // job each
+    void Start(gfx::Device* pDevice, gfx::MemoryPool* pMemoryPool, ptrdiff_t memoryPoolOffset);
+
+    // blocks until every file of the run is set up
+    void Wait();
+
+    // jobs of the run, the count is set by Start
+    int GetCompletedCount() const { return m_CompletedCount.load(std::memory_order_acquire); }
+    int GetJobCount() const { return m_JobCount; }
+    int GetFileCount() const { return m_FileCount; }
+    bool IsDone() const { return GetCompletedCount() == m_JobCount; }
+    bool IsInitialized() const { return m_pEntries != nullptr; }
+
+private:
+    struct Entry;
+    struct Worker;
+
+    static void WorkerThreadFunc(void* pArg);
+
+    void Execute();
+    void ExecuteJob(int jobIndex);
+
+    Entry* m_pEntries;
+    Worker* m_pWorkers;
+    gfx::Device* m_pDevice;
+    gfx::MemoryPool* m_pMemoryPool;
+    ptrdiff_t m_MemoryPoolOffset;
+    size_t m_MemoryPoolAlignment;
+    size_t m_RequiredSize;
+    int m_WorkerCount;
+    int m_MaxFileCount;
+    int m_FileCount;
+    int m_JobCount;
+    std::atomic<int> m_NextIndex;
+    std::atomic<int> m_CompletedCount;
+    std::atomic<bool> m_IsExitRequested;
+};
+
+}  // namespace nn::g3d
@@ -6,15 +6,104 @@
 #pragma once
 
 #include <nn/gfx/gfx_Types.h>
+#include <nn/nn_BitTypes.h>
 #include <nn/types.h>
+#include <nn/util/util_BinTypes.h>
+#include "nn/g3d/TextureBindTable.h"
+#include "nn/util/AccessorBase.h"
 
 namespace nn {
 namespace g3d {
 typedef void* TextureRef;
 
+struct ResShaderParamData {
+    nn::util::BinPtr pCallback;
+    nn::util::BinPtrToString pId;
+    nn::Bit8 type;
+    uint8_t srcSize;
+    uint16_t srcOffset;
+    int32_t offset;
+    uint16_t dependedIndex;
+    uint16_t dependIndex;
+    uint8_t reserved[4];
+};
+
+// a parameter of the uniform block of a material. the value is kept in the source parameters of
+// the material at srcOffset and written to the block at offset, converted by type
+class ResShaderParam : public nn::util::AccessorBase<ResShaderParamData> {
+public:
+    // matrices are rows of four floats. srt values are scale, rotate, translate and are written
+    // as the matrix they make. Texsrt starts with a TexsrtMode word telling which tool the
+    // values come from, as each composes them in its own order
+    enum Type {
+        Type_Bool,
+        Type_Bool2,
+        Type_Bool3,
+        Type_Bool4,
+        Type_Int,
+        Type_Int2,
+        Type_Int3,
+        Type_Int4,
+        Type_Uint,
+        Type_Uint2,
+        Type_Uint3,
+        Type_Uint4,
+        Type_Float,
+        Type_Float2,
+        Type_Float3,
+        Type_Float4,
+        Type_Reserved2,
+        Type_Float2x2,
+        Type_Float2x3,
+        Type_Float2x4,
+        Type_Reserved3,
+        Type_Float3x2,
+        Type_Float3x3,
+        Type_Float3x4,
+        Type_Reserved4,
+        Type_Float4x2,
+        Type_Float4x3,
+        Type_Float4x4,
+        Type_Srt2d,
+        Type_Srt3d,
+        Type_Texsrt,
+    };
+
+    enum TexsrtMode {
+        TexsrtMode_Maya,
+        TexsrtMode_3dsMax,
+        TexsrtMode_Softimage,
+    };
+
+    ResShaderParam(const ResShaderParam&) = delete;
+    auto operator=(const ResShaderParam&) = delete;
+
+    const char* GetId() const { return pId.Get()->GetData(); }
+    Type GetType() const { return static_cast<Type>(type); }
+    size_t GetSrcSize() const { return srcSize; }
+    int GetSrcOffset() const { return srcOffset; }
+    int GetOffset() const { return offset; }
+
+    // the size the value takes in the uniform block
+    size_t GetSize() const {
+        switch (GetType()) {
+        case Type_Srt2d:
+        case Type_Texsrt:
+            return sizeof(float) * 4 * 2;
+        case Type_Srt3d:
+            return sizeof(float) * 4 * 3;
+        default:
+            return srcSize;
+        }
+    }
+};
+
 class ResMaterial {
 public:
     u64 BindTexture(nn::g3d::TextureRef (*)(char const*, void*), void*);
+    u64 BindTexture(nn::g3d::TextureBindTable* pTable) {
+        return BindTexture(TextureBindTable::BindCallback, pTable);
+    }
     void ForceBindTexture(nn::g3d::TextureRef const&, char const*);
     void ReleaseTexture();
     void Setup(gfx::Device*);
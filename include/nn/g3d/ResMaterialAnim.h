@@ -5,15 +5,184 @@
 
 #pragma once
 
+#include <nn/nn_BitTypes.h>
+#include <nn/types.h>
+#include <nn/util/util_BinTypes.h>
+#include <nn/util/util_BinaryFormat.h>
+#include <nn/util/util_ResDic.h>
+#include "nn/g3d/ResAnimCurve.h"
+#include "nn/g3d/TextureBindTable.h"
+#include "nn/gfx/gfx_ResUserData.h"
+
 namespace nn {
 namespace g3d {
 typedef void* TextureRef;
 
-class ResMaterialAnim {
+// a value an animation holds for the whole of its length, at a byte offset of its target
+struct ResAnimConstantData {
+    uint32_t targetOffset;
+    union {
+        float fValue;
+        int32_t iValue;
+    };
+};
+
+class ResAnimConstant : public nn::util::AccessorBase<ResAnimConstantData> {
+public:
+    ResAnimConstant(const ResAnimConstant&) = delete;
+    auto operator=(const ResAnimConstant&) = delete;
+
+    uint32_t GetTargetOffset() const { return targetOffset; }
+    float GetFloat() const { return fValue; }
+    int GetInt() const { return iValue; }
+};
+
+struct ResShaderParamAnimInfoData {
+    nn::util::BinPtrToString pName;
+    uint16_t beginCurve;
+    uint16_t floatCurveCount;
+    uint16_t intCurveCount;
+    uint16_t beginConstant;
+    uint16_t constantCount;
+    uint16_t subbindIndex;
+    uint8_t reserved[4];
+};
+
+// the curves and constants of a shader parameter, targeting byte offsets of its source value
+class ResShaderParamAnimInfo : public nn::util::AccessorBase<ResShaderParamAnimInfoData> {
+public:
+    ResShaderParamAnimInfo(const ResShaderParamAnimInfo&) = delete;
+    auto operator=(const ResShaderParamAnimInfo&) = delete;
+
+    const char* GetName() const { return pName.Get()->GetData(); }
+    int GetBeginCurve() const { return beginCurve; }
+    int GetCurveCount() const { return floatCurveCount + intCurveCount; }
+    int GetBeginConstant() const { return beginConstant; }
+    int GetConstantCount() const { return constantCount; }
+};
+
+struct ResTexturePatternAnimInfoData {
+    nn::util::BinPtrToString pName;
+    int16_t curveIndex;
+    int16_t constantIndex;
+    uint8_t subbindIndex;
+    uint8_t reserved[3];
+};
+
+// picks a texture of the animation for a sampler, from a curve or a constant
+class ResTexturePatternAnimInfo : public nn::util::AccessorBase<ResTexturePatternAnimInfoData> {
+public:
+    ResTexturePatternAnimInfo(const ResTexturePatternAnimInfo&) = delete;
+    auto operator=(const ResTexturePatternAnimInfo&) = delete;
+
+    const char* GetName() const { return pName.Get()->GetData(); }
+    int GetCurveIndex() const { return curveIndex; }
+    int GetConstantIndex() const { return constantIndex; }
+};
+
+struct ResPerMaterialAnimData {
+    nn::util::BinPtrToString pName;
+    nn::util::BinTPtr<ResShaderParamAnimInfo> pShaderParamAnimInfoArray;
+    nn::util::BinTPtr<ResTexturePatternAnimInfo> pTexturePatternAnimInfoArray;
+    nn::util::BinTPtr<ResAnimCurve> pCurveArray;
+    nn::util::BinTPtr<ResAnimConstant> pConstantArray;
+    uint16_t beginShaderParamCurveIndex;
+    uint16_t beginTexturePatternCurveIndex;
+    uint16_t beginVisibilityCurveIndex;
+    int16_t visibilityCurveIndex;
+    int16_t visibilityConstantIndex;
+    uint16_t shaderParamAnimCount;
+    uint16_t texturePatternAnimCount;
+    uint16_t constantCount;
+    uint16_t curveCount;
+    uint8_t reserved[6];
+};
+
+// the animation of one material. the shader parameter curves come first in the curve array, then
+// the texture pattern curves and the visibility curve; the begin indices place them among the
+// curves of the whole ResMaterialAnim
+class ResPerMaterialAnim : public nn::util::AccessorBase<ResPerMaterialAnimData> {
 public:
+    ResPerMaterialAnim(const ResPerMaterialAnim&) = delete;
+    auto operator=(const ResPerMaterialAnim&) = delete;
+
+    const char* GetName() const { return pName.Get()->GetData(); }
+    int GetShaderParamAnimCount() const { return shaderParamAnimCount; }
+    int GetTexturePatternAnimCount() const { return texturePatternAnimCount; }
+    int GetCurveCount() const { return curveCount; }
+    int GetBeginCurve() const { return beginShaderParamCurveIndex; }
+    int GetVisibilityCurveIndex() const { return visibilityCurveIndex; }
+    int GetVisibilityConstantIndex() const { return visibilityConstantIndex; }
+
+    const ResShaderParamAnimInfo* GetShaderParamAnimInfo(int index) const {
+        return &pShaderParamAnimInfoArray.Get()[index];
+    }
+    const ResTexturePatternAnimInfo* GetTexturePatternAnimInfo(int index) const {
+        return &pTexturePatternAnimInfoArray.Get()[index];
+    }
+    const ResAnimCurve* GetCurve(int index) const { return &pCurveArray.Get()[index]; }
+    const ResAnimConstant* GetConstant(int index) const { return &pConstantArray.Get()[index]; }
+};
+
+struct ResMaterialAnimData {
+    nn::util::BinaryBlockHeader blockHeader;
+    nn::util::BinPtrToString pName;
+    nn::util::BinPtrToString pPath;
+    nn::util::BinPtr pBindModel;
+    nn::util::BinTPtr<uint16_t> pBindIndexArray;
+    nn::util::BinTPtr<ResPerMaterialAnim> pPerMaterialAnimArray;
+    nn::util::BinTPtr<nn::util::BinPtrToString> pTextureNameArray;
+    nn::util::BinTPtr<nn::gfx::ResUserData> pUserDataArray;
+    nn::util::BinTPtr<nn::util::ResDic> pUserDataDic;
+    nn::Bit16 flag;
+    uint16_t perMaterialAnimCount;
+    int32_t frameCount;
+    int32_t curveCount;
+    uint32_t bakedSize;
+    uint16_t shaderParamAnimCount;
+    uint16_t texturePatternAnimCount;
+    uint16_t visibilityAnimCount;
+    uint16_t textureCount;
+    uint16_t userDataCount;
+    uint8_t reserved[6];
+};
+
+class ResMaterialAnim : public nn::util::AccessorBase<ResMaterialAnimData> {
+public:
+    static constexpr uint32_t Signature = util::MakeSignature('F', 'M', 'A', 'A');
+
+    enum Flag {
+        Flag_CurveBaked = 0x1 << 0,
+        Flag_PlayPolicyLoop = 0x1 << 2,
+    };
+
+    ResMaterialAnim(const ResMaterialAnim&) = delete;
+    auto operator=(const ResMaterialAnim&) = delete;
+
     void ReleaseTexture();
     s32 BindTexture(nn::g3d::TextureRef (*)(char const*, void*), void*);
+    s32 BindTexture(nn::g3d::TextureBindTable* pTable) {
+        return BindTexture(TextureBindTable::BindCallback, pTable);
+    }
     void Reset();
+
+    const char* GetName() const { return pName.Get()->GetData(); }
+    int GetFrameCount() const { return frameCount; }
+    int GetCurveCount() const { return curveCount; }
+    int GetPerMaterialAnimCount() const { return perMaterialAnimCount; }
+    int GetShaderParamAnimCount() const { return shaderParamAnimCount; }
+    int GetTexturePatternAnimCount() const { return texturePatternAnimCount; }
+    int GetTextureCount() const { return textureCount; }
+    bool IsLooped() const { return (flag & Flag_PlayPolicyLoop) != 0; }
+
+    const ResPerMaterialAnim* GetPerMaterialAnim(int index) const {
+        return &pPerMaterialAnimArray.Get()[index];
+    }
+
+    // the textures picked by the texture pattern animations
+    const char* GetTextureName(int index) const {
+        return pTextureNameArray.Get()[index].Get()->GetData();
+    }
 };
 }  // namespace g3d
 }  // namespace nn
@@ -7,6 +7,7 @@
 
 #include <nn/gfx/gfx_Types.h>
 #include <nn/types.h>
+#include "nn/g3d/TextureBindTable.h"
 
 namespace nn {
 namespace g3d {
@@ -17,6 +18,9 @@ typedef void* TextureRef;
 class ResModel {
 public:
     u64 BindTexture(nn::g3d::TextureRef (*)(char const*, void*), void*);
+    u64 BindTexture(nn::g3d::TextureBindTable* pTable) {
+        return BindTexture(TextureBindTable::BindCallback, pTable);
+    }
     void ForceBindTexture(nn::g3d::TextureRef const&, char const*);
     void ReleaseTexture();
     void Setup(gfx::Device*);
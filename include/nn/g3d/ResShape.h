@@ -0,0 +1,103 @@
+/**
+ * @file ResShape.h
+ * @brief Resource shape.
+ */
+
+#pragma once
+
+#include <nn/nn_BitTypes.h>
+#include <nn/util/util_BinTypes.h>
+#include <nn/util/util_BinaryFormat.h>
+#include <nn/util/util_ResDic.h>
+#include "nn/util/AccessorBase.h"
+#include "nn/util/MathTypes.h"
+
+namespace nn::g3d {
+
+// an axis aligned box in the space of the vertices, extent being the half size
+struct Bounding {
+    nn::util::Float3 center;
+    nn::util::Float3 extent;
+};
+
+struct ResMeshData {
+    nn::util::BinPtr pSubMeshArray;
+    nn::util::BinPtr pMemoryPool;
+    nn::util::BinPtr pIndexBuffer;
+    nn::util::BinPtr pIndexBufferInfo;
+    uint32_t indexBufferOffset;
+    uint32_t primitiveType;
+    uint32_t indexFormat;
+    uint32_t count;
+    uint32_t offset;
+    uint16_t subMeshCount;
+    uint16_t reserved;
+};
+
+class ResMesh : public nn::util::AccessorBase<ResMeshData> {
+public:
+    ResMesh(const ResMesh&) = delete;
+    auto operator=(const ResMesh&) = delete;
+
+    int GetSubMeshCount() const { return subMeshCount; }
+    int GetCount() const { return count; }
+};
+
+struct ResShapeData {
+    nn::util::BinaryBlockHeader blockHeader;
+    nn::util::BinPtrToString pName;
+    nn::util::BinPtr pVertex;
+    nn::util::BinTPtr<ResMesh> pMeshArray;
+    nn::util::BinTPtr<uint16_t> pSkinBoneIndexArray;
+    nn::util::BinPtr pKeyShapeArray;
+    nn::util::BinTPtr<nn::util::ResDic> pKeyShapeDic;
+    nn::util::BinTPtr<Bounding> pSubMeshBoundingArray;
+    nn::util::BinTPtr<float> pRadiusArray;
+    nn::util::BinPtr pUserPtr;
+    nn::Bit32 flag;
+    uint16_t index;
+    uint16_t materialIndex;
+    uint16_t boneIndex;
+    uint16_t vertexIndex;
+    uint16_t skinBoneIndexCount;
+    uint8_t vertexSkinCount;
+    uint8_t meshCount;
+    uint8_t keyShapeCount;
+    uint8_t targetAttrCount;
+    uint16_t reserved;
+};
+
+class ResShape : public nn::util::AccessorBase<ResShapeData> {
+public:
+    static constexpr uint32_t Signature = util::MakeSignature('F', 'S', 'H', 'P');
+
+    ResShape(const ResShape&) = delete;
+    auto operator=(const ResShape&) = delete;
+
+    const char* GetName() const { return pName.Get()->GetData(); }
+    int GetIndex() const { return index; }
+    int GetMaterialIndex() const { return materialIndex; }
+    int GetBoneIndex() const { return boneIndex; }
+    int GetVertexSkinCount() const { return vertexSkinCount; }
+    bool IsRigidBody() const { return vertexSkinCount == 0; }
+    bool IsRigidSkinning() const { return vertexSkinCount == 1; }
+    bool IsSmoothSkinning() const { return vertexSkinCount > 1; }
+    int GetMeshCount() const { return meshCount; }
+    int GetSkinBoneIndexCount() const { return skinBoneIndexCount; }
+
+    ResMesh* GetMesh(int index) { return &pMeshArray.Get()[index]; }
+    const ResMesh* GetMesh(int index) const { return &pMeshArray.Get()[index]; }
+
+    int GetSkinBoneIndex(int index) const { return pSkinBoneIndexArray.Get()[index]; }
+
+    // the bounds of the submeshes of the first mesh are followed by the bounds of the shape
+    const Bounding& GetSubMeshBounding(int index) const {
+        return pSubMeshBoundingArray.Get()[index];
+    }
+    const Bounding& GetBounding() const {
+        return GetSubMeshBounding(GetMesh(0)->GetSubMeshCount());
+    }
+    float GetRadius(int meshIndex) const { return pRadiusArray.Get()[meshIndex]; }
+};
+
+}  // namespace nn::g3d
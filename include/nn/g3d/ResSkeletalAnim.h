@@ -5,11 +5,134 @@
 
 #pragma once
 
-namespace nn {
-namespace g3d {
-class ResSkeletalAnim {
+#include <nn/nn_BitTypes.h>
+#include <nn/util/util_BinTypes.h>
+#include <nn/util/util_BinaryFormat.h>
+#include <nn/util/util_ResDic.h>
+#include "nn/g3d/ResAnimCurve.h"
+#include "nn/g3d/ResSkeleton.h"
+#include "nn/gfx/gfx_ResUserData.h"
+
+namespace nn::g3d {
+
+struct ResBoneAnimData {
+    nn::util::BinPtrToString pName;
+    nn::util::BinTPtr<ResAnimCurve> pCurveArray;
+    nn::util::BinPtr pBaseValueArray;
+    nn::Bit32 flag;
+    uint8_t beginRotate;
+    uint8_t beginTranslate;
+    uint8_t curveCount;
+    uint8_t beginBaseTranslate;
+    int32_t beginCurve;
+};
+
+class ResBoneAnim : public nn::util::AccessorBase<ResBoneAnimData> {
 public:
+    enum Flag {
+        Flag_BaseScale = 0x1 << 3,
+        Flag_BaseRotate = 0x1 << 4,
+        Flag_BaseTranslate = 0x1 << 5,
+        Flag_CurveScaleX = 0x1 << 6,
+        Flag_CurveScaleY = 0x1 << 7,
+        Flag_CurveScaleZ = 0x1 << 8,
+        Flag_CurveRotateX = 0x1 << 9,
+        Flag_CurveRotateY = 0x1 << 10,
+        Flag_CurveRotateZ = 0x1 << 11,
+        Flag_CurveRotateW = 0x1 << 12,
+        Flag_CurveTranslateX = 0x1 << 13,
+        Flag_CurveTranslateY = 0x1 << 14,
+        Flag_CurveTranslateZ = 0x1 << 15,
+    };
+
+    // curves target a byte offset of the evaluated bone, laid out as the flags, the scale, the
+    // translation and the rotation
+    enum TargetOffset {
+        TargetOffset_ScaleX = 0x04,
+        TargetOffset_ScaleY = 0x08,
+        TargetOffset_ScaleZ = 0x0C,
+        TargetOffset_TranslateX = 0x10,
+        TargetOffset_TranslateY = 0x14,
+        TargetOffset_TranslateZ = 0x18,
+        TargetOffset_RotateX = 0x20,
+        TargetOffset_RotateY = 0x24,
+        TargetOffset_RotateZ = 0x28,
+        TargetOffset_RotateW = 0x2C,
+    };
+
+    ResBoneAnim(const ResBoneAnim&) = delete;
+    auto operator=(const ResBoneAnim&) = delete;
+
+    const char* GetName() const { return pName.Get()->GetData(); }
+    nn::Bit32 GetFlag() const { return flag; }
+    int GetCurveCount() const { return curveCount; }
+    int GetBeginCurve() const { return beginCurve; }
+
+    ResAnimCurve* GetCurve(int index) { return &pCurveArray.Get()[index]; }
+    const ResAnimCurve* GetCurve(int index) const { return &pCurveArray.Get()[index]; }
+
+    // the base values hold the scale, the rotation and the translation in that order, each only
+    // when its Flag_Base* bit is set; a euler rotation is padded to four floats
+    const float* GetBaseValueArray() const {
+        return static_cast<const float*>(pBaseValueArray.Get());
+    }
+};
+
+struct ResSkeletalAnimData {
+    nn::util::BinaryBlockHeader blockHeader;
+    nn::util::BinPtrToString pName;
+    nn::util::BinPtrToString pPath;
+    nn::util::BinTPtr<ResSkeleton> pBindSkeleton;
+    nn::util::BinTPtr<uint16_t> pBindIndexArray;
+    nn::util::BinTPtr<ResBoneAnim> pBoneAnimArray;
+    nn::util::BinTPtr<nn::gfx::ResUserData> pUserDataArray;
+    nn::util::BinTPtr<nn::util::ResDic> pUserDataDic;
+    nn::Bit32 flag;
+    int32_t frameCount;
+    int32_t curveCount;
+    uint32_t bakedSize;
+    uint16_t boneAnimCount;
+    uint16_t userDataCount;
+};
+
+class ResSkeletalAnim : public nn::util::AccessorBase<ResSkeletalAnimData> {
+public:
+    static constexpr uint32_t Signature = util::MakeSignature('F', 'S', 'K', 'A');
+
+    enum Shift {
+        Shift_Scale = 8,
+        Shift_Rot = 12,
+    };
+
+    enum Flag {
+        Flag_CurveBaked = 0x1 << 0,
+        Flag_PlayPolicyLoop = 0x1 << 2,
+    };
+
+    enum RotateMode {
+        RotateMode_Quat = 0x0 << Shift_Rot,
+        RotateMode_EulerXyz = 0x1 << Shift_Rot,
+    };
+
+    enum Mask {
+        Mask_Scale = 0x3 << Shift_Scale,
+        Mask_Rot = 0x7 << Shift_Rot,
+    };
+
+    ResSkeletalAnim(const ResSkeletalAnim&) = delete;
+    auto operator=(const ResSkeletalAnim&) = delete;
+
     void Reset();
+
+    const char* GetName() const { return pName.Get()->GetData(); }
+    int GetFrameCount() const { return frameCount; }
+    int GetCurveCount() const { return curveCount; }
+    int GetBoneAnimCount() const { return boneAnimCount; }
+    bool IsLooped() const { return (flag & Flag_PlayPolicyLoop) != 0; }
+    nn::Bit32 GetRotateMode() const { return flag & Mask_Rot; }
+
+    ResBoneAnim* GetBoneAnim(int index) { return &pBoneAnimArray.Get()[index]; }
+    const ResBoneAnim* GetBoneAnim(int index) const { return &pBoneAnimArray.Get()[index]; }
 };
-}  // namespace g3d
-}  // namespace nn
+
+}  // namespace nn::g3d
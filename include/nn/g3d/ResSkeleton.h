@@ -73,6 +73,11 @@ public:
         Flag_BillboardIndexNone = 0xFFFF,
     };
 
+    enum RotateMode {
+        RotateMode_Quat = 0x0 << Shift_Rot,
+        RotateMode_EulerXyz = 0x1 << Shift_Rot,
+    };
+
     enum Mask {
         Mask_Rot = 0x7 << Shift_Rot,
         Mask_Billboard = 0x7 << Shift_Billboard,
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <nn/types.h>
+
+#include "nn/util/MathTypes.h"
+
+namespace nn::g3d {
+
+class HiZBuffer;
+class ResShape;
+class SkeletonEvaluator;
+
+// culls shapes against the view volume and optionally a HiZBuffer, leaving a compact list of
+// the visible ones for draw recording. the world bounds of every shape are gathered each frame
+// from its ResShape bounds and the posed skeleton into structure-of-arrays, and the view volume
+// test then takes CullWidth bounds per step. shapes that pass are tested against the HiZBuffer
+// one by one, their projected box standing in for the shape.
+class ShapeCuller {
+public:
+    static const int CullWidth = 8;
+    static const int PlaneCount = 6;
+
+    static size_t CalculateBufferSize(int maxShapeCount);
+    static size_t GetBufferAlignment();
+
+    ShapeCuller();
+
+    bool Initialize(int maxShapeCount, void* buffer, size_t bufferSize);
+
+    // removes every shape, to be called once a frame before adding them
+    void Clear();
+
+    // appends a shape posed by the world matrices of pSkeleton, which must be of the skeleton
+    // the shape was made for. rigid bodies follow their bone, skinned shapes take the union of
+    // their bounds moved by every skin bone. returns false when the culler is full
+    bool AddShape(uint32_t id, const ResShape* pShape, const SkeletonEvaluator& skeleton);
+
+    // appends a shape with bounds already in world space
+    bool AddBounds(uint32_t id, const nn::util::Float3& center, const nn::util::Float3& extent);
+
+    // the volume of the clip space of viewProj, depth going from 0 to 1. the matrix follows the
+    // column vector convention, m[row][column]
+    void SetViewProjection(const nn::util::FloatColumnMajor4x4& viewProj);
+
+    // pHiZBuffer may be nullptr to skip the occlusion test
+    void Cull(const HiZBuffer* pHiZBuffer = nullptr);
+
+    // the ids of the visible shapes in the order they were added
+    const uint32_t* GetVisibleIdArray() const { return m_VisibleIdArray; }
+    int GetVisibleCount() const { return m_VisibleCount; }
+    int GetShapeCount() const { return m_ShapeCount; }
+    int GetFrustumCulledCount() const { return m_FrustumCulledCount; }
+    int GetOcclusionCulledCount() const { return m_OcclusionCulledCount; }
+    bool IsInitialized() const { return m_IdArray != nullptr; }
+
+private:
+    enum BoundsElement {
+        BoundsElement_CenterX,
+        BoundsElement_CenterY,
+        BoundsElement_CenterZ,
+        BoundsElement_ExtentX,
+        BoundsElement_ExtentY,
+        BoundsElement_ExtentZ,
+        BoundsElement_Count
+    };
+
+    bool IsOccluded(const HiZBuffer& hiZBuffer, int index) const;
+
+    float* m_BoundsArray[BoundsElement_Count];
+    uint32_t* m_IdArray;
+    uint32_t* m_VisibleIdArray;
+    nn::util::Float4 m_PlaneArray[PlaneCount];
+    nn::util::FloatColumnMajor4x4 m_ViewProj;
+    int m_MaxShapeCount;
+    int m_ShapeCount;
+    int m_VisibleCount;
+    int m_FrustumCulledCount;
+    int m_OcclusionCulledCount;
+};
+
+}  // namespace nn::g3d
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "nn/g3d/SkeletonEvaluator.h"
+
+namespace nn::g3d {
+
+class SkeletalAnimObj;
+
+// blends the results of several SkeletalAnimObj into the local transforms of a SkeletonEvaluator.
+// every animation is accumulated over all bones at once with its weight times the bone weight
+// of the animation, quaternions being flipped into the hemisphere of the running sum; the sums
+// are then normalized. bones no animation drives keep their current local transform.
+class SkeletalAnimBlender {
+public:
+    static size_t CalculateBufferSize(int boneCount);
+    static size_t GetBufferAlignment();
+
+    SkeletalAnimBlender();
+
+    bool Initialize(int boneCount, void* buffer, size_t bufferSize);
+
+    // the animations must have been calculated for the skeleton of pSkeleton. updates the
+    // transform flags of pSkeleton
+    void Blend(SkeletonEvaluator* pSkeleton, const SkeletalAnimObj* const* ppAnims,
+               const float* pWeights, int animCount);
+
+    int GetBoneCount() const { return m_BoneCount; }
+    bool IsInitialized() const { return m_WeightSumArray != nullptr; }
+
+private:
+    float* m_SumArray[SkeletonEvaluator::LocalElement_Count];
+    float* m_WeightSumArray;
+    int m_BoneCount;
+};
+
+}  // namespace nn::g3d
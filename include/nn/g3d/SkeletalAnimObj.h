@@ -0,0 +1,74 @@
+#pragma once
+
+#include "nn/g3d/ResSkeletalAnim.h"
+#include "nn/g3d/SkeletonEvaluator.h"
+
+namespace nn::g3d {
+
+// plays a ResSkeletalAnim on the bones of a skeleton. bone animations are bound to the bones of
+// the same name, and every curve keeps the key it was last evaluated at, so advancing the frame
+// costs a step or two per curve instead of a search. the results are structure-of-arrays over
+// the bones of the skeleton, laid out like SkeletonEvaluator::GetLocalArray, and are applied by
+// SkeletalAnimBlender. euler animations are converted to quaternions here.
+class SkeletalAnimObj {
+public:
+    class InitializeArgument {
+    public:
+        InitializeArgument(const ResSkeletalAnim* pResAnim, const ResSkeleton* pResSkeleton)
+            : m_ResAnim(pResAnim), m_ResSkeleton(pResSkeleton) {}
+
+        const ResSkeletalAnim* GetResource() const { return m_ResAnim; }
+        const ResSkeleton* GetSkeleton() const { return m_ResSkeleton; }
+
+    private:
+        const ResSkeletalAnim* m_ResAnim;
+        const ResSkeleton* m_ResSkeleton;
+    };
+
+    static size_t CalculateBufferSize(const InitializeArgument& arg);
+    static size_t GetBufferAlignment();
+
+    SkeletalAnimObj();
+
+    bool Initialize(const InitializeArgument& arg, void* buffer, size_t bufferSize);
+
+    // looping animations wrap the frame into [0, GetFrameCount()), the others clamp it
+    void SetFrame(float frame);
+    float GetFrame() const { return m_Frame; }
+    int GetFrameCount() const { return m_Res->GetFrameCount(); }
+
+    // evaluates every curve at the current frame
+    void Calculate();
+
+    // bones the animation does not drive hold their bind pose
+    const float* GetResultArray(SkeletonEvaluator::LocalElement element) const {
+        return m_ResultArray[element];
+    }
+
+    // 1 for the bones the animation drives and 0 for the others
+    const float* GetBoneWeightArray() const { return m_BoneWeightArray; }
+
+    int GetBoneCount() const { return m_BoneCount; }
+    int GetBoundBoneCount() const { return m_BoundBoneCount; }
+    const ResSkeletalAnim* GetRes() const { return m_Res; }
+    bool IsInitialized() const { return m_Res != nullptr; }
+
+private:
+    static const int EulerElementCount = 3;
+
+    float* GetTarget(uint32_t targetOffset, int boneIndex);
+    void UpdateRotate(int boneIndex);
+
+    const ResSkeletalAnim* m_Res;
+    float* m_ResultArray[SkeletonEvaluator::LocalElement_Count];
+    float* m_EulerArray[EulerElementCount];
+    float* m_BoneWeightArray;
+    uint16_t* m_TargetBoneArray;
+    uint16_t* m_CursorArray;
+    float m_Frame;
+    int m_BoneCount;
+    int m_BoundBoneCount;
+    bool m_IsEuler;
+};
+
+}  // namespace nn::g3d
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <nn/gfx/gfx_Common.h>
+#include <nn/gfx/gfx_GpuAddress.h>
+#include <nn/nn_BitTypes.h>
+#include <nn/os/os_ThreadCommon.h>
+#include <nn/util.h>
+#include "nn/util/MathTypes.h"
+
+#include <atomic>
+
+namespace nn::g3d {
+
+class SkeletonEvaluator;
+class SkinningPaletteBuilder;
+
+class SkeletonEvaluationSchedulerInfo {
+public:
+    SkeletonEvaluationSchedulerInfo() {}
+
+    void SetDefault() {
+        SetWorkerCount(3);
+        SetMaxSkeletonCount(256);
+        SetBufferingCount(2);
+        SetPaletteSectionSize(512 * 1024);
+        SetThreadStackSize(16 * 1024);
+        SetThreadPriority(nn::os::DefaultThreadPriority);
+        SetWorkerCoreMask(0);
+    }
+
+    void SetWorkerCount(int value) { m_WorkerCount = value; }
+    void SetMaxSkeletonCount(int value) { m_MaxSkeletonCount = value; }
+    void SetBufferingCount(int value) { m_BufferingCount = value; }
+    void SetPaletteSectionSize(size_t value) { m_PaletteSectionSize = value; }
+    void SetThreadStackSize(size_t value) { m_ThreadStackSize = value; }
+    void SetThreadPriority(int value) { m_ThreadPriority = value; }
+    // the cores the created workers are spread over in turn. with no bits set they take the
+    // default ideal core of the process
+    void SetWorkerCoreMask(nn::Bit32 value) { m_WorkerCoreMask = value; }
+
+    int GetWorkerCount() const { return m_WorkerCount; }
+    int GetMaxSkeletonCount() const { return m_MaxSkeletonCount; }
+    int GetBufferingCount() const { return m_BufferingCount; }
+    size_t GetPaletteSectionSize() const { return m_PaletteSectionSize; }
+    size_t GetThreadStackSize() const { return m_ThreadStackSize; }
+    int GetThreadPriority() const { return m_ThreadPriority; }
+    nn::Bit32 GetWorkerCoreMask() const { return m_WorkerCoreMask; }
+
+private:
+    int m_WorkerCount;
+    int m_MaxSkeletonCount;
+    int m_BufferingCount;
+    size_t m_PaletteSectionSize;
+    size_t m_ThreadStackSize;
+    int m_ThreadPriority;
+    nn::Bit32 m_WorkerCoreMask;
+};
+
+// evaluates the skeletons of a frame on several cores. Add reserves the skinning palette of a
+// skeleton in the section of the constant buffer ring that belongs to this frame, Start splits
+// the skeletons into contiguous runs of about the same bone count and wakes the workers, and Wait
+// joins them, after which every palette is flushed and can be bound while recording draws.
+// the calling thread is worker 0 and runs its share inside Wait, the others are created on the
+// cores of WorkerCoreMask.
+// a section is written again BufferingCount frames later, the GPU must be done with it by then.
+class SkeletonEvaluationScheduler {
+    NN_NO_COPY(SkeletonEvaluationScheduler);
+
+public:
+    typedef SkeletonEvaluationSchedulerInfo InfoType;
+    typedef gfx::detail::BufferImpl<gfx::ApiVariationNvn8> BufferType;
+
+    static const size_t PaletteAlignment = 256;
+
+    static size_t CalculateMemorySize(const InfoType& info);
+    static size_t GetMemoryAlignment();
+
+    // BufferingCount sections of PaletteSectionSize bytes
+    static size_t CalculatePaletteBufferSize(const InfoType& info);
+
+    SkeletonEvaluationScheduler();
+    ~SkeletonEvaluationScheduler();
+
+    // pBuffer stays mapped until Finalize. fails when a worker thread cannot be created
+    bool Initialize(const InfoType& info, BufferType* pBuffer, ptrdiff_t bufferOffset,
+                    void* pMemory, size_t memorySize);
+    void Finalize();
+
+    // moves to the next section and forgets the skeletons of the previous frame
+    void BeginFrame();
+
+    // the skeleton is evaluated against baseMtx by the next Start and its palette is written by
+    // pPaletteBuilder, which must be built from the resource of the skeleton. fails when the
+    // section or the skeleton list is full
+    bool Add(SkeletonEvaluator* pSkeleton, const SkinningPaletteBuilder* pPaletteBuilder,
+             const nn::util::FloatColumnMajor4x3& baseMtx, gfx::GpuAddress* pOutPaletteAddress);
+
+    void Start();
+    void Wait();
+
+    int GetSkeletonCount() const { return m_EntryCount; }
+    int GetWorkerCount() const { return m_WorkerCount; }
+    size_t GetUsedPaletteSize() const { return m_UsedSize; }
+
+    // bones given to a worker by the last Start
+    int GetWorkerBoneCount(int workerIndex) const;
+
+    bool IsInitialized() const { return m_pEntries != nullptr; }
+
+private:
+    struct Entry;
+    struct Worker;
+
+    static void WorkerThreadFunc(void* pArg);
+
+    void Execute(int workerIndex);
+    ptrdiff_t GetSectionOffset() const;
+
+    BufferType* m_pBuffer;
+    void* m_pMappedBuffer;
+    ptrdiff_t m_BufferOffset;
+    size_t m_SectionSize;
+    Entry* m_pEntries;
+    Worker* m_pWorkers;
+    int m_WorkerCount;
+    int m_MaxEntryCount;
+    int m_EntryCount;
+    int m_BufferingCount;
+    int m_SectionIndex;
+    size_t m_UsedSize;
+    std::atomic<bool> m_IsExitRequested;
+};
+
+}  // namespace nn::g3d
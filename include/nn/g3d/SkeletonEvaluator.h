@@ -0,0 +1,114 @@
+#pragma once
+
+#include "nn/g3d/ResSkeleton.h"
+#include "nn/g3d/World.h"
+
+namespace nn::g3d {
+
+// evaluates the bones of a ResSkeleton. local transforms are kept as structure-of-arrays, one
+// float array per element padded to SimdWidth bones, so animation can write them in bulk and the
+// local matrices are built SimdWidth bones per step. world matrices are then concatenated level
+// by level down the hierarchy, every bone of a batch having its parent in an earlier level.
+// world matrices follow the column vector convention, the translation being m[row][3].
+// this is standalone from SkeletonObj, whose objects are built by the SDK inside ModelObj.
+class SkeletonEvaluator {
+public:
+    class InitializeArgument {
+    public:
+        explicit InitializeArgument(const ResSkeleton* pRes) : m_Res(pRes) {}
+
+        const ResSkeleton* GetResource() const { return m_Res; }
+
+    private:
+        const ResSkeleton* m_Res;
+    };
+
+    enum LocalElement {
+        LocalElement_ScaleX,
+        LocalElement_ScaleY,
+        LocalElement_ScaleZ,
+        LocalElement_RotateX,
+        LocalElement_RotateY,
+        LocalElement_RotateZ,
+        LocalElement_RotateW,
+        LocalElement_TranslateX,
+        LocalElement_TranslateY,
+        LocalElement_TranslateZ,
+        LocalElement_Count
+    };
+
+    static constexpr int SimdWidth = 4;
+
+    static size_t CalculateBufferSize(const InitializeArgument& arg);
+    static size_t GetBufferAlignment();
+
+    SkeletonEvaluator();
+
+    bool Initialize(const InitializeArgument& arg, void* buffer, size_t bufferSize);
+
+    // reloads the bind pose of the resource, euler rotations are converted to quaternions
+    void ClearLocal();
+
+    void SetLocalScale(int boneIndex, const nn::util::Float3& scale);
+    void SetLocalRotate(int boneIndex, const nn::util::Float4& quat);
+    void SetLocalTranslate(int boneIndex, const nn::util::Float3& translate);
+
+    // writers of GetLocalArray must call this before CalculateWorld so the transform flags match
+    // the new values
+    void UpdateLocalFlags();
+
+    // bones whose entry is false are collapsed: they are left out of the batches and take the
+    // world matrix of their parent, as do the bones under them. nullptr calculates every bone
+    void SetActiveBones(const bool* pActiveArray);
+
+    float* GetLocalArray(LocalElement element) { return m_LocalArray[element]; }
+    const float* GetLocalArray(LocalElement element) const { return m_LocalArray[element]; }
+
+    // bones whose whole hierarchy is identity get baseMtx without any math. the callback runs
+    // once per bone after its world matrix is known and before its children are calculated; the
+    // bone loses its Flag_Hi* bits since the callback may have moved it
+    void CalculateWorld(const nn::util::FloatColumnMajor4x3& baseMtx,
+                        ICalculateWorldCallback* pCallback = nullptr);
+
+    const nn::util::FloatColumnMajor4x3& GetWorldMtx(int boneIndex) const {
+        return m_WorldMtxArray[boneIndex];
+    }
+    const nn::util::FloatColumnMajor4x3* GetWorldMtxArray() const { return m_WorldMtxArray; }
+
+    // for writers that pose the skeleton without CalculateWorld, such as AnimLodController
+    nn::util::FloatColumnMajor4x3* GetWorldMtxArray() { return m_WorldMtxArray; }
+
+    // the ResBone transform flags of the current pose, with the Flag_Hi* bits of the last
+    // CalculateWorld
+    nn::Bit32 GetBoneFlag(int boneIndex) const { return m_BoneFlagArray[boneIndex]; }
+
+    int GetBoneCount() const { return m_BoneCount; }
+    int GetActiveBoneCount() const { return m_ActiveBoneCount; }
+    int GetLevelCount() const { return m_LevelCount; }
+    const ResSkeleton* GetRes() const { return m_Res; }
+    bool IsInitialized() const { return m_Res != nullptr; }
+
+private:
+    static const int LocalMtxElementCount = 12;
+
+    void CalculateLocalMtx();
+    void UpdateLocalFlag(int boneIndex);
+    void InvokeCallback(ICalculateWorldCallback* pCallback, int boneIndex);
+
+    const ResSkeleton* m_Res;
+    nn::util::FloatColumnMajor4x3* m_WorldMtxArray;
+    float* m_LocalArray[LocalElement_Count];
+    float* m_LocalMtxArray[LocalMtxElementCount];
+    nn::Bit32* m_BoneFlagArray;
+    uint16_t* m_ParentIndexArray;
+    uint16_t* m_BoneOrder;
+    uint16_t* m_LevelOffsetArray;
+    uint16_t* m_ActiveOrder;
+    uint16_t* m_ActiveLevelOffsetArray;
+    int m_BoneCount;
+    int m_LevelCount;
+    int m_ActiveBoneCount;
+    int m_ActiveLevelCount;
+};
+
+}  // namespace nn::g3d
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <nn/gfx/gfx_Common.h>
+#include <nn/util.h>
+#include "nn/util/MathTypes.h"
+
+namespace nn::g3d {
+
+class ResSkeleton;
+class SkeletonEvaluator;
+
+// builds the skinning palette of a skeleton, GetMtxCount() matrices laid out as the shaders
+// read them: the smooth matrices are the world matrix of their bone times the inverse bind
+// matrix, the rigid ones are the world matrix as is. the palette slots come from the
+// smoothMtxIndex and rigidMtxIndex of every ResBone.
+// the inverse bind matrices are kept as structure-of-arrays so SkeletonEvaluator::SimdWidth
+// smooth matrices are multiplied per step, and every finished matrix is written once, in order,
+// to the destination, which is meant to be mapped GPU memory. the builder only depends on the
+// ResSkeleton and can be shared by every SkeletonEvaluator of that resource.
+class SkinningPaletteBuilder {
+    NN_NO_COPY(SkinningPaletteBuilder);
+
+public:
+    typedef gfx::detail::BufferImpl<gfx::ApiVariationNvn8> BufferType;
+
+    static size_t CalculateBufferSize(const ResSkeleton* pRes);
+    static size_t GetBufferAlignment();
+
+    SkinningPaletteBuilder();
+
+    bool Initialize(const ResSkeleton* pRes, void* buffer, size_t bufferSize);
+
+    // returns the bytes written to pOutMtxArray, the caller flushes them
+    size_t Build(nn::util::FloatColumnMajor4x3* pOutMtxArray,
+                 const SkeletonEvaluator& skeleton) const;
+
+    // writes the palette at offset of pBuffer, which pMappedBuffer maps, and flushes exactly the
+    // bytes written
+    size_t Build(BufferType* pBuffer, void* pMappedBuffer, ptrdiff_t offset,
+                 const SkeletonEvaluator& skeleton) const;
+
+    size_t GetPaletteSize() const {
+        return sizeof(nn::util::FloatColumnMajor4x3) * (m_SmoothMtxCount + m_RigidMtxCount);
+    }
+
+    int GetSmoothMtxCount() const { return m_SmoothMtxCount; }
+    int GetRigidMtxCount() const { return m_RigidMtxCount; }
+    const ResSkeleton* GetRes() const { return m_Res; }
+    bool IsInitialized() const { return m_Res != nullptr; }
+
+private:
+    static const int MtxElementCount = 12;
+
+    const ResSkeleton* m_Res;
+    float* m_InvModelMtxArray[MtxElementCount];
+    uint16_t* m_SmoothBoneIndexArray;
+    uint16_t* m_RigidBoneIndexArray;
+    int m_SmoothMtxCount;
+    int m_RigidMtxCount;
+};
+
+}  // namespace nn::g3d
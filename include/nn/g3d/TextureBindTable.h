@@ -0,0 +1,77 @@
+#pragma once
+
+#include <nn/gfx/util/gfx_ObjectCache.h>
+#include <nn/types.h>
+
+namespace nn::gfx {
+class ResTexture;
+struct ResTextureContainerData;
+}  // namespace nn::gfx
+
+namespace nn::g3d {
+
+typedef void* TextureRef;
+
+// resolves the texture names handed to the BindTexture callbacks through a prebuilt table instead
+// of a string keyed lookup per reference. names are hashed once when registered and matched by
+// hash first. the names of a resource file are pooled in its string table, so every reference
+// to a texture carries the same pointer; the table remembers what each pointer resolved to and
+// later references cost one pointer hash, without hashing or comparing the string again.
+//
+//     pResFile->BindTexture(TextureBindTable::BindCallback, &table);
+class TextureBindTable {
+public:
+    typedef TextureRef (*MakeTextureRefCallback)(const nn::gfx::ResTexture* pResTexture,
+                                                 void* pUserData);
+
+    static size_t CalculateBufferSize(int maxTextureCount);
+    static size_t GetBufferAlignment();
+
+    // the callback of BindTexture, pUserData being the TextureBindTable
+    static TextureRef BindCallback(const char* name, void* pUserData);
+
+    TextureBindTable();
+
+    bool Initialize(int maxTextureCount, void* buffer, size_t bufferSize);
+
+    // name must outlive the table. a name registered again takes the new reference. returns
+    // false when the table is full
+    bool Register(const char* name, TextureRef textureRef);
+
+    // registers every texture of the container under its name in pTextureDic, pMakeTextureRef
+    // building the reference of each. returns the number of textures registered
+    int Register(const nn::gfx::ResTextureContainerData* pContainer,
+                 MakeTextureRefCallback pMakeTextureRef, void* pUserData);
+
+    // a null TextureRef when the name is not registered. the result is remembered by the address
+    // of name, which must keep its contents until ClearCache. up to the texture count of pointers
+    // are remembered, later ones are looked up by name every time
+    TextureRef Find(const char* name);
+
+    // forgets the resolved pointers, to be called when the bound resource files are unloaded
+    void ClearCache();
+
+    int GetTextureCount() const { return m_TextureCount; }
+
+    // the references Find could not resolve since the last ClearCache
+    int GetUnresolvedCount() const { return m_UnresolvedCount; }
+    bool IsInitialized() const { return m_EntryArray != nullptr; }
+
+private:
+    struct Entry;
+    struct CacheEntry;
+
+    int FindEntry(const char* name, size_t length, uint32_t hash) const;
+    void ClearCacheSlots();
+
+    Entry* m_EntryArray;
+    CacheEntry* m_CacheArray;
+    nn::gfx::util::detail::ObjectCacheIndex m_EntryIndex;
+    nn::gfx::util::detail::ObjectCacheIndex m_CacheIndex;
+    int m_MaxTextureCount;
+    int m_TextureCount;
+    int m_CacheCount;
+    int m_UnresolvedCount;
+};
+
+}  // namespace nn::g3d
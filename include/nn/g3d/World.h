@@ -1,16 +1,41 @@
 #pragma once
 
+#include <nn/nn_BitTypes.h>
+#include "nn/util/MathTypes.h"
+
 namespace nn::g3d {
 
-class WorldMtxManip;
+// gives a world callback access to the matrix and flags of the bone being calculated
+class WorldMtxManip {
+public:
+    WorldMtxManip(nn::util::FloatColumnMajor4x3* pMtx, nn::Bit32* pFlag)
+        : m_pMtx(pMtx), m_pFlag(pFlag) {}
+
+    nn::util::FloatColumnMajor4x3* GetMtx() { return m_pMtx; }
+    const nn::util::FloatColumnMajor4x3* GetMtx() const { return m_pMtx; }
+    nn::Bit32 GetFlag() const { return *m_pFlag; }
+
+private:
+    nn::util::FloatColumnMajor4x3* m_pMtx;
+    nn::Bit32* m_pFlag;
+};
 
 class ICalculateWorldCallback {
 public:
-    // TODO
-    struct CallbackArg;
+    class CallbackArg {
+    public:
+        explicit CallbackArg(int boneIndex) : m_BoneIndex(boneIndex) {}
+
+        int GetBoneIndex() const { return m_BoneIndex; }
+
+    private:
+        int m_BoneIndex;
+    };
 
     virtual ~ICalculateWorldCallback() = 0;
     virtual void Exec(CallbackArg& arg, WorldMtxManip& manip) = 0;
 };
 
+inline ICalculateWorldCallback::~ICalculateWorldCallback() {}
+
 }  // namespace nn::g3d
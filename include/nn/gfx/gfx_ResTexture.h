@@ -60,6 +60,7 @@ public:
 
     ResTexture* GetResTexture(int);
     const ResTexture* GetResTexture(int) const;
+    int GetTextureCount() const { return textureContainerData.textureCount; }
     const nn::util::ResDic* GetTextureDic() const;
     nn::util::BinaryFileHeader* GetBinaryFileHeader();
     const nn::util::BinaryFileHeader* GetBinaryFileHeader() const;
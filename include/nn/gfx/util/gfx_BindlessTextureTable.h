@@ -0,0 +1,93 @@
+#pragma once
+
+#include <nn/gfx/gfx_Common.h>
+#include <nn/util.h>
+
+namespace nn::gfx {
+
+class DescriptorSlot;
+
+}  // namespace nn::gfx
+
+namespace nn::gfx::util {
+
+class BindlessTextureTableInfo {
+public:
+    BindlessTextureTableInfo() {}
+
+    void SetDefault() {
+        SetMaxMaterialCount(256);
+        SetHandleCountPerMaterial(8);
+    }
+
+    void SetMaxMaterialCount(int value) { m_MaxMaterialCount = value; }
+    void SetHandleCountPerMaterial(int value) { m_HandleCountPerMaterial = value; }
+
+    int GetMaxMaterialCount() const { return m_MaxMaterialCount; }
+    int GetHandleCountPerMaterial() const { return m_HandleCountPerMaterial; }
+
+private:
+    int m_MaxMaterialCount;
+    int m_HandleCountPerMaterial;
+};
+
+// texture, texel fetch and image handles resolved once per material slot instead of on every
+// SetTextureAndSampler. the table buffer starts with a small uniform block holding the current
+// material index, followed by the handles of every material:
+//   layout(std140) uniform Material { int materialIndex; int handleCount; };
+//   layout(std430) buffer Handles { uvec2 handles[]; };  // materialIndex * handleCount + slot
+// Bind attaches both once per pass, after that SetMaterial is a single inline uniform update.
+class BindlessTextureTable {
+    NN_NO_COPY(BindlessTextureTable);
+
+public:
+    typedef BindlessTextureTableInfo InfoType;
+    typedef gfx::detail::DeviceImpl<ApiVariationNvn8> DeviceType;
+    typedef gfx::detail::CommandBufferImpl<ApiVariationNvn8> CommandBufferType;
+    typedef gfx::detail::BufferImpl<ApiVariationNvn8> BufferType;
+
+    static const size_t MaterialUniformBlockSize = 256;
+
+    static size_t CalculateTableBufferSize(const InfoType& info);
+    static size_t GetTableBufferAlignment();
+
+    BindlessTextureTable();
+    ~BindlessTextureTable();
+
+    void Initialize(DeviceType* pDevice, const InfoType& info, BufferType* pTableBuffer,
+                    ptrdiff_t tableBufferOffset);
+    void Finalize();
+
+    bool SetTextureAndSampler(int materialIndex, int slot, const DescriptorSlot& textureDescriptor,
+                              const DescriptorSlot& samplerDescriptor);
+    bool SetTexture(int materialIndex, int slot, const DescriptorSlot& textureDescriptor);
+    bool SetImage(int materialIndex, int slot, const DescriptorSlot& imageDescriptor);
+    void ClearMaterial(int materialIndex);
+
+    // makes handle writes since the last flush visible to the GPU
+    void Flush();
+
+    void Bind(CommandBufferType* pCommandBuffer, ShaderStage stage, int uniformBufferSlot,
+              int storageBufferSlot) const;
+    void SetMaterial(CommandBufferType* pCommandBuffer, int materialIndex) const;
+
+    ptrdiff_t GetHandleOffset(int materialIndex, int slot) const;
+    int GetMaxMaterialCount() const { return m_MaxMaterialCount; }
+    int GetHandleCountPerMaterial() const { return m_HandleCountPerMaterial; }
+
+    bool IsInitialized() const { return m_pTableBuffer != nullptr; }
+
+private:
+    bool WriteHandle(int materialIndex, int slot, uint64_t handle);
+
+    DeviceType* m_pDevice;
+    BufferType* m_pTableBuffer;
+    ptrdiff_t m_TableBufferOffset;
+    uint64_t* m_pHandles;
+    int m_MaxMaterialCount;
+    int m_HandleCountPerMaterial;
+    int m_DirtyBegin;
+    int m_DirtyEnd;
+};
+
+}  // namespace nn::gfx::util
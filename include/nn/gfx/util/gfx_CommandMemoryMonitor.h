@@ -0,0 +1,113 @@
+#pragma once
+
+#include <nn/gfx/gfx_Common.h>
+#include <nn/util.h>
+
+namespace nn::gfx::util {
+
+struct CommandBufferMemoryUsage {
+    size_t commandMemoryUsed;
+    size_t controlMemoryUsed;
+    size_t peakCommandMemoryUsed;
+    size_t peakControlMemoryUsed;
+    size_t commandMemorySize;
+    size_t controlMemorySize;
+    int recordingCount;
+    int outOfCommandMemoryCount;
+    int outOfControlMemoryCount;
+};
+
+struct QueueMemoryUsage {
+    size_t commandMemoryUsed;
+    size_t controlMemoryUsed;
+    size_t computeMemoryUsed;
+    size_t peakCommandMemoryUsed;
+    size_t peakControlMemoryUsed;
+    size_t peakComputeMemoryUsed;
+    int sampleCount;
+};
+
+class CommandMemoryMonitorInfo {
+public:
+    CommandMemoryMonitorInfo() {}
+
+    void SetDefault() {
+        SetMaxCommandBufferCount(16);
+        SetMaxQueueCount(4);
+    }
+
+    void SetMaxCommandBufferCount(int value) { m_MaxCommandBufferCount = value; }
+    void SetMaxQueueCount(int value) { m_MaxQueueCount = value; }
+
+    int GetMaxCommandBufferCount() const { return m_MaxCommandBufferCount; }
+    int GetMaxQueueCount() const { return m_MaxQueueCount; }
+
+private:
+    int m_MaxCommandBufferCount;
+    int m_MaxQueueCount;
+};
+
+// measures how much command and control memory each registered command buffer consumes per
+// recording, and how much each registered queue consumes between samples.
+// memory used by chunks that ran out is only seen if NotifyOutOf*Memory is called from the
+// out of memory callback before the new chunk is added.
+class CommandMemoryMonitor {
+    NN_NO_COPY(CommandMemoryMonitor);
+
+public:
+    typedef CommandMemoryMonitorInfo InfoType;
+    typedef gfx::detail::CommandBufferImpl<ApiVariationNvn8> CommandBufferType;
+    typedef gfx::detail::QueueImpl<ApiVariationNvn8> QueueType;
+
+    static const int InvalidIndex = -1;
+
+    static size_t CalculateMemorySize(const InfoType& info);
+    static size_t GetMemoryAlignment();
+
+    static size_t CalculateRecommendedSize(size_t peakUsed, float headroomRatio, size_t alignment);
+
+    CommandMemoryMonitor();
+    ~CommandMemoryMonitor();
+
+    void Initialize(const InfoType& info, void* pMemory, size_t memorySize);
+    void Finalize();
+
+    int RegisterCommandBuffer(const CommandBufferType* pCommandBuffer, const char* pName);
+    int RegisterQueue(const QueueType* pQueue, const char* pName);
+
+    void BeginRecording(const CommandBufferType* pCommandBuffer);
+    void EndRecording(const CommandBufferType* pCommandBuffer);
+    void NotifyOutOfCommandMemory(const CommandBufferType* pCommandBuffer);
+    void NotifyOutOfControlMemory(const CommandBufferType* pCommandBuffer);
+
+    void SampleQueue(QueueType* pQueue);
+
+    void ResetPeaks();
+
+    int GetCommandBufferCount() const { return m_CommandBufferCount; }
+    int FindCommandBufferIndex(const CommandBufferType* pCommandBuffer) const;
+    const char* GetCommandBufferName(int index) const;
+    const CommandBufferMemoryUsage& GetCommandBufferUsage(int index) const;
+    size_t GetRecommendedCommandMemorySize(int index, float headroomRatio, size_t alignment) const;
+    size_t GetRecommendedControlMemorySize(int index, float headroomRatio, size_t alignment) const;
+
+    int GetQueueCount() const { return m_QueueCount; }
+    int FindQueueIndex(const QueueType* pQueue) const;
+    const char* GetQueueName(int index) const;
+    const QueueMemoryUsage& GetQueueUsage(int index) const;
+
+    bool IsInitialized() const { return m_pCommandBuffers != nullptr; }
+
+private:
+    struct CommandBufferEntry;
+    struct QueueEntry;
+
+    CommandBufferEntry* m_pCommandBuffers;
+    QueueEntry* m_pQueues;
+    int m_MaxCommandBufferCount;
+    int m_MaxQueueCount;
+    int m_CommandBufferCount;
+    int m_QueueCount;
+};
+
+}  // namespace nn::gfx::util
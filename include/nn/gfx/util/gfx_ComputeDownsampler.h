@@ -0,0 +1,119 @@
+#pragma once
+
+#include <nn/gfx/gfx_Common.h>
+#include <nn/util.h>
+
+namespace nn::gfx {
+
+class DescriptorSlot;
+class ResShaderFile;
+
+}  // namespace nn::gfx
+
+namespace nn::gfx::util {
+
+enum DownsampleReduction {
+    DownsampleReduction_Average,
+    DownsampleReduction_Min,
+    DownsampleReduction_Max,
+};
+
+class ComputeDownsamplerInfo {
+public:
+    ComputeDownsamplerInfo() {}
+
+    void SetDefault() {
+        SetMaxSliceCount(6);
+        SetConstantBufferSlot(0);
+        SetCounterBufferSlot(0);
+        SetSourceTextureSlot(0);
+        SetFirstImageSlot(0);
+    }
+
+    void SetMaxSliceCount(int value) { m_MaxSliceCount = value; }
+    void SetConstantBufferSlot(int value) { m_ConstantBufferSlot = value; }
+    void SetCounterBufferSlot(int value) { m_CounterBufferSlot = value; }
+    void SetSourceTextureSlot(int value) { m_SourceTextureSlot = value; }
+    void SetFirstImageSlot(int value) { m_FirstImageSlot = value; }
+
+    int GetMaxSliceCount() const { return m_MaxSliceCount; }
+    int GetConstantBufferSlot() const { return m_ConstantBufferSlot; }
+    int GetCounterBufferSlot() const { return m_CounterBufferSlot; }
+    int GetSourceTextureSlot() const { return m_SourceTextureSlot; }
+    int GetFirstImageSlot() const { return m_FirstImageSlot; }
+
+private:
+    int m_MaxSliceCount;
+    int m_ConstantBufferSlot;
+    int m_CounterBufferSlot;
+    int m_SourceTextureSlot;
+    int m_FirstImageSlot;
+};
+
+// dispatch wrapper for a single pass downsampling compute shader, which reduces a source level
+// into up to MaxMipCount smaller levels with one Dispatch instead of one BlitImage per level.
+// this class only binds the resources and records the Dispatch; the reduction is done by the
+// shader, which is not part of this library and is loaded by the caller from a ResShaderFile.
+// the intended shader has every work group reduce a TileSize square of the source to six levels
+// in shared memory, the last group of a slice to finish (found through an atomic counter) then
+// reducing the remaining tile sized image to the levels below. it has to follow this interface:
+//   layout(local_size_x = 256) in;
+//   layout(std140) uniform Downsample { ivec4 sizeAndMode; ivec4 workGroupCount; };
+//   layout(std430) coherent buffer Counter { uint counters[]; };  // one per slice, left at 0
+//   uniform sampler2DArray source;
+//   layout(...) uniform coherent image2DArray levels[MaxMipCount];
+// sizeAndMode holds the source width and height, the level count and the DownsampleReduction.
+// the written levels follow the usual rules for image stores, FlushMemory(GpuAccess_Image) and
+// InvalidateMemory(GpuAccess_Texture) order them with later reads and with the next Downsample.
+class ComputeDownsampler {
+    NN_NO_COPY(ComputeDownsampler);
+
+public:
+    typedef ComputeDownsamplerInfo InfoType;
+    typedef gfx::detail::CommandBufferImpl<ApiVariationNvn8> CommandBufferType;
+    typedef gfx::detail::BufferImpl<ApiVariationNvn8> BufferType;
+    typedef gfx::detail::ShaderImpl<ApiVariationNvn8> ShaderType;
+
+    static const int MaxMipCount = 12;
+    static const int MaxSourceSize = 4096;
+    static const int TileSize = 64;
+    static const size_t ConstantBlockSize = 256;
+
+    static size_t CalculateWorkBufferSize(const InfoType& info);
+    static size_t GetWorkBufferAlignment();
+
+    // the binary program of a variation, the container has to be initialized already
+    static const ShaderType* GetShader(const ResShaderFile* pResShaderFile, int variationIndex);
+
+    ComputeDownsampler();
+    ~ComputeDownsampler();
+
+    // clears the counters through the mapped work buffer
+    void Initialize(const InfoType& info, const ShaderType* pShader, BufferType* pWorkBuffer,
+                    ptrdiff_t workBufferOffset);
+    void Finalize();
+
+    // pDstImages are image descriptors of the levels below the source, largest first. fails when
+    // the source is larger than MaxSourceSize or has fewer than dstMipCount levels below it
+    bool Downsample(CommandBufferType* pCommandBuffer, const DescriptorSlot& sourceTexture,
+                    const DescriptorSlot& sourceSampler, const DescriptorSlot* pDstImages,
+                    int dstMipCount, int width, int height, int sliceCount,
+                    DownsampleReduction reduction) const;
+
+    static int CalculateWorkGroupCount(int size) { return (size + TileSize - 1) / TileSize; }
+    int GetMaxSliceCount() const { return m_MaxSliceCount; }
+
+    bool IsInitialized() const { return m_pShader != nullptr; }
+
+private:
+    const ShaderType* m_pShader;
+    BufferType* m_pWorkBuffer;
+    ptrdiff_t m_WorkBufferOffset;
+    int m_MaxSliceCount;
+    int m_ConstantBufferSlot;
+    int m_CounterBufferSlot;
+    int m_SourceTextureSlot;
+    int m_FirstImageSlot;
+};
+
+}  // namespace nn::gfx::util
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <nn/gfx/gfx_Common.h>
+#include <nn/gfx/util/gfx_ObjectCache.h>
+#include <nn/gfx/util/gfx_QueryBufferRing.h>
+#include <nn/util.h>
+
+namespace nn::gfx::util {
+
+class GpuProfilerInfo {
+public:
+    GpuProfilerInfo() {}
+
+    void SetDefault() {
+        SetMaxScopeCount(256);
+        SetMaxScopeStatisticsCount(128);
+        SetBufferedFrameCount(3);
+    }
+
+    void SetMaxScopeCount(int value) { m_MaxScopeCount = value; }
+    void SetMaxScopeStatisticsCount(int value) { m_MaxScopeStatisticsCount = value; }
+    void SetBufferedFrameCount(int value) { m_BufferedFrameCount = value; }
+
+    int GetMaxScopeCount() const { return m_MaxScopeCount; }
+    int GetMaxScopeStatisticsCount() const { return m_MaxScopeStatisticsCount; }
+    int GetBufferedFrameCount() const { return m_BufferedFrameCount; }
+
+private:
+    int m_MaxScopeCount;
+    int m_MaxScopeStatisticsCount;
+    int m_BufferedFrameCount;
+};
+
+// hierarchical GPU timing built on CommandBufferImpl::WriteTimestamp.
+// every frame owns a slice of the query buffer; a slice is read back only once the GPU has
+// written its last report, so resolving never waits on the GPU. a frame whose slice the GPU has
+// not finished with yet is not profiled and counts as dropped.
+class GpuProfiler {
+    NN_NO_COPY(GpuProfiler);
+
+public:
+    typedef GpuProfilerInfo InfoType;
+    typedef gfx::detail::CommandBufferImpl<ApiVariationNvn8> CommandBufferType;
+    typedef gfx::detail::BufferImpl<ApiVariationNvn8> BufferType;
+
+    static const int MaxScopeDepth = 16;
+    static const int InvalidScopeStatisticsIndex = -1;
+
+    struct ScopeStatistics {
+        const char* pName;
+        int parentIndex;
+        int depth;
+        int sampleCount;
+        int64_t lastTime;
+        int64_t minTime;
+        int64_t maxTime;
+        int64_t totalTime;
+
+        int64_t GetAverageTime() const { return sampleCount > 0 ? totalTime / sampleCount : 0; }
+    };
+
+    static size_t CalculateQueryBufferSize(const InfoType& info);
+    static size_t GetQueryBufferAlignment();
+    static size_t CalculateMemorySize(const InfoType& info);
+    static size_t GetMemoryAlignment();
+
+    GpuProfiler();
+    ~GpuProfiler();
+
+    void Initialize(const InfoType& info, BufferType* pQueryBuffer, ptrdiff_t queryBufferOffset,
+                    void* pMemory, size_t memorySize);
+    void Finalize();
+
+    void BeginFrame(CommandBufferType* pCommandBuffer);
+    void EndFrame(CommandBufferType* pCommandBuffer);
+    void BeginScope(CommandBufferType* pCommandBuffer, const char* pName);
+    void EndScope(CommandBufferType* pCommandBuffer);
+
+    void Resolve();
+    void ResetStatistics();
+
+    int GetScopeStatisticsCount() const { return m_ScopeStatisticsCount; }
+    const ScopeStatistics& GetScopeStatistics(int index) const {
+        return m_pScopeStatistics[index];
+    }
+    int FindScopeStatisticsIndex(const char* pName, int parentIndex) const;
+
+    int GetResolvedFrameCount() const { return m_ResolvedFrameCount; }
+    int GetDroppedFrameCount() const { return m_DroppedFrameCount; }
+
+    size_t WriteChromeTrace(char* pBuffer, size_t bufferSize) const;
+
+    bool IsInitialized() const { return m_pFrames != nullptr; }
+
+private:
+    struct ScopeRecord;
+    struct FrameRecord;
+
+    int AcquireScopeStatistics(const char* pName, int parentIndex, int depth);
+    bool TryResolveFrame(int frameIndex);
+    void WriteQuery(CommandBufferType* pCommandBuffer, int reportIndex);
+
+    detail::QueryBufferRing m_QueryRing;
+    FrameRecord* m_pFrames;
+    ScopeRecord* m_pScopes;
+    ScopeStatistics* m_pScopeStatistics;
+    detail::ObjectCacheIndex m_ScopeStatisticsIndex;
+    int m_MaxScopeCount;
+    int m_MaxScopeStatisticsCount;
+    int m_ScopeStatisticsCount;
+    int m_BufferedFrameCount;
+    int m_CurrentFrameIndex;
+    int m_ScopeStack[MaxScopeDepth];
+    int m_ScopeDepth;
+    int m_ResolvedFrameCount;
+    int m_DroppedFrameCount;
+};
+
+class ScopedGpuProfile {
+    NN_NO_COPY(ScopedGpuProfile);
+
+public:
+    ScopedGpuProfile(GpuProfiler* pProfiler, GpuProfiler::CommandBufferType* pCommandBuffer,
+                     const char* pName)
+        : m_pProfiler(pProfiler), m_pCommandBuffer(pCommandBuffer) {
+        m_pProfiler->BeginScope(m_pCommandBuffer, pName);
+    }
+
+    ~ScopedGpuProfile() { m_pProfiler->EndScope(m_pCommandBuffer); }
+
+private:
+    GpuProfiler* m_pProfiler;
+    GpuProfiler::CommandBufferType* m_pCommandBuffer;
+};
+
+}  // namespace nn::gfx::util
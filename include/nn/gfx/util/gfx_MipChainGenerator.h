@@ -0,0 +1,125 @@
+#pragma once
+
+#include <nn/gfx/gfx_Common.h>
+#include <nn/gfx/gfx_Enum.h>
+#include <nn/util.h>
+
+#include <algorithm>
+
+namespace nn::gfx {
+
+class TextureInfo;
+
+}  // namespace nn::gfx
+
+namespace nn::gfx::util {
+
+enum MipFilter {
+    MipFilter_Box,
+    MipFilter_Kaiser,
+};
+
+class MipChainGeneratorInfo {
+public:
+    MipChainGeneratorInfo() {}
+
+    void SetDefault() {
+        SetFilter(MipFilter_Box);
+        SetKaiserAlpha(4.0f);
+    }
+
+    void SetFilter(MipFilter value) { m_Filter = value; }
+    void SetKaiserAlpha(float value) { m_KaiserAlpha = value; }
+
+    MipFilter GetFilter() const { return m_Filter; }
+    float GetKaiserAlpha() const { return m_KaiserAlpha; }
+
+private:
+    MipFilter m_Filter;
+    float m_KaiserAlpha;
+};
+
+// fills mip levels 1 and up of linear texture data from level 0, laid out with the offsets from
+// TextureImpl::CalculateMipDataOffsets. every level is filtered from the previous one; unorm srgb
+// formats are filtered in linear space and alpha is never converted.
+// slices of an array or cube texture are independent, GenerateSlice may run on several threads at
+// once as long as each thread passes its own work memory. a single large slice can be split
+// further with GenerateRows: the rows of a level are independent once the level above it is
+// complete, so a level can be cut into bands that run as jobs, with a barrier between levels.
+class MipChainGenerator {
+    NN_NO_COPY(MipChainGenerator);
+
+public:
+    typedef MipChainGeneratorInfo InfoType;
+
+    static const int MaxTapCount = 6;
+
+    static bool IsSupportedFormat(ImageFormat format);
+    static size_t CalculateWorkMemorySize(const InfoType& info, const TextureInfo& textureInfo);
+    static size_t GetWorkMemoryAlignment();
+
+    MipChainGenerator();
+    ~MipChainGenerator();
+
+    // fails for compressed, integer and 3d textures
+    bool Initialize(const InfoType& info, const TextureInfo& textureInfo, void* pMipData,
+                    const ptrdiff_t* pMipOffsets);
+    void Finalize();
+
+    bool GenerateSlice(int sliceIndex, void* pWorkMemory, size_t workMemorySize) const;
+    void GenerateAll(void* pWorkMemory, size_t workMemorySize) const;
+    // fills rows [beginRow, endRow) of a level from the previous level
+    bool GenerateRows(int sliceIndex, int mipLevel, int beginRow, int endRow, void* pWorkMemory,
+                      size_t workMemorySize) const;
+
+    int GetLevelHeight(int mipLevel) const { return std::max(m_Height >> mipLevel, 1); }
+    int GetSliceCount() const { return m_SliceCount; }
+    int GetMipCount() const { return m_MipCount; }
+    int GetTapCount() const { return m_TapCount; }
+
+    bool IsInitialized() const { return m_pMipData != nullptr; }
+
+private:
+    static const int SrgbEncodeTableSize = 4096;
+
+    enum ElementType {
+        ElementType_Unorm8,
+        ElementType_Unorm16,
+        ElementType_Float16,
+        ElementType_Float32,
+        ElementType_Unorm10_10_10_2,
+    };
+
+    struct LevelLayout;
+
+    static bool GetElementType(ElementType* pOutType, int* pOutChannelCount, ImageFormat format);
+
+    void GetLevelLayout(LevelLayout* pOutLayout, int mipLevel, int sliceIndex) const;
+    void DecodeRow(float* pDst, const void* pSrc, int width) const;
+    void EncodeRow(void* pDst, const float* pSrc, int width) const;
+    void FilterRow(float* pDst, const float* pSrc, int srcWidth, int dstWidth) const;
+    void FilterRows(const LevelLayout& src, const LevelLayout& dst, int beginRow, int endRow,
+                    void* pWorkMemory) const;
+    uint8_t EncodeSrgb(float value) const;
+
+    void* m_pMipData;
+    const ptrdiff_t* m_pMipOffsets;
+    ElementType m_ElementType;
+    ChannelFormat m_ChannelFormat;
+    int m_Width;
+    int m_Height;
+    int m_MipCount;
+    int m_SliceCount;
+    int m_ChannelCount;
+    int m_TapCount;
+    bool m_IsSrgb;
+    float m_Weights[MaxTapCount];
+    float m_SrgbToLinear[256];
+    // linear value halfway between two consecutive srgb codes, rounds in srgb space
+    float m_SrgbThresholds[255];
+    // the code of the lower bound of each of the 4096 equal steps of linear values, at most a
+    // few codes below the rounded one in the dark end
+    uint8_t m_SrgbEncodeTable[SrgbEncodeTableSize];
+};
+
+}  // namespace nn::gfx::util
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <nn/gfx/gfx_Common.h>
+#include <nn/gfx/gfx_SamplerInfoData.h>
+#include <nn/gfx/gfx_TextureInfoData.h>
+#include <nn/util.h>
+
+namespace nn::gfx {
+
+class DescriptorSlot;
+class SamplerInfo;
+class TextureViewInfo;
+
+namespace util {
+
+namespace detail {
+
+// open addressing index from a 32-bit key hash to an entry index, shared by the object caches
+class ObjectCacheIndex {
+    NN_NO_COPY(ObjectCacheIndex);
+
+public:
+    static const int InvalidIndex = -1;
+
+    static int CalculateBucketCount(int maxEntryCount);
+
+    ObjectCacheIndex();
+
+    void Initialize(int32_t* pBuckets, uint32_t* pHashes, int bucketCount);
+    void Clear();
+
+    template <typename TPredicate>
+    int Find(uint32_t hash, TPredicate isMatch) const {
+        for (int idx = hash & m_BucketMask, probe = 0; probe <= m_BucketMask;
+             idx = (idx + 1) & m_BucketMask, ++probe) {
+            int32_t entryIndex = m_pBuckets[idx];
+            if (entryIndex == Bucket_Empty) {
+                break;
+            }
+            if (entryIndex != Bucket_Removed && m_pHashes[idx] == hash && isMatch(entryIndex)) {
+                return entryIndex;
+            }
+        }
+        return InvalidIndex;
+    }
+
+    void Insert(uint32_t hash, int entryIndex);
+    void Remove(uint32_t hash, int entryIndex);
+
+private:
+    enum Bucket { Bucket_Empty = -1, Bucket_Removed = -2 };
+
+    int32_t* m_pBuckets;
+    uint32_t* m_pHashes;
+    int m_BucketMask;
+};
+
+uint32_t CalculateObjectCacheHash(const void* pData, size_t size);
+
+}  // namespace detail
+
+class SamplerCache {
+    NN_NO_COPY(SamplerCache);
+
+public:
+    typedef gfx::detail::SamplerImpl<ApiVariationNvn8> SamplerType;
+    typedef gfx::detail::DeviceImpl<ApiVariationNvn8> DeviceType;
+    typedef gfx::detail::DescriptorPoolImpl<ApiVariationNvn8> DescriptorPoolType;
+
+    static size_t CalculateMemorySize(int maxEntryCount);
+    static size_t GetMemoryAlignment();
+
+    SamplerCache();
+    ~SamplerCache();
+
+    void Initialize(DeviceType* pDevice, DescriptorPoolType* pSamplerDescriptorPool,
+                    int baseSlotIndex, int maxEntryCount, void* pMemory, size_t memorySize);
+    void Finalize();
+
+    const SamplerType* Acquire(DescriptorSlot* pOutDescriptorSlot, const SamplerInfo& info);
+    void Release(const SamplerType* pSampler);
+
+    int GetEntryCount() const { return m_EntryCount; }
+    int GetMaxEntryCount() const { return m_MaxEntryCount; }
+    bool IsInitialized() const { return m_pEntries != nullptr; }
+
+private:
+    struct Entry;
+
+    DeviceType* m_pDevice;
+    DescriptorPoolType* m_pDescriptorPool;
+    Entry* m_pEntries;
+    detail::ObjectCacheIndex m_Index;
+    int m_BaseSlotIndex;
+    int m_MaxEntryCount;
+    int m_EntryCount;
+    int m_FreeEntryIndex;
+};
+
+class TextureViewCache {
+    NN_NO_COPY(TextureViewCache);
+
+public:
+    typedef gfx::detail::TextureViewImpl<ApiVariationNvn8> TextureViewType;
+    typedef gfx::detail::DeviceImpl<ApiVariationNvn8> DeviceType;
+    typedef gfx::detail::DescriptorPoolImpl<ApiVariationNvn8> DescriptorPoolType;
+
+    static size_t CalculateMemorySize(int maxEntryCount);
+    static size_t GetMemoryAlignment();
+
+    TextureViewCache();
+    ~TextureViewCache();
+
+    void Initialize(DeviceType* pDevice, DescriptorPoolType* pTextureDescriptorPool,
+                    int baseSlotIndex, int maxEntryCount, void* pMemory, size_t memorySize);
+    void Finalize();
+
+    const TextureViewType* Acquire(DescriptorSlot* pOutDescriptorSlot,
+                                   const TextureViewInfo& info);
+    void Release(const TextureViewType* pTextureView);
+
+    int GetEntryCount() const { return m_EntryCount; }
+    int GetMaxEntryCount() const { return m_MaxEntryCount; }
+    bool IsInitialized() const { return m_pEntries != nullptr; }
+
+private:
+    struct Entry;
+
+    DeviceType* m_pDevice;
+    DescriptorPoolType* m_pDescriptorPool;
+    Entry* m_pEntries;
+    detail::ObjectCacheIndex m_Index;
+    int m_BaseSlotIndex;
+    int m_MaxEntryCount;
+    int m_EntryCount;
+    int m_FreeEntryIndex;
+};
+
+}  // namespace util
+}  // namespace nn::gfx
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <nn/gfx/gfx_Common.h>
+#include <nn/gfx/gfx_Enum.h>
+#include <nn/gfx/util/gfx_QueryBufferRing.h>
+#include <nn/util.h>
+
+namespace nn::gfx {
+
+namespace util {
+
+struct PipelineStatistics {
+    uint64_t samplesPassed;
+    uint64_t inputVertices;
+    uint64_t inputPrimitives;
+    uint64_t vertexShaderInvocations;
+    uint64_t geometryShaderInvocations;
+    uint64_t geometryShaderPrimitives;
+    uint64_t clippingInputPrimitives;
+    uint64_t clippingOutputPrimitives;
+    uint64_t pixelShaderInvocations;
+    uint64_t hullShaderInvocations;
+    uint64_t domainShaderInvocations;
+    uint64_t computeShaderInvocations;
+
+    void Clear();
+    uint64_t Get(QueryTarget target) const;
+    void Set(QueryTarget target, uint64_t value);
+
+    // pixel shader invocations per render target pixel
+    float GetOverdraw(int renderTargetPixelCount) const;
+    // fraction of pixel shader invocations whose samples were rejected afterwards
+    float GetPixelRejectRatio() const;
+    // fraction of input primitives that did not leave the clipper
+    float GetCullingEfficiency() const;
+};
+
+class PipelineStatisticsCollectorInfo {
+public:
+    PipelineStatisticsCollectorInfo() {}
+
+    void SetDefault() {
+        SetMaxPassCount(32);
+        SetBufferedFrameCount(2);
+    }
+
+    void SetMaxPassCount(int value) { m_MaxPassCount = value; }
+    void SetBufferedFrameCount(int value) { m_BufferedFrameCount = value; }
+
+    int GetMaxPassCount() const { return m_MaxPassCount; }
+    int GetBufferedFrameCount() const { return m_BufferedFrameCount; }
+
+private:
+    int m_MaxPassCount;
+    int m_BufferedFrameCount;
+};
+
+// snapshots every pipeline counter around a pass with BeginQuery/EndQuery.
+// the query buffer is sliced per buffered frame and a slice is read back only after the GPU has
+// passed its fence report, so the results lag by a frame or more but never stall. a frame whose
+// slice the GPU has not finished with yet is not measured and counts as dropped.
+class PipelineStatisticsCollector {
+    NN_NO_COPY(PipelineStatisticsCollector);
+
+public:
+    typedef PipelineStatisticsCollectorInfo InfoType;
+    typedef gfx::detail::CommandBufferImpl<ApiVariationNvn8> CommandBufferType;
+    typedef gfx::detail::BufferImpl<ApiVariationNvn8> BufferType;
+
+    static const int InvalidPassIndex = -1;
+
+    static bool IsSupported(QueryTarget target);
+
+    static size_t CalculateQueryBufferSize(const InfoType& info);
+    static size_t GetQueryBufferAlignment();
+    static size_t CalculateMemorySize(const InfoType& info);
+    static size_t GetMemoryAlignment();
+
+    PipelineStatisticsCollector();
+    ~PipelineStatisticsCollector();
+
+    void Initialize(const InfoType& info, BufferType* pQueryBuffer, ptrdiff_t queryBufferOffset,
+                    void* pMemory, size_t memorySize);
+    void Finalize();
+
+    void BeginFrame();
+    void EndFrame(CommandBufferType* pCommandBuffer);
+    void BeginPass(CommandBufferType* pCommandBuffer, const char* pName);
+    void EndPass(CommandBufferType* pCommandBuffer);
+
+    bool Resolve();
+
+    int GetPassCount() const { return m_ResultPassCount; }
+    const char* GetPassName(int index) const;
+    const PipelineStatistics& GetPassStatistics(int index) const;
+    int FindPassIndex(const char* pName) const;
+    const PipelineStatistics& GetTotalStatistics() const { return m_TotalStatistics; }
+
+    uint64_t GetResultFrameNumber() const { return m_ResultFrameNumber; }
+    int GetDroppedFrameCount() const { return m_DroppedFrameCount; }
+
+    bool IsInitialized() const { return m_pFrames != nullptr; }
+
+private:
+    struct PassRecord;
+    struct FrameRecord;
+
+    bool TryResolveFrame(int frameIndex);
+    int GetFenceReportIndex() const;
+
+    detail::QueryBufferRing m_QueryRing;
+    FrameRecord* m_pFrames;
+    PassRecord* m_pPasses;
+    PassRecord* m_pResultPasses;
+    PipelineStatistics m_TotalStatistics;
+    int m_MaxPassCount;
+    int m_BufferedFrameCount;
+    int m_CurrentFrameIndex;
+    int m_CurrentPassIndex;
+    int m_ResultPassCount;
+    int m_DroppedFrameCount;
+    uint64_t m_ResultFrameNumber;
+};
+
+}  // namespace util
+}  // namespace nn::gfx
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <nn/gfx/gfx_Enum.h>
+#include <nn/gfx/gfx_StateInfo.h>
+#include <nn/gfx/util/gfx_VertexCacheOptimizer.h>
 #include <nn/util.h>
 
 namespace nn::gfx::util {
@@ -9,7 +11,18 @@ enum PrimitiveShapeFormat {
     PrimitiveShapeFormat_Pos = 0x1,
     PrimitiveShapeFormat_Normal = 0x2,
     PrimitiveShapeFormat_Uv = 0x4,
-    PrimitiveShapeFormat_Default = 0x7
+    PrimitiveShapeFormat_Default = 0x7,
+    // triangle lists are reordered by VertexCacheOptimizer when work memory is given to Calculate
+    PrimitiveShapeFormat_OptimizeVertexCache = 0x8,
+    // packed attributes, each only applies together with the attribute it modifies.
+    // positions become AttributeFormat_16_16_16_16_Float with w = 1, normals
+    // AttributeFormat_10_10_10_2_Snorm or octahedral AttributeFormat_16_16_Snorm, and uvs
+    // AttributeFormat_16_16_Unorm
+    PrimitiveShapeFormat_PosFloat16 = 0x10,
+    PrimitiveShapeFormat_NormalSnorm10 = 0x20,
+    PrimitiveShapeFormat_NormalOctahedral = 0x40,
+    PrimitiveShapeFormat_UvUnorm16 = 0x80,
+    PrimitiveShapeFormat_DefaultPacked = 0xB7
 };
 
 class PrimitiveShape {
@@ -29,6 +42,12 @@ public:
     int GetVertexCount() const;
     int GetIndexCount() const;
     void Calculate(void*, size_t, void*, size_t);
+    // optimizes the vertex cache order as well when the format asks for it. falls back to the
+    // order Calculate writes, returning false, when the work memory is smaller than
+    // CalculateWorkMemorySize(). pOutStatistics may be null
+    bool Calculate(void*, size_t, void*, size_t, void*, size_t,
+                   VertexCacheStatistics* pOutStatistics);
+    size_t CalculateWorkMemorySize() const;
 
 protected:
     PrimitiveShape(PrimitiveShapeFormat, PrimitiveTopology);
@@ -53,6 +72,34 @@ private:
     size_t m_IndexBufferSize;
 };
 
+// vertex state matching the layout PrimitiveShape writes for a vertex format.
+// all attributes are read from vertex buffer 0, shader slots default to the Attribute value
+class PrimitiveShapeVertexStateInfo {
+    NN_NO_COPY(PrimitiveShapeVertexStateInfo);
+
+public:
+    enum Attribute { Attribute_Pos, Attribute_Normal, Attribute_Uv, Attribute_End };
+
+    static AttributeFormat GetAttributeFormat(PrimitiveShapeFormat vertexFormat,
+                                              Attribute attribute);
+    static ptrdiff_t GetAttributeOffset(PrimitiveShapeFormat vertexFormat, Attribute attribute);
+    static size_t GetStride(PrimitiveShapeFormat vertexFormat);
+
+    PrimitiveShapeVertexStateInfo();
+
+    void Initialize(PrimitiveShapeFormat vertexFormat);
+    void SetShaderSlot(Attribute attribute, int shaderSlot);
+    void SetNamePtr(Attribute attribute, const char* pName);
+
+    const VertexStateInfo& GetVertexStateInfo() const { return m_VertexStateInfo; }
+
+private:
+    VertexAttributeStateInfo m_VertexAttributeStateInfo[Attribute_End];
+    VertexBufferStateInfo m_VertexBufferStateInfo;
+    VertexStateInfo m_VertexStateInfo;
+    int m_AttributeIndex[Attribute_End];
+};
+
 class SphereShape : public PrimitiveShape {
     NN_NO_COPY(SphereShape);
 
@@ -147,6 +194,7 @@ protected:
     virtual void CalculateImpl(void*, size_t, void*, size_t);
 
 private:
+    int CalculateStackCount() const;
     void* CalculateVertexBuffer();
 
     template <typename T>
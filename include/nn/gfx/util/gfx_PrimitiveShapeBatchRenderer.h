@@ -0,0 +1,171 @@
+#pragma once
+
+#include <nn/gfx/gfx_Common.h>
+#include <nn/gfx/gfx_StateInfo.h>
+#include <nn/gfx/util/gfx_PrimitiveShape.h>
+#include <nn/util.h>
+#include <nn/util/MathTypes.h>
+
+namespace nn::gfx::util {
+
+class PrimitiveShapeBatchRendererInfo {
+public:
+    PrimitiveShapeBatchRendererInfo() {}
+
+    void SetDefault() {
+        SetVertexFormat(PrimitiveShapeFormat_Default);
+        SetMaxInstanceCount(1024);
+        SetBufferedFrameCount(2);
+        SetSphereSliceCount(16);
+        SetSphereStackCount(8);
+        SetHemiSphereSliceCount(16);
+        SetCircleSliceCount(32);
+    }
+
+    void SetVertexFormat(PrimitiveShapeFormat value) { m_VertexFormat = value; }
+    void SetMaxInstanceCount(int value) { m_MaxInstanceCount = value; }
+    void SetBufferedFrameCount(int value) { m_BufferedFrameCount = value; }
+    void SetSphereSliceCount(int value) { m_SphereSliceCount = value; }
+    void SetSphereStackCount(int value) { m_SphereStackCount = value; }
+    void SetHemiSphereSliceCount(int value) { m_HemiSphereSliceCount = value; }
+    void SetCircleSliceCount(int value) { m_CircleSliceCount = value; }
+
+    PrimitiveShapeFormat GetVertexFormat() const { return m_VertexFormat; }
+    int GetMaxInstanceCount() const { return m_MaxInstanceCount; }
+    int GetBufferedFrameCount() const { return m_BufferedFrameCount; }
+    int GetSphereSliceCount() const { return m_SphereSliceCount; }
+    int GetSphereStackCount() const { return m_SphereStackCount; }
+    int GetHemiSphereSliceCount() const { return m_HemiSphereSliceCount; }
+    int GetCircleSliceCount() const { return m_CircleSliceCount; }
+
+private:
+    PrimitiveShapeFormat m_VertexFormat;
+    int m_MaxInstanceCount;
+    int m_BufferedFrameCount;
+    int m_SphereSliceCount;
+    int m_SphereStackCount;
+    int m_HemiSphereSliceCount;
+    int m_CircleSliceCount;
+};
+
+// draws any number of primitive shapes with one instanced DrawIndexed per shape type and draw
+// mode. the geometry of every shape lives in one shape buffer, shapes only differ by index
+// offset and base vertex. instances are collected between Begin and End and written grouped by
+// shape into the instance buffer slice of the current frame; a slice is reused after
+// BufferedFrameCount frames, so the caller must not run further ahead of the GPU than that.
+// the vertex shader reads the shape attributes from vertex buffer 0 and the instance transform
+// rows and color from vertex buffer 1; world position is dot(transform row i, (pos, 1)).
+class PrimitiveShapeBatchRenderer {
+    NN_NO_COPY(PrimitiveShapeBatchRenderer);
+
+public:
+    typedef PrimitiveShapeBatchRendererInfo InfoType;
+    typedef gfx::detail::CommandBufferImpl<ApiVariationNvn8> CommandBufferType;
+    typedef gfx::detail::BufferImpl<ApiVariationNvn8> BufferType;
+
+    enum ShapeType {
+        ShapeType_Sphere,
+        ShapeType_HemiSphere,
+        ShapeType_Circle,
+        ShapeType_Cube,
+        ShapeType_Quad,
+        ShapeType_End
+    };
+
+    enum DrawMode { DrawMode_Solid, DrawMode_Wired, DrawMode_End };
+
+    enum Attribute {
+        Attribute_Pos,
+        Attribute_Normal,
+        Attribute_Uv,
+        Attribute_Transform0,
+        Attribute_Transform1,
+        Attribute_Transform2,
+        Attribute_Color,
+        Attribute_End
+    };
+
+    enum VertexBufferIndex {
+        VertexBufferIndex_Shape,
+        VertexBufferIndex_Instance,
+        VertexBufferIndex_End
+    };
+
+    struct InstanceData {
+        nn::util::FloatColumnMajor4x3 transform;
+        nn::util::Float4 color;
+    };
+
+    static size_t CalculateShapeBufferSize(const InfoType& info);
+    static size_t GetShapeBufferAlignment();
+    static size_t CalculateInstanceBufferSize(const InfoType& info);
+    static size_t GetInstanceBufferAlignment();
+    static size_t CalculateMemorySize(const InfoType& info);
+    static size_t GetMemoryAlignment();
+
+    PrimitiveShapeBatchRenderer();
+    ~PrimitiveShapeBatchRenderer();
+
+    void Initialize(const InfoType& info, BufferType* pShapeBuffer, ptrdiff_t shapeBufferOffset,
+                    BufferType* pInstanceBuffer, ptrdiff_t instanceBufferOffset, void* pMemory,
+                    size_t memorySize);
+    void Finalize();
+
+    void Begin();
+    int AddInstances(ShapeType shapeType, DrawMode drawMode,
+                     const nn::util::FloatColumnMajor4x3* pTransforms,
+                     const nn::util::Float4* pColors, int count);
+    int AddInstances(ShapeType shapeType, DrawMode drawMode,
+                     const nn::util::FloatColumnMajor4x3* pTransforms,
+                     const nn::util::Float4& color, int count);
+    bool AddInstance(ShapeType shapeType, DrawMode drawMode,
+                     const nn::util::FloatColumnMajor4x3& transform,
+                     const nn::util::Float4& color);
+    void End();
+
+    void Draw(CommandBufferType* pCommandBuffer) const;
+    void Draw(CommandBufferType* pCommandBuffer, DrawMode drawMode) const;
+
+    // shader slots default to the Attribute value and must be set before the vertex state is used
+    void SetShaderSlot(Attribute attribute, int shaderSlot);
+    const VertexStateInfo& GetVertexStateInfo() const { return m_VertexStateInfo; }
+
+    int GetInstanceCount() const { return m_InstanceCount; }
+    int GetInstanceCount(ShapeType shapeType, DrawMode drawMode) const;
+    int GetDroppedInstanceCount() const { return m_DroppedInstanceCount; }
+    int GetDrawCount() const;
+
+    bool IsInitialized() const { return m_pShapes != nullptr; }
+
+private:
+    struct ShapeRecord;
+    struct BatchRecord;
+
+    static const int ShapeCount = ShapeType_End * DrawMode_End;
+
+    void InitializeVertexState(PrimitiveShapeFormat vertexFormat);
+    int AcquireInstances(ShapeType shapeType, DrawMode drawMode, int count);
+    ptrdiff_t GetInstanceSliceOffset() const;
+
+    BufferType* m_pShapeBuffer;
+    ptrdiff_t m_ShapeBufferOffset;
+    BufferType* m_pInstanceBuffer;
+    ptrdiff_t m_InstanceBufferOffset;
+    ShapeRecord* m_pShapes;
+    BatchRecord* m_pBatches;
+    InstanceData* m_pInstances;
+    uint8_t* m_pInstanceShapes;
+    size_t m_Stride;
+    size_t m_VertexBufferSize;
+    int m_MaxInstanceCount;
+    int m_BufferedFrameCount;
+    int m_CurrentFrameIndex;
+    int m_InstanceCount;
+    int m_DroppedInstanceCount;
+    VertexAttributeStateInfo m_VertexAttributeStateInfo[Attribute_End];
+    VertexBufferStateInfo m_VertexBufferStateInfo[VertexBufferIndex_End];
+    VertexStateInfo m_VertexStateInfo;
+    int m_AttributeIndex[Attribute_End];
+};
+
+}  // namespace nn::gfx::util
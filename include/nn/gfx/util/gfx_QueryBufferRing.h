@@ -0,0 +1,66 @@
+#pragma once
+
+#include <nn/gfx/gfx_Common.h>
+#include <nn/util.h>
+
+namespace nn::gfx {
+
+class GpuAddress;
+
+namespace util {
+
+namespace detail {
+
+// a query buffer cut into one slice of reports per buffered frame, shared by the profilers.
+// a slice may only be cleared and recorded into again once the last report of the frame it
+// holds has landed; until then the GPU may still be writing it, so a frame that finds its slice
+// busy must go unrecorded rather than take the slice over.
+class QueryBufferRing {
+    NN_NO_COPY(QueryBufferRing);
+
+public:
+    typedef gfx::detail::BufferImpl<ApiVariationNvn8> BufferType;
+
+    static size_t CalculateBufferSize(int reportCountPerSlice, int sliceCount);
+    static size_t GetBufferAlignment();
+
+    QueryBufferRing();
+
+    void Initialize(BufferType* pBuffer, ptrdiff_t offset, int reportCountPerSlice,
+                    int sliceCount);
+    void Finalize();
+
+    // the slice the next frame records into
+    int GetNextSliceIndex() const { return static_cast<int>(m_FrameCounter % m_SliceCount); }
+    // the slices in the order they were recorded, oldest first
+    int GetOrderedSliceIndex(int order) const {
+        return static_cast<int>((m_FrameCounter + order) % m_SliceCount);
+    }
+    // moves on to the next slice, returning the number of the frame that records into it
+    uint64_t AdvanceFrame() { return m_FrameCounter++; }
+
+    // zeroes the reports of a slice the GPU is done with
+    void ClearSlice(int sliceIndex);
+    // reads the slice back and tells whether the report has landed
+    bool IsReportWritten(int sliceIndex, int reportIndex) const;
+
+    void GetReportAddress(GpuAddress* pOutAddress, int sliceIndex, int reportIndex) const;
+    const void* GetReport(int sliceIndex, int reportIndex) const;
+
+    int GetSliceCount() const { return m_SliceCount; }
+    uint64_t GetFrameCounter() const { return m_FrameCounter; }
+
+private:
+    ptrdiff_t GetReportOffset(int sliceIndex, int reportIndex) const;
+
+    BufferType* m_pBuffer;
+    ptrdiff_t m_Offset;
+    int m_ReportCountPerSlice;
+    int m_SliceCount;
+    uint64_t m_FrameCounter;
+};
+
+}  // namespace detail
+
+}  // namespace util
+}  // namespace nn::gfx
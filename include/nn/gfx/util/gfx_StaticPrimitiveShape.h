@@ -0,0 +1,409 @@
+#pragma once
+
+#include <nn/gfx/gfx_Enum.h>
+#include <nn/gfx/util/gfx_PrimitiveShape.h>
+#include <nn/types.h>
+
+#include <type_traits>
+
+// fixed resolution variants of the primitive shapes that are generated while compiling.
+// the vertex and index layout matches the runtime shapes with the same parameters, so they can
+// be uploaded and drawn the same way, e.g.
+//   typedef StaticSphereShape<PrimitiveShapeFormat_Pos, PrimitiveTopology_LineList, 16, 8> Gizmo;
+//   memcpy(pVertexMemory, Gizmo::GetVertexBuffer(), Gizmo::GetVertexBufferSize());
+
+namespace nn::gfx::util {
+
+namespace detail {
+
+constexpr double StaticPi = 3.14159265358979323846;
+
+constexpr double StaticSin(double radian) {
+    while (radian > StaticPi) {
+        radian -= 2.0 * StaticPi;
+    }
+    while (radian < -StaticPi) {
+        radian += 2.0 * StaticPi;
+    }
+
+    double term = radian;
+    double sum = radian;
+    for (int idx = 1; idx < 12; ++idx) {
+        term *= -radian * radian / ((2 * idx) * (2 * idx + 1));
+        sum += term;
+    }
+    return sum;
+}
+
+constexpr double StaticCos(double radian) {
+    return StaticSin(radian + StaticPi / 2.0);
+}
+
+constexpr int GetStaticVertexElementCount(int vertexFormat) {
+    return ((vertexFormat & PrimitiveShapeFormat_Pos) ? 3 : 0) +
+           ((vertexFormat & PrimitiveShapeFormat_Normal) ? 3 : 0) +
+           ((vertexFormat & PrimitiveShapeFormat_Uv) ? 2 : 0);
+}
+
+// same choice as PrimitiveShape::SetIndexCount
+template <int IndexCount>
+struct StaticIndexTraits {
+    typedef typename std::conditional<
+        IndexCount <= 0xFF, uint8_t,
+        typename std::conditional<IndexCount <= 0xFFFF, uint16_t, uint32_t>::type>::type Type;
+
+    static const IndexFormat Format = IndexCount <= 0xFF   ? IndexFormat_Uint8 :
+                                      IndexCount <= 0xFFFF ? IndexFormat_Uint16 :
+                                                             IndexFormat_Uint32;
+};
+
+constexpr float* WriteStaticVertex(float* pVertexBuffer, int vertexFormat, double x, double y,
+                                   double z, double normalX, double normalY, double normalZ,
+                                   double u, double v) {
+    if (vertexFormat & PrimitiveShapeFormat_Pos) {
+        *pVertexBuffer++ = static_cast<float>(x);
+        *pVertexBuffer++ = static_cast<float>(y);
+        *pVertexBuffer++ = static_cast<float>(z);
+    }
+    if (vertexFormat & PrimitiveShapeFormat_Normal) {
+        *pVertexBuffer++ = static_cast<float>(normalX);
+        *pVertexBuffer++ = static_cast<float>(normalY);
+        *pVertexBuffer++ = static_cast<float>(normalZ);
+    }
+    if (vertexFormat & PrimitiveShapeFormat_Uv) {
+        *pVertexBuffer++ = static_cast<float>(u);
+        *pVertexBuffer++ = static_cast<float>(v);
+    }
+    return pVertexBuffer;
+}
+
+// latitude/longitude grid shared by the sphere and the hemisphere
+constexpr float* WriteStaticSphereVertices(float* pVertexBuffer, int vertexFormat, int sliceCount,
+                                           int stackCount, double stackRange) {
+    for (int idxStack = 0; idxStack <= stackCount; ++idxStack) {
+        double stackRad = stackRange * idxStack / stackCount;
+        for (int idxSlice = 0; idxSlice <= sliceCount; ++idxSlice) {
+            double sliceRad = 2.0 * StaticPi * idxSlice / sliceCount;
+            double x = StaticSin(stackRad) * StaticCos(sliceRad);
+            double y = StaticCos(stackRad);
+            double z = -StaticSin(stackRad) * StaticSin(sliceRad);
+            pVertexBuffer = WriteStaticVertex(pVertexBuffer, vertexFormat, x, y, z, x, y, z,
+                                              static_cast<double>(idxSlice) / sliceCount,
+                                              static_cast<double>(idxStack) / stackCount);
+        }
+    }
+    return pVertexBuffer;
+}
+
+template <typename T>
+constexpr T* WriteStaticSphereIndices(T* pIndexBuffer, PrimitiveTopology primitiveTopology,
+                                      int sliceCount, int stackCount, bool isClosed) {
+    const int numVertsPerStack = sliceCount + 1;
+
+    if (primitiveTopology == PrimitiveTopology_LineList) {
+        for (int idxSlice = 0; idxSlice < sliceCount; ++idxSlice) {
+            for (int idxStack = 0; idxStack < stackCount; ++idxStack) {
+                *pIndexBuffer++ = static_cast<T>(idxStack * numVertsPerStack + idxSlice);
+                *pIndexBuffer++ = static_cast<T>((idxStack + 1) * numVertsPerStack + idxSlice);
+            }
+        }
+
+        const int lastRing = isClosed ? stackCount - 1 : stackCount;
+        for (int idxStack = 1; idxStack <= lastRing; ++idxStack) {
+            for (int idxSlice = 0; idxSlice < sliceCount; ++idxSlice) {
+                *pIndexBuffer++ = static_cast<T>(idxStack * numVertsPerStack + idxSlice);
+                *pIndexBuffer++ = static_cast<T>(idxStack * numVertsPerStack + idxSlice + 1);
+            }
+        }
+        return pIndexBuffer;
+    }
+
+    for (int idxSlice = 0; idxSlice < sliceCount; ++idxSlice) {
+        *pIndexBuffer++ = static_cast<T>(idxSlice);
+        *pIndexBuffer++ = static_cast<T>(idxSlice + numVertsPerStack);
+        *pIndexBuffer++ = static_cast<T>(idxSlice + numVertsPerStack + 1);
+    }
+
+    const int lastBand = isClosed ? stackCount - 1 : stackCount;
+    for (int idxStack = 1; idxStack < lastBand; ++idxStack) {
+        for (int idxSlice = 0; idxSlice < sliceCount; ++idxSlice) {
+            int baseVertex = idxStack * numVertsPerStack + idxSlice;
+            *pIndexBuffer++ = static_cast<T>(baseVertex);
+            *pIndexBuffer++ = static_cast<T>(baseVertex + numVertsPerStack + 1);
+            *pIndexBuffer++ = static_cast<T>(baseVertex + 1);
+            *pIndexBuffer++ = static_cast<T>(baseVertex);
+            *pIndexBuffer++ = static_cast<T>(baseVertex + numVertsPerStack);
+            *pIndexBuffer++ = static_cast<T>(baseVertex + numVertsPerStack + 1);
+        }
+    }
+
+    if (isClosed) {
+        for (int idxSlice = 0; idxSlice < sliceCount; ++idxSlice) {
+            int baseVertex = lastBand * numVertsPerStack + idxSlice;
+            *pIndexBuffer++ = static_cast<T>(baseVertex);
+            *pIndexBuffer++ = static_cast<T>(baseVertex + numVertsPerStack);
+            *pIndexBuffer++ = static_cast<T>(baseVertex + 1);
+        }
+    }
+    return pIndexBuffer;
+}
+
+template <int VertexFormat, PrimitiveTopology Topology, int SliceCount, int StackCount>
+struct StaticSphereShapeGenerator {
+    static_assert(Topology == PrimitiveTopology_LineList ||
+                      Topology == PrimitiveTopology_TriangleList,
+                  "unsupported topology");
+    static_assert(SliceCount >= 3 && StackCount >= 2, "too few slices or stacks");
+
+    static const int Format = VertexFormat;
+    static const PrimitiveTopology PrimitiveTopologyType = Topology;
+    static const int VertexCount = (StackCount + 1) * (SliceCount + 1);
+    static const int IndexCount = Topology == PrimitiveTopology_LineList ?
+                                      (2 * StackCount - 1) * (2 * SliceCount) :
+                                      3 * SliceCount * (2 * StackCount - 2);
+
+    template <typename T>
+    static constexpr void Generate(float* pVertexBuffer, T* pIndexBuffer) {
+        WriteStaticSphereVertices(pVertexBuffer, Format, SliceCount, StackCount, StaticPi);
+        WriteStaticSphereIndices(pIndexBuffer, Topology, SliceCount, StackCount, true);
+    }
+};
+
+template <int VertexFormat, PrimitiveTopology Topology, int SliceCount>
+struct StaticHemiSphereShapeGenerator {
+    static_assert(Topology == PrimitiveTopology_LineList ||
+                      Topology == PrimitiveTopology_TriangleList,
+                  "unsupported topology");
+    static_assert(SliceCount >= 3, "too few slices");
+
+    // same as HemiSphereShape::CalculateStackCount
+    static const int StackCount = SliceCount >= 8 ? SliceCount / 4 : 2;
+
+    static const int Format = VertexFormat;
+    static const PrimitiveTopology PrimitiveTopologyType = Topology;
+    static const int VertexCount = (StackCount + 1) * (SliceCount + 1);
+    static const int IndexCount = Topology == PrimitiveTopology_LineList ?
+                                      4 * SliceCount * StackCount :
+                                      3 * SliceCount * (2 * StackCount - 1);
+
+    template <typename T>
+    static constexpr void Generate(float* pVertexBuffer, T* pIndexBuffer) {
+        WriteStaticSphereVertices(pVertexBuffer, Format, SliceCount, StackCount, StaticPi / 2.0);
+        WriteStaticSphereIndices(pIndexBuffer, Topology, SliceCount, StackCount, false);
+    }
+};
+
+template <int VertexFormat, PrimitiveTopology Topology, int SliceCount>
+struct StaticCircleShapeGenerator {
+    static_assert(Topology == PrimitiveTopology_LineStrip ||
+                      Topology == PrimitiveTopology_TriangleList,
+                  "unsupported topology");
+    static_assert(SliceCount >= 3, "too few slices");
+
+    static const int Format = VertexFormat;
+    static const PrimitiveTopology PrimitiveTopologyType = Topology;
+    static const int VertexCount = SliceCount + 1;
+    static const int IndexCount =
+        Topology == PrimitiveTopology_LineStrip ? SliceCount + 1 : 3 * SliceCount;
+
+    template <typename T>
+    static constexpr void Generate(float* pVertexBuffer, T* pIndexBuffer) {
+        for (int idxSlice = 0; idxSlice < SliceCount; ++idxSlice) {
+            double rad = 2.0 * StaticPi * idxSlice / SliceCount;
+            double cosXY = StaticCos(rad);
+            double sinXY = StaticSin(rad);
+            pVertexBuffer = WriteStaticVertex(pVertexBuffer, Format, cosXY, sinXY, 0.0, 0.0, 0.0,
+                                              1.0, cosXY * 0.5 + 0.5, 1.0 - (sinXY * 0.5 + 0.5));
+        }
+        WriteStaticVertex(pVertexBuffer, Format, 0.0, 0.0, 0.0, 0.0, 0.0, 1.0, 0.5, 0.5);
+
+        for (int idxSlice = 0; idxSlice < SliceCount; ++idxSlice) {
+            if (Topology == PrimitiveTopology_LineStrip) {
+                *pIndexBuffer++ = static_cast<T>(idxSlice);
+            } else {
+                *pIndexBuffer++ = static_cast<T>(SliceCount);
+                *pIndexBuffer++ = static_cast<T>(idxSlice);
+                *pIndexBuffer++ = static_cast<T>((idxSlice + 1) % SliceCount);
+            }
+        }
+        if (Topology == PrimitiveTopology_LineStrip) {
+            *pIndexBuffer++ = 0;
+        }
+    }
+};
+
+template <int VertexFormat, PrimitiveTopology Topology>
+struct StaticCubeShapeGenerator {
+    static_assert(Topology == PrimitiveTopology_LineList ||
+                      Topology == PrimitiveTopology_TriangleList,
+                  "unsupported topology");
+
+    static const int Format = VertexFormat;
+    static const PrimitiveTopology PrimitiveTopologyType = Topology;
+    static const int VertexCount = Topology == PrimitiveTopology_LineList ? 8 : 24;
+    static const int IndexCount = Topology == PrimitiveTopology_LineList ? 48 : 36;
+
+    template <typename T>
+    static constexpr void Generate(float* pVertexBuffer, T* pIndexBuffer) {
+        const double VertexPos[8][3] = {
+            {1.0, 1.0, -1.0}, {1.0, -1.0, -1.0}, {-1.0, -1.0, -1.0}, {-1.0, 1.0, -1.0},
+            {1.0, 1.0, 1.0},  {1.0, -1.0, 1.0},  {-1.0, -1.0, 1.0},  {-1.0, 1.0, 1.0},
+        };
+        const double VertexNormal[6][3] = {
+            {0.0, 0.0, -1.0}, {-1.0, 0.0, 0.0}, {0.0, 0.0, 1.0},
+            {1.0, 0.0, 0.0},  {0.0, -1.0, 0.0}, {0.0, 1.0, 0.0},
+        };
+        const double VertexUv[4][2] = {{0.0, 0.0}, {0.0, 1.0}, {1.0, 1.0}, {1.0, 0.0}};
+        const int FaceTable[6][4] = {
+            {0, 1, 2, 3}, {3, 2, 6, 7}, {7, 6, 5, 4}, {4, 5, 1, 0}, {1, 5, 6, 2}, {4, 0, 3, 7},
+        };
+        const int EdgeTable[12][2] = {
+            {0, 1}, {1, 2}, {2, 3}, {3, 0}, {4, 5}, {5, 6},
+            {6, 7}, {7, 4}, {0, 4}, {1, 5}, {2, 6}, {3, 7},
+        };
+
+        if (Topology == PrimitiveTopology_LineList) {
+            const double InvSqrt3 = 0.57735026918962576;
+            for (int idxCorner = 0; idxCorner < 8; ++idxCorner) {
+                const double* pPos = VertexPos[idxCorner];
+                pVertexBuffer = WriteStaticVertex(
+                    pVertexBuffer, Format, pPos[0] * 0.5, pPos[1] * 0.5, pPos[2] * 0.5,
+                    pPos[0] * InvSqrt3, pPos[1] * InvSqrt3, pPos[2] * InvSqrt3, 0.0, 0.0);
+            }
+            for (int idxEdge = 0; idxEdge < 12; ++idxEdge) {
+                *pIndexBuffer++ = static_cast<T>(EdgeTable[idxEdge][0]);
+                *pIndexBuffer++ = static_cast<T>(EdgeTable[idxEdge][1]);
+            }
+            for (int idxFace = 0; idxFace < 6; ++idxFace) {
+                *pIndexBuffer++ = static_cast<T>(FaceTable[idxFace][0]);
+                *pIndexBuffer++ = static_cast<T>(FaceTable[idxFace][2]);
+                *pIndexBuffer++ = static_cast<T>(FaceTable[idxFace][1]);
+                *pIndexBuffer++ = static_cast<T>(FaceTable[idxFace][3]);
+            }
+            return;
+        }
+
+        for (int idxFace = 0; idxFace < 6; ++idxFace) {
+            for (int idxCorner = 0; idxCorner < 4; ++idxCorner) {
+                const double* pPos = VertexPos[FaceTable[idxFace][idxCorner]];
+                pVertexBuffer = WriteStaticVertex(
+                    pVertexBuffer, Format, pPos[0] * 0.5, pPos[1] * 0.5, pPos[2] * 0.5,
+                    VertexNormal[idxFace][0], VertexNormal[idxFace][1], VertexNormal[idxFace][2],
+                    VertexUv[idxCorner][0], VertexUv[idxCorner][1]);
+            }
+
+            int baseVertex = idxFace * 4;
+            *pIndexBuffer++ = static_cast<T>(baseVertex + 0);
+            *pIndexBuffer++ = static_cast<T>(baseVertex + 1);
+            *pIndexBuffer++ = static_cast<T>(baseVertex + 2);
+            *pIndexBuffer++ = static_cast<T>(baseVertex + 0);
+            *pIndexBuffer++ = static_cast<T>(baseVertex + 2);
+            *pIndexBuffer++ = static_cast<T>(baseVertex + 3);
+        }
+    }
+};
+
+template <int VertexFormat, PrimitiveTopology Topology>
+struct StaticQuadShapeGenerator {
+    static_assert(Topology == PrimitiveTopology_LineStrip ||
+                      Topology == PrimitiveTopology_TriangleList,
+                  "unsupported topology");
+
+    static const int Format = VertexFormat;
+    static const PrimitiveTopology PrimitiveTopologyType = Topology;
+    static const int VertexCount = 4;
+    static const int IndexCount = Topology == PrimitiveTopology_LineStrip ? 5 : 6;
+
+    template <typename T>
+    static constexpr void Generate(float* pVertexBuffer, T* pIndexBuffer) {
+        const double VertexPos[4][2] = {{-0.5, 0.5}, {-0.5, -0.5}, {0.5, -0.5}, {0.5, 0.5}};
+
+        for (int idxCorner = 0; idxCorner < 4; ++idxCorner) {
+            const double* pPos = VertexPos[idxCorner];
+            pVertexBuffer = WriteStaticVertex(pVertexBuffer, Format, pPos[0], pPos[1], 0.0, 0.0,
+                                              0.0, 1.0, pPos[0] + 0.5, 0.5 - pPos[1]);
+        }
+
+        const int WiredIndex[5] = {0, 1, 2, 3, 0};
+        const int SolidIndex[6] = {0, 1, 2, 0, 2, 3};
+        for (int idx = 0; idx < IndexCount; ++idx) {
+            *pIndexBuffer++ = static_cast<T>(Topology == PrimitiveTopology_LineStrip ?
+                                                 WiredIndex[idx] :
+                                                 SolidIndex[idx]);
+        }
+    }
+};
+
+template <typename TGenerator>
+struct StaticPrimitiveShapeBuffer {
+    float vertexBuffer[TGenerator::VertexCount *
+                       GetStaticVertexElementCount(TGenerator::Format)];
+    typename StaticIndexTraits<TGenerator::IndexCount>::Type indexBuffer[TGenerator::IndexCount];
+};
+
+template <typename TGenerator>
+constexpr StaticPrimitiveShapeBuffer<TGenerator> MakeStaticPrimitiveShapeBuffer() {
+    StaticPrimitiveShapeBuffer<TGenerator> buffer{};
+    TGenerator::Generate(buffer.vertexBuffer, buffer.indexBuffer);
+    return buffer;
+}
+
+}  // namespace detail
+
+template <typename TGenerator>
+class StaticPrimitiveShape {
+    // packed attribute formats are only written by the runtime shapes
+    static_assert((TGenerator::Format & ~(PrimitiveShapeFormat_Default |
+                                          PrimitiveShapeFormat_OptimizeVertexCache)) == 0,
+                  "packed vertex formats are not supported");
+    // the index order is fixed while compiling, the runtime shapes reorder it for the cache
+    static_assert((TGenerator::Format & PrimitiveShapeFormat_OptimizeVertexCache) == 0,
+                  "vertex cache optimization is only done by the runtime shapes");
+
+public:
+    typedef typename detail::StaticIndexTraits<TGenerator::IndexCount>::Type IndexType;
+
+    static const void* GetVertexBuffer() { return s_Buffer.vertexBuffer; }
+    static const void* GetIndexBuffer() { return s_Buffer.indexBuffer; }
+    static size_t GetStride() {
+        return sizeof(float) * detail::GetStaticVertexElementCount(TGenerator::Format);
+    }
+    static size_t GetVertexBufferSize() { return sizeof(s_Buffer.vertexBuffer); }
+    static size_t GetIndexBufferSize() { return sizeof(s_Buffer.indexBuffer); }
+    static PrimitiveShapeFormat GetVertexFormat() {
+        return static_cast<PrimitiveShapeFormat>(TGenerator::Format);
+    }
+    static PrimitiveTopology GetPrimitiveTopology() { return TGenerator::PrimitiveTopologyType; }
+    static size_t GetIndexBufferAlignment() { return sizeof(IndexType); }
+    static IndexFormat GetIndexBufferFormat() {
+        return detail::StaticIndexTraits<TGenerator::IndexCount>::Format;
+    }
+    static int GetVertexCount() { return TGenerator::VertexCount; }
+    static int GetIndexCount() { return TGenerator::IndexCount; }
+
+private:
+    static constexpr detail::StaticPrimitiveShapeBuffer<TGenerator> s_Buffer =
+        detail::MakeStaticPrimitiveShapeBuffer<TGenerator>();
+};
+
+template <int VertexFormat, PrimitiveTopology Topology, int SliceCount, int StackCount>
+using StaticSphereShape = StaticPrimitiveShape<
+    detail::StaticSphereShapeGenerator<VertexFormat, Topology, SliceCount, StackCount>>;
+
+template <int VertexFormat, PrimitiveTopology Topology, int SliceCount>
+using StaticHemiSphereShape = StaticPrimitiveShape<
+    detail::StaticHemiSphereShapeGenerator<VertexFormat, Topology, SliceCount>>;
+
+template <int VertexFormat, PrimitiveTopology Topology, int SliceCount>
+using StaticCircleShape =
+    StaticPrimitiveShape<detail::StaticCircleShapeGenerator<VertexFormat, Topology, SliceCount>>;
+
+template <int VertexFormat, PrimitiveTopology Topology>
+using StaticCubeShape =
+    StaticPrimitiveShape<detail::StaticCubeShapeGenerator<VertexFormat, Topology>>;
+
+template <int VertexFormat, PrimitiveTopology Topology>
+using StaticQuadShape =
+    StaticPrimitiveShape<detail::StaticQuadShapeGenerator<VertexFormat, Topology>>;
+
+}  // namespace nn::gfx::util
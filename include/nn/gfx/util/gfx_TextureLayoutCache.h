@@ -0,0 +1,73 @@
+#pragma once
+
+#include <nn/gfx/gfx_Common.h>
+#include <nn/gfx/gfx_TextureInfoData.h>
+#include <nn/gfx/util/gfx_ObjectCache.h>
+#include <nn/util.h>
+
+namespace nn::gfx {
+
+class ResTextureFile;
+class TextureInfo;
+
+}  // namespace nn::gfx
+
+namespace nn::gfx::util {
+
+struct TextureLayout {
+    static const int MaxMipCount = 16;
+
+    size_t mipDataSize;
+    size_t mipDataAlignment;
+    size_t rowPitch;
+    int mipCount;
+    ptrdiff_t mipOffsets[MaxMipCount];
+};
+
+// remembers the storage size, alignment, row pitch and mip offsets of every TextureInfo it has
+// seen, so only the first texture with a given description builds NVN texture builders and
+// queries the device. a full cache keeps answering, it just stops remembering new descriptions.
+class TextureLayoutCache {
+    NN_NO_COPY(TextureLayoutCache);
+
+public:
+    typedef gfx::detail::DeviceImpl<ApiVariationNvn8> DeviceType;
+
+    static size_t CalculateMemorySize(int maxEntryCount);
+    static size_t GetMemoryAlignment();
+
+    TextureLayoutCache();
+    ~TextureLayoutCache();
+
+    void Initialize(DeviceType* pDevice, int maxEntryCount, void* pMemory, size_t memorySize);
+    void Finalize();
+
+    // fails when the texture has more than TextureLayout::MaxMipCount levels
+    bool Calculate(TextureLayout* pOutLayout, const TextureInfo& info);
+
+    // fills one layout per texture of the file in texture order and returns how many were
+    // written, at most layoutCount
+    int Calculate(TextureLayout* pOutLayouts, int layoutCount,
+                  const ResTextureFile* pResTextureFile);
+
+    void Clear();
+
+    int GetEntryCount() const { return m_EntryCount; }
+    int GetMaxEntryCount() const { return m_MaxEntryCount; }
+    int GetHitCount() const { return m_HitCount; }
+    int GetMissCount() const { return m_MissCount; }
+    bool IsInitialized() const { return m_pEntries != nullptr; }
+
+private:
+    struct Entry;
+
+    DeviceType* m_pDevice;
+    Entry* m_pEntries;
+    detail::ObjectCacheIndex m_Index;
+    int m_MaxEntryCount;
+    int m_EntryCount;
+    int m_HitCount;
+    int m_MissCount;
+};
+
+}  // namespace nn::gfx::util
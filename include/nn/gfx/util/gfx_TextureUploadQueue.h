@@ -0,0 +1,103 @@
+#pragma once
+
+#include <nn/gfx/gfx_Common.h>
+#include <nn/util.h>
+
+namespace nn::gfx {
+
+class BufferTextureCopyRegion;
+
+}  // namespace nn::gfx
+
+namespace nn::gfx::util {
+
+class TextureUploadQueueInfo {
+public:
+    TextureUploadQueueInfo() {}
+
+    void SetDefault() {
+        SetStagingBufferSize(4 * 1024 * 1024);
+        SetMaxRequestCount(256);
+        SetMaxBatchCount(4);
+    }
+
+    void SetStagingBufferSize(size_t value) { m_StagingBufferSize = value; }
+    void SetMaxRequestCount(int value) { m_MaxRequestCount = value; }
+    void SetMaxBatchCount(int value) { m_MaxBatchCount = value; }
+
+    size_t GetStagingBufferSize() const { return m_StagingBufferSize; }
+    int GetMaxRequestCount() const { return m_MaxRequestCount; }
+    int GetMaxBatchCount() const { return m_MaxBatchCount; }
+
+private:
+    size_t m_StagingBufferSize;
+    int m_MaxRequestCount;
+    int m_MaxBatchCount;
+};
+
+// streams texture data through a staging ring. Upload copies the source data into the ring right
+// away, Record writes every pending copy into one command buffer sorted by destination so copy
+// strides are only set when they change. the staging space of a batch is reused once the fence
+// given to Record has signaled, which Retire checks without waiting.
+class TextureUploadQueue {
+    NN_NO_COPY(TextureUploadQueue);
+
+public:
+    typedef TextureUploadQueueInfo InfoType;
+    typedef gfx::detail::CommandBufferImpl<ApiVariationNvn8> CommandBufferType;
+    typedef gfx::detail::BufferImpl<ApiVariationNvn8> BufferType;
+    typedef gfx::detail::TextureImpl<ApiVariationNvn8> TextureType;
+    typedef gfx::detail::FenceImpl<ApiVariationNvn8> FenceType;
+
+    static size_t CalculateMemorySize(const InfoType& info);
+    static size_t GetMemoryAlignment();
+    static size_t GetStagingBufferAlignment();
+
+    TextureUploadQueue();
+    ~TextureUploadQueue();
+
+    void Initialize(const InfoType& info, BufferType* pStagingBuffer,
+                    ptrdiff_t stagingBufferOffset, void* pMemory, size_t memorySize);
+    void Finalize();
+
+    // the buffer offset of copyRegion is relative to pData.
+    // fails without side effects when the ring or the request list is full
+    bool Upload(TextureType* pDstTexture, const BufferTextureCopyRegion& copyRegion,
+                const void* pData, size_t dataSize);
+
+    // pFence must be the fence the command buffer is submitted with
+    int Record(CommandBufferType* pCommandBuffer, const FenceType* pFence);
+    void Retire();
+
+    int GetPendingRequestCount() const { return m_RequestCount; }
+    int GetInFlightBatchCount() const { return m_BatchCount; }
+    size_t GetStagingUsedSize() const {
+        return static_cast<size_t>(m_StagingEnd - m_StagingBegin);
+    }
+    int GetRowStrideChangeCount() const { return m_RowStrideChangeCount; }
+
+    bool IsInitialized() const { return m_pRequests != nullptr; }
+
+private:
+    struct Request;
+    struct Batch;
+
+    bool AllocateStaging(ptrdiff_t* pOutOffset, size_t size);
+
+    BufferType* m_pStagingBuffer;
+    ptrdiff_t m_StagingBufferOffset;
+    size_t m_StagingBufferSize;
+    uint64_t m_StagingBegin;
+    uint64_t m_StagingEnd;
+    Request* m_pRequests;
+    int* m_pSortedRequests;
+    Batch* m_pBatches;
+    int m_MaxRequestCount;
+    int m_MaxBatchCount;
+    int m_RequestCount;
+    int m_FirstBatch;
+    int m_BatchCount;
+    int m_RowStrideChangeCount;
+};
+
+}  // namespace nn::gfx::util
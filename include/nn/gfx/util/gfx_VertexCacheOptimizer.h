@@ -0,0 +1,40 @@
+#pragma once
+
+#include <nn/gfx/gfx_Enum.h>
+#include <nn/util.h>
+
+namespace nn::gfx::util {
+
+struct VertexCacheStatistics {
+    float acmrBefore;
+    float acmrAfter;
+};
+
+// reorders triangle list indices for post-transform cache locality (tipsify), then renumbers
+// vertices in order of first use so vertex fetch walks the vertex buffer linearly.
+// acmr is the average number of cache misses per triangle on a fifo cache of the given size.
+class VertexCacheOptimizer {
+public:
+    static const int DefaultCacheSize = 16;
+    static const int MaxCacheSize = 64;
+
+    static size_t CalculateWorkMemorySize(int vertexCount, int indexCount, size_t stride);
+    static size_t GetWorkMemoryAlignment();
+
+    static float CalculateAcmr(const void* pIndexBuffer, IndexFormat indexFormat, int indexCount,
+                               int cacheSize);
+
+    static void OptimizeIndexBuffer(void* pIndexBuffer, IndexFormat indexFormat, int indexCount,
+                                    int vertexCount, int cacheSize, void* pWorkMemory,
+                                    size_t workMemorySize);
+    static void OptimizeVertexFetch(void* pVertexBuffer, size_t stride, int vertexCount,
+                                    void* pIndexBuffer, IndexFormat indexFormat, int indexCount,
+                                    void* pWorkMemory, size_t workMemorySize);
+
+    static void Optimize(VertexCacheStatistics* pOutStatistics, void* pVertexBuffer,
+                         size_t stride, int vertexCount, void* pIndexBuffer,
+                         IndexFormat indexFormat, int indexCount, int cacheSize,
+                         void* pWorkMemory, size_t workMemorySize);
+};
+
+}  // namespace nn::gfx::util
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <nn/gfx/gfx_Common.h>
+#include <nn/gfx/gfx_StateInfo.h>
+#include <nn/util.h>
+
+namespace nn::gfx::util {
+
+// viewports, depth ranges and scissors kept in the float4 / float2 / int4 arrays NVN consumes,
+// packed once when they are set so Bind hands the arrays to the command buffer as they are.
+// setters reject anything past MaxViewportCount instead of writing out of bounds.
+class ViewportScissorArray {
+    NN_NO_COPY(ViewportScissorArray);
+
+public:
+    typedef gfx::detail::CommandBufferImpl<ApiVariationNvn8> CommandBufferType;
+
+    static const int MaxViewportCount = 16;
+
+    ViewportScissorArray();
+
+    bool Initialize(const ViewportScissorStateInfo& info);
+
+    bool SetViewports(int firstViewport, int viewportCount, const ViewportStateInfo* pViewports);
+    bool SetScissors(int firstScissor, int scissorCount, const ScissorStateInfo* pScissors);
+    bool SetViewport(int index, float originX, float originY, float width, float height,
+                     float minDepth, float maxDepth);
+    bool SetScissor(int index, int originX, int originY, int width, int height);
+    bool DisableScissor(int index);
+
+    void Bind(CommandBufferType* pCommandBuffer) const;
+
+    int GetViewportCount() const { return m_ViewportCount; }
+    int GetScissorCount() const { return m_ScissorCount; }
+    const float* GetViewportArray() const { return m_Viewports[0]; }
+    const float* GetDepthRangeArray() const { return m_DepthRanges[0]; }
+    const int* GetScissorArray() const { return m_Scissors[0]; }
+
+private:
+    alignas(16) float m_Viewports[MaxViewportCount][4];
+    alignas(16) int m_Scissors[MaxViewportCount][4];
+    float m_DepthRanges[MaxViewportCount][2];
+    int m_ViewportCount;
+    int m_ScissorCount;
+};
+
+}  // namespace nn::gfx::util
@@ -0,0 +1,151 @@
+#pragma once
+
+#include <nn/gfx/gfx_Common.h>
+#include <nn/util.h>
+
+namespace nn::gfx {
+
+class TextureInfo;
+
+}  // namespace nn::gfx
+
+namespace nn::gfx::util {
+
+struct VirtualTextureTile {
+    uint16_t x;
+    uint16_t y;
+    uint16_t mipLevel;
+    uint16_t reserved;
+};
+
+class VirtualTextureTileManagerInfo {
+public:
+    VirtualTextureTileManagerInfo() {}
+
+    void SetDefault() {
+        SetPageSize(64 * 1024);
+        SetPhysicalPageCount(256);
+        SetMaxRequestCount(64);
+    }
+
+    void SetPageSize(size_t value) { m_PageSize = value; }
+    void SetPhysicalPageCount(int value) { m_PhysicalPageCount = value; }
+    void SetMaxRequestCount(int value) { m_MaxRequestCount = value; }
+
+    size_t GetPageSize() const { return m_PageSize; }
+    int GetPhysicalPageCount() const { return m_PhysicalPageCount; }
+    int GetMaxRequestCount() const { return m_MaxRequestCount; }
+
+private:
+    size_t m_PageSize;
+    int m_PhysicalPageCount;
+    int m_MaxRequestCount;
+};
+
+// keeps the tiles of a sparse 2d texture (Flag_SparseResidency) resident within a fixed number of
+// physical pages. every level that is at least one tile large is split into page sized tiles,
+// stored as consecutive pages in row-major order, level after level; the smaller levels form the
+// mip tail which is mapped once in Initialize and never evicted.
+// Request takes the tiles seen in shader feedback, Update maps pending tiles in request order,
+// reusing the least recently requested tiles once the free pages are gone. tiles requested since
+// the last Update are never evicted, so order requests coarse to fine and keep the budget above
+// what one frame touches. mapped tiles are unfilled until the caller uploads their texels.
+class VirtualTextureTileManager {
+    NN_NO_COPY(VirtualTextureTileManager);
+
+public:
+    typedef VirtualTextureTileManagerInfo InfoType;
+    typedef gfx::detail::DeviceImpl<ApiVariationNvn8> DeviceType;
+    typedef gfx::detail::TextureImpl<ApiVariationNvn8> TextureType;
+    typedef gfx::detail::MemoryPoolImpl<ApiVariationNvn8> MemoryPoolType;
+
+    static const int MaxMipCount = 16;
+    static const int InvalidPageIndex = -1;
+
+    static size_t CalculateMemorySize(const InfoType& info, const TextureInfo& textureInfo);
+    static size_t GetMemoryAlignment();
+
+    // the streaming pages followed by the pages of the mip tail
+    static size_t CalculatePhysicalPoolSize(DeviceType* pDevice, const InfoType& info,
+                                            const TextureInfo& textureInfo);
+
+    VirtualTextureTileManager();
+    ~VirtualTextureTileManager();
+
+    // pTexture is stored at textureOffset of the virtual pool. fails for anything but a sparse 2d
+    // texture without array layers, or when the mip tail cannot be mapped
+    bool Initialize(DeviceType* pDevice, const InfoType& info, const TextureInfo& textureInfo,
+                    TextureType* pTexture, MemoryPoolType* pVirtualPool, ptrdiff_t textureOffset,
+                    MemoryPoolType* pPhysicalPool, ptrdiff_t physicalPoolOffset, void* pMemory,
+                    size_t memorySize);
+    void Finalize();
+
+    // returns how many tiles were accepted, out of range tiles are skipped and requests beyond
+    // MaxRequestCount are dropped until the next Update
+    int Request(const VirtualTextureTile* pTiles, int tileCount);
+
+    // maps pending tiles with a single MapVirtual call and returns how many were mapped. returns
+    // -1 when the mapping fails, leaving the resident tiles as they were and every request pending
+    int Update();
+
+    const VirtualTextureTile& GetMappedTile(int index) const { return m_pMappedTiles[index]; }
+    int GetMappedTileCount() const { return m_MappedTileCount; }
+    int GetPendingRequestCount() const { return m_RequestCount; }
+
+    bool IsResident(const VirtualTextureTile& tile) const;
+    int GetResidentTileCount() const { return m_ResidentTileCount; }
+    int GetEvictedTileCount() const { return m_EvictedTileCount; }
+
+    int GetTileWidth() const { return m_TileWidth; }
+    int GetTileHeight() const { return m_TileHeight; }
+    int GetSparseMipCount() const { return m_SparseMipCount; }
+    int GetTileCountX(int mipLevel) const { return m_TileCountX[mipLevel]; }
+    int GetTileCountY(int mipLevel) const { return m_TileCountY[mipLevel]; }
+
+    bool IsInitialized() const { return m_pPages != nullptr; }
+
+private:
+    struct Page;
+    struct Mapping;
+    struct TileLayout;
+
+    static void CalculateTileLayout(TileLayout* pOutLayout, const InfoType& info,
+                                    const TextureInfo& textureInfo);
+
+    int FindTileIndex(const VirtualTextureTile& tile) const;
+    void Unlink(int pageIndex);
+    void LinkFront(int pageIndex);
+    void SetMapping(Mapping* pMapping, MemoryPoolType* pPhysicalPool,
+                    ptrdiff_t physicalOffset, ptrdiff_t virtualOffset, size_t size) const;
+
+    MemoryPoolType* m_pVirtualPool;
+    MemoryPoolType* m_pPhysicalPool;
+    ptrdiff_t m_TextureOffset;
+    ptrdiff_t m_PhysicalPoolOffset;
+    size_t m_PageSize;
+    int m_StorageClass;
+    int32_t* m_pTilePages;
+    Page* m_pPages;
+    VirtualTextureTile* m_pRequests;
+    VirtualTextureTile* m_pMappedTiles;
+    Mapping* m_pMappings;
+    int m_PhysicalPageCount;
+    int m_TailPageCount;
+    int m_MaxRequestCount;
+    int m_RequestCount;
+    int m_MappedTileCount;
+    int m_FreePageIndex;
+    int m_LruFront;
+    int m_LruBack;
+    int m_ResidentTileCount;
+    int m_EvictedTileCount;
+    uint32_t m_Frame;
+    int m_TileWidth;
+    int m_TileHeight;
+    int m_SparseMipCount;
+    int m_TileCountX[MaxMipCount];
+    int m_TileCountY[MaxMipCount];
+    int m_FirstTileIndex[MaxMipCount];
+};
+
+}  // namespace nn::gfx::util
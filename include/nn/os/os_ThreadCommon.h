@@ -1,7 +1,14 @@
 #pragma once
 
+#include <nn/types.h>
+
 namespace nn::os {
 
 typedef void (*ThreadFunction)(void*);
 
-}  // namespace nn::os
\ No newline at end of file
+const size_t ThreadStackAlignment = 4096;
+const int DefaultThreadPriority = 16;
+// lets the thread take the ideal core of the process instead of a given one
+const int IdealCoreUseDefaultValue = -2;
+
+}  // namespace nn::os
@@ -43,6 +43,10 @@ struct FloatColumnMajor4x3 {
     float m[3][4];
 };
 
+struct FloatColumnMajor4x4 {
+    float m[4][4];
+};
+
 struct Unorm8x4 {
     union {
         uint8_t v[4];
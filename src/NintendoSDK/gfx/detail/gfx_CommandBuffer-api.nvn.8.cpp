@@ -17,67 +17,23 @@
 #include <algorithm>
 
 #include "gfx_CommonHelper.h"
+#include "gfx_NvnCopyHelper.h"
 #include "gfx_NvnHelper.h"
 
 namespace nn::gfx::detail {
 
 namespace {
 
-template <typename T>
-T* ToPtr(const DescriptorSlot& slot) {
-    return reinterpret_cast<T*>(slot.ToData()->value);
-}
-
-void GetNvnCopyRegion(int* pOffsetY, int* pHeight, int* pOffsetZ, int* pDepth,
-                      const TextureCopyRegion& region, NVNtextureTarget target) {
-    *pOffsetY = region.GetOffsetV();
-    *pHeight = region.GetHeight();
-    *pOffsetZ = region.GetOffsetW();
-    *pDepth = region.GetDepth();
-
-    switch (target) {
-    case NVN_TEXTURE_TARGET_1D_ARRAY:
-        *pOffsetY = region.GetSubresource().GetArrayIndex();
-        *pHeight = std::max(region.GetArrayLength(), 1);
-        break;
+// NVN_DEVICE_INFO_MAX_VIEWPORTS, scissors share the limit
+const int MaxViewportCount = 16;
 
-    case NVN_TEXTURE_TARGET_2D_ARRAY:
-    case NVN_TEXTURE_TARGET_2D_MULTISAMPLE_ARRAY:
-        *pOffsetZ = region.GetSubresource().GetArrayIndex();
-        *pDepth = std::max(region.GetArrayLength(), 1);
-        break;
-
-    default:
-        break;
-    }
+bool IsViewportRangeValid(int first, int count) {
+    return first >= 0 && count >= 0 && first + count <= MaxViewportCount;
 }
 
-void GetNvnCopyStride(ptrdiff_t* pRowStride, ptrdiff_t* pImageStride,
-                      const BufferTextureCopyRegion& region, NVNtexture* pTexture) {
-    ptrdiff_t rowStride = 0;
-    ptrdiff_t imageStride = 0;
-
-    if (region.GetBufferImageWidth() != 0 || region.GetBufferImageHeight() != 0) {
-        NVNformat nvnFormat = nvnTextureGetFormat(pTexture);
-        ImageFormat imageFormat = Nvn::GetGfxImageFormat(nvnFormat);
-        ChannelFormat channelFormat = GetChannelFormat(imageFormat);
-
-        int width =
-            ((region.GetBufferImageWidth() != 0) ? region.GetBufferImageWidth() :
-                                                   region.GetTextureCopyRegion().GetWidth());
-        rowStride = width * GetBytePerPixel(channelFormat);
-
-        if (IsCompressedFormat(channelFormat)) {
-            rowStride /= GetBlockWidth(channelFormat) * GetBlockHeight(channelFormat);
-        }
-    }
-
-    if (region.GetBufferImageHeight() != 0) {
-        imageStride = region.GetBufferImageHeight() * rowStride;
-    }
-
-    *pRowStride = rowStride;
-    *pImageStride = imageStride;
+template <typename T>
+T* ToPtr(const DescriptorSlot& slot) {
+    return reinterpret_cast<T*>(slot.ToData()->value);
 }
 
 void SetTextureAndSampler(CommandBufferImpl<ApiVariationNvn8>* pNnCb, ShaderStage stage, int slot,
@@ -974,6 +930,10 @@ void CommandBufferImpl<ApiVariationNvn8>::EndQuery(const GpuAddress& dstBufferAd
         NVNcounterType counterType = Nvn::GetCounterType(target);
         nvnCommandBufferReportCounter(pNvnCommandBuffer, counterType,
                                       Nvn::GetBufferAddress(dstBufferAddress));
+    } else {
+        // nvn has no compute invocation counter, report zero instead of leaving stale memory
+        nvnCommandBufferClearBuffer(pNvnCommandBuffer, Nvn::GetBufferAddress(dstBufferAddress),
+                                    sizeof(NVNcounterData), 0);
     }
 }
 
@@ -993,10 +953,13 @@ void CommandBufferImpl<ApiVariationNvn8>::SetLineWidth(float lineWidth) {
 
 void CommandBufferImpl<ApiVariationNvn8>::SetViewports(int firstViewport, int viewportCount,
                                                        const ViewportStateInfo* pViewports) {
-    const int maxViewports = 16;
+    // a range past the hardware limit would overflow the packing arrays, none of it is set
+    if (!IsViewportRangeValid(firstViewport, viewportCount) || viewportCount == 0) {
+        return;
+    }
 
-    float viewports[maxViewports * 4];
-    float depthRanges[maxViewports * 2];
+    float viewports[MaxViewportCount * 4];
+    float depthRanges[MaxViewportCount * 2];
     float* pViewport = viewports;
     float* pDepthRange = depthRanges;
 
@@ -1017,9 +980,11 @@ void CommandBufferImpl<ApiVariationNvn8>::SetViewports(int firstViewport, int vi
 
 void CommandBufferImpl<ApiVariationNvn8>::SetScissors(int firstScissor, int scissorCount,
                                                       const ScissorStateInfo* pScissors) {
-    const int maxScissors = 16;
+    if (!IsViewportRangeValid(firstScissor, scissorCount) || scissorCount == 0) {
+        return;
+    }
 
-    int scissors[maxScissors * 4];
+    int scissors[MaxViewportCount * 4];
     int* pScissor = scissors;
 
     for (int idxScissor = 0; idxScissor < scissorCount; ++idxScissor) {
@@ -0,0 +1,64 @@
+#include "gfx_NvnCopyHelper.h"
+
+#include <nn/gfx/gfx_TextureInfo.h>
+
+#include <algorithm>
+
+#include "gfx_CommonHelper.h"
+#include "gfx_NvnHelper.h"
+
+namespace nn::gfx::detail {
+
+void GetNvnCopyRegion(int* pOffsetY, int* pHeight, int* pOffsetZ, int* pDepth,
+                      const TextureCopyRegion& region, NVNtextureTarget target) {
+    *pOffsetY = region.GetOffsetV();
+    *pHeight = region.GetHeight();
+    *pOffsetZ = region.GetOffsetW();
+    *pDepth = region.GetDepth();
+
+    switch (target) {
+    case NVN_TEXTURE_TARGET_1D_ARRAY:
+        *pOffsetY = region.GetSubresource().GetArrayIndex();
+        *pHeight = std::max(region.GetArrayLength(), 1);
+        break;
+
+    case NVN_TEXTURE_TARGET_2D_ARRAY:
+    case NVN_TEXTURE_TARGET_2D_MULTISAMPLE_ARRAY:
+        *pOffsetZ = region.GetSubresource().GetArrayIndex();
+        *pDepth = std::max(region.GetArrayLength(), 1);
+        break;
+
+    default:
+        break;
+    }
+}
+
+void GetNvnCopyStride(ptrdiff_t* pRowStride, ptrdiff_t* pImageStride,
+                      const BufferTextureCopyRegion& region, NVNtexture* pTexture) {
+    ptrdiff_t rowStride = 0;
+    ptrdiff_t imageStride = 0;
+
+    if (region.GetBufferImageWidth() != 0 || region.GetBufferImageHeight() != 0) {
+        NVNformat nvnFormat = nvnTextureGetFormat(pTexture);
+        ImageFormat imageFormat = Nvn::GetGfxImageFormat(nvnFormat);
+        ChannelFormat channelFormat = GetChannelFormat(imageFormat);
+
+        int width =
+            ((region.GetBufferImageWidth() != 0) ? region.GetBufferImageWidth() :
+                                                   region.GetTextureCopyRegion().GetWidth());
+        rowStride = width * GetBytePerPixel(channelFormat);
+
+        if (IsCompressedFormat(channelFormat)) {
+            rowStride /= GetBlockWidth(channelFormat) * GetBlockHeight(channelFormat);
+        }
+    }
+
+    if (region.GetBufferImageHeight() != 0) {
+        imageStride = region.GetBufferImageHeight() * rowStride;
+    }
+
+    *pRowStride = rowStride;
+    *pImageStride = imageStride;
+}
+
+}  // namespace nn::gfx::detail
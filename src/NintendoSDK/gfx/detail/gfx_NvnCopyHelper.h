@@ -0,0 +1,23 @@
+#pragma once
+
+#include <nn/gfx/gfx_Common.h>
+#include <nvn/nvn.h>
+
+namespace nn::gfx {
+
+class TextureCopyRegion;
+class BufferTextureCopyRegion;
+
+namespace detail {
+
+// the rows and slices NVN copies for a region, array layers being rows of 1D array textures and
+// slices of 2D array textures
+void GetNvnCopyRegion(int* pOffsetY, int* pHeight, int* pOffsetZ, int* pDepth,
+                      const TextureCopyRegion& region, NVNtextureTarget target);
+
+// the buffer row and image strides of a copy, 0 when the buffer is packed like the region
+void GetNvnCopyStride(ptrdiff_t* pRowStride, ptrdiff_t* pImageStride,
+                      const BufferTextureCopyRegion& region, NVNtexture* pTexture);
+
+}  // namespace detail
+}  // namespace nn::gfx
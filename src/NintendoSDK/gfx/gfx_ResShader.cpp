@@ -2,6 +2,14 @@
 
 namespace nn::gfx {
 
+detail::Caster<void> ResShaderProgram::GetShader() {
+    return detail::Caster<void>(pObj.Get());
+}
+
+detail::Caster<const void> ResShaderProgram::GetShader() const {
+    return detail::Caster<const void>(pObj.Get());
+}
+
 size_t ResShaderFile::GetMaxFileAlignment() {
     return 4096;
 }
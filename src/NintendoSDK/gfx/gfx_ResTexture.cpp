@@ -2,6 +2,14 @@
 
 namespace nn::gfx {
 
+TextureInfo* ResTexture::GetTextureInfo() {
+    return DataToAccessor(textureInfoData);
+}
+
+const TextureInfo* ResTexture::GetTextureInfo() const {
+    return DataToAccessor(textureInfoData);
+}
+
 size_t ResTextureFile::GetMaxFileAlignment() {
     return 0x20000;
 }
@@ -22,4 +30,12 @@ ResTextureFile* ResTextureFile::ResCast(void* ptr) {
     return pRet;
 }
 
+ResTexture* ResTextureFile::GetResTexture(int index) {
+    return textureContainerData.pTexturePtrArray.Get()[index].Get();
+}
+
+const ResTexture* ResTextureFile::GetResTexture(int index) const {
+    return textureContainerData.pTexturePtrArray.Get()[index].Get();
+}
+
 }  // namespace nn::gfx
\ No newline at end of file
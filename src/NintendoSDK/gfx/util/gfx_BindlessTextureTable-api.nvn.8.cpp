@@ -0,0 +1,155 @@
+#include <nn/gfx/util/gfx_BindlessTextureTable.h>
+
+#include <nn/gfx/detail/gfx_Buffer-api.nvn.8.h>
+#include <nn/gfx/detail/gfx_CommandBuffer-api.nvn.8.h>
+#include <nn/gfx/detail/gfx_Device-api.nvn.8.h>
+#include <nn/gfx/gfx_DescriptorSlot.h>
+#include <nn/gfx/gfx_GpuAddress.h>
+#include <nn/util/util_BytePtr.h>
+
+#include <algorithm>
+#include <cstring>
+
+#include "../detail/gfx_NvnHelper.h"
+
+namespace nn::gfx::util {
+
+size_t BindlessTextureTable::CalculateTableBufferSize(const InfoType& info) {
+    return MaterialUniformBlockSize + sizeof(NVNtextureHandle) * info.GetMaxMaterialCount() *
+                                          info.GetHandleCountPerMaterial();
+}
+
+size_t BindlessTextureTable::GetTableBufferAlignment() {
+    // the material uniform block is bound at the start of the table
+    return MaterialUniformBlockSize;
+}
+
+BindlessTextureTable::BindlessTextureTable()
+    : m_pDevice(nullptr), m_pTableBuffer(nullptr), m_TableBufferOffset(0), m_pHandles(nullptr),
+      m_MaxMaterialCount(0), m_HandleCountPerMaterial(0), m_DirtyBegin(0), m_DirtyEnd(0) {}
+
+BindlessTextureTable::~BindlessTextureTable() {}
+
+void BindlessTextureTable::Initialize(DeviceType* pDevice, const InfoType& info,
+                                      BufferType* pTableBuffer, ptrdiff_t tableBufferOffset) {
+    m_pDevice = pDevice;
+    m_pTableBuffer = pTableBuffer;
+    m_TableBufferOffset = tableBufferOffset;
+    m_MaxMaterialCount = info.GetMaxMaterialCount();
+    m_HandleCountPerMaterial = info.GetHandleCountPerMaterial();
+
+    nn::util::BytePtr ptr(m_pTableBuffer->Map(), m_TableBufferOffset);
+    std::memset(ptr.Get(), 0, MaterialUniformBlockSize);
+    m_pHandles = ptr.Advance(MaterialUniformBlockSize).Get<uint64_t>();
+
+    int handleCount = m_MaxMaterialCount * m_HandleCountPerMaterial;
+    std::memset(m_pHandles, 0, sizeof(NVNtextureHandle) * handleCount);
+    m_DirtyBegin = 0;
+    m_DirtyEnd = handleCount;
+    Flush();
+}
+
+void BindlessTextureTable::Finalize() {
+    m_pTableBuffer->Unmap();
+
+    m_pDevice = nullptr;
+    m_pTableBuffer = nullptr;
+    m_pHandles = nullptr;
+}
+
+bool BindlessTextureTable::WriteHandle(int materialIndex, int slot, uint64_t handle) {
+    if (materialIndex < 0 || materialIndex >= m_MaxMaterialCount || slot < 0 ||
+        slot >= m_HandleCountPerMaterial) {
+        return false;
+    }
+
+    int index = materialIndex * m_HandleCountPerMaterial + slot;
+    m_pHandles[index] = handle;
+
+    if (m_DirtyBegin >= m_DirtyEnd) {
+        m_DirtyBegin = index;
+        m_DirtyEnd = index + 1;
+    } else {
+        m_DirtyBegin = std::min(m_DirtyBegin, index);
+        m_DirtyEnd = std::max(m_DirtyEnd, index + 1);
+    }
+    return true;
+}
+
+bool BindlessTextureTable::SetTextureAndSampler(int materialIndex, int slot,
+                                                const DescriptorSlot& textureDescriptor,
+                                                const DescriptorSlot& samplerDescriptor) {
+    NVNtextureHandle handle = nvnDeviceGetTextureHandle(m_pDevice->ToData()->pNvnDevice,
+                                                        textureDescriptor.ToData()->value,
+                                                        samplerDescriptor.ToData()->value);
+    return WriteHandle(materialIndex, slot, handle);
+}
+
+bool BindlessTextureTable::SetTexture(int materialIndex, int slot,
+                                      const DescriptorSlot& textureDescriptor) {
+    NVNtextureHandle handle = nvnDeviceGetTexelFetchHandle(m_pDevice->ToData()->pNvnDevice,
+                                                           textureDescriptor.ToData()->value);
+    return WriteHandle(materialIndex, slot, handle);
+}
+
+bool BindlessTextureTable::SetImage(int materialIndex, int slot,
+                                    const DescriptorSlot& imageDescriptor) {
+    NVNimageHandle handle = nvnDeviceGetImageHandle(m_pDevice->ToData()->pNvnDevice,
+                                                    imageDescriptor.ToData()->value);
+    return WriteHandle(materialIndex, slot, handle);
+}
+
+void BindlessTextureTable::ClearMaterial(int materialIndex) {
+    for (int idxSlot = 0; idxSlot < m_HandleCountPerMaterial; ++idxSlot) {
+        WriteHandle(materialIndex, idxSlot, 0);
+    }
+}
+
+void BindlessTextureTable::Flush() {
+    if (m_DirtyBegin >= m_DirtyEnd) {
+        return;
+    }
+
+    m_pTableBuffer->FlushMappedRange(m_TableBufferOffset + MaterialUniformBlockSize +
+                                         sizeof(NVNtextureHandle) * m_DirtyBegin,
+                                     sizeof(NVNtextureHandle) * (m_DirtyEnd - m_DirtyBegin));
+    m_DirtyBegin = 0;
+    m_DirtyEnd = 0;
+}
+
+void BindlessTextureTable::Bind(CommandBufferType* pCommandBuffer, ShaderStage stage,
+                                int uniformBufferSlot, int storageBufferSlot) const {
+    GpuAddress address;
+    m_pTableBuffer->GetGpuAddress(&address);
+    address.Offset(m_TableBufferOffset);
+    NVNbufferAddress uniformAddress = gfx::detail::Nvn::GetBufferAddress(address);
+
+    NVNcommandBuffer* pNvnCommandBuffer = pCommandBuffer->ToData()->pNvnCommandBuffer;
+    nvnCommandBufferBindUniformBuffer(pNvnCommandBuffer, gfx::detail::Nvn::GetShaderStage(stage),
+                                      uniformBufferSlot, uniformAddress, MaterialUniformBlockSize);
+    nvnCommandBufferBindStorageBuffer(
+        pNvnCommandBuffer, gfx::detail::Nvn::GetShaderStage(stage), storageBufferSlot,
+        uniformAddress + MaterialUniformBlockSize,
+        sizeof(NVNtextureHandle) * m_MaxMaterialCount * m_HandleCountPerMaterial);
+}
+
+void BindlessTextureTable::SetMaterial(CommandBufferType* pCommandBuffer,
+                                       int materialIndex) const {
+    GpuAddress address;
+    m_pTableBuffer->GetGpuAddress(&address);
+    address.Offset(m_TableBufferOffset);
+    NVNbufferAddress uniformAddress = gfx::detail::Nvn::GetBufferAddress(address);
+
+    // the update is ordered with the draws in the command buffer, every draw sees its own value
+    int32_t material[4] = {materialIndex, m_HandleCountPerMaterial, 0, 0};
+    nvnCommandBufferUpdateUniformBuffer(pCommandBuffer->ToData()->pNvnCommandBuffer,
+                                        uniformAddress, MaterialUniformBlockSize, 0,
+                                        sizeof(material), material);
+}
+
+ptrdiff_t BindlessTextureTable::GetHandleOffset(int materialIndex, int slot) const {
+    return MaterialUniformBlockSize +
+           sizeof(NVNtextureHandle) * (materialIndex * m_HandleCountPerMaterial + slot);
+}
+
+}  // namespace nn::gfx::util
@@ -0,0 +1,269 @@
+#include <nn/gfx/util/gfx_CommandMemoryMonitor.h>
+
+#include <nn/gfx/detail/gfx_CommandBuffer-api.nvn.8.h>
+#include <nn/gfx/detail/gfx_Queue-api.nvn.8.h>
+#include <nn/util/util_BytePtr.h>
+
+#include <algorithm>
+#include <cstring>
+
+#include <nvn/nvn_FuncPtrInline.h>
+
+namespace nn::gfx::util {
+
+struct CommandMemoryMonitor::CommandBufferEntry {
+    const CommandBufferType* pCommandBuffer;
+    const char* pName;
+    size_t baseCommandMemoryUsed;
+    size_t baseControlMemoryUsed;
+    size_t retiredCommandMemoryUsed;
+    size_t retiredControlMemoryUsed;
+    bool isRecording;
+    CommandBufferMemoryUsage usage;
+};
+
+struct CommandMemoryMonitor::QueueEntry {
+    const QueueType* pQueue;
+    const char* pName;
+    QueueMemoryUsage usage;
+};
+
+namespace {
+
+const NVNcommandBuffer* GetNvnCommandBuffer(
+    const CommandMemoryMonitor::CommandBufferType* pCommandBuffer) {
+    return pCommandBuffer->ToData()->pNvnCommandBuffer;
+}
+
+}  // namespace
+
+size_t CommandMemoryMonitor::CalculateMemorySize(const InfoType& info) {
+    return sizeof(CommandBufferEntry) * info.GetMaxCommandBufferCount() +
+           sizeof(QueueEntry) * info.GetMaxQueueCount();
+}
+
+size_t CommandMemoryMonitor::GetMemoryAlignment() {
+    return alignof(CommandBufferEntry);
+}
+
+size_t CommandMemoryMonitor::CalculateRecommendedSize(size_t peakUsed, float headroomRatio,
+                                                      size_t alignment) {
+    size_t size = peakUsed + static_cast<size_t>(peakUsed * std::max(headroomRatio, 0.0f));
+    return alignment > 1 ? nn::util::align_up(size, alignment) : size;
+}
+
+CommandMemoryMonitor::CommandMemoryMonitor()
+    : m_pCommandBuffers(nullptr), m_pQueues(nullptr), m_MaxCommandBufferCount(0),
+      m_MaxQueueCount(0), m_CommandBufferCount(0), m_QueueCount(0) {}
+
+CommandMemoryMonitor::~CommandMemoryMonitor() {}
+
+void CommandMemoryMonitor::Initialize(const InfoType& info, void* pMemory,
+                                      [[maybe_unused]] size_t memorySize) {
+    m_MaxCommandBufferCount = info.GetMaxCommandBufferCount();
+    m_MaxQueueCount = info.GetMaxQueueCount();
+
+    nn::util::BytePtr ptr(pMemory);
+    m_pCommandBuffers = ptr.Get<CommandBufferEntry>();
+    m_pQueues = ptr.Advance(sizeof(CommandBufferEntry) * m_MaxCommandBufferCount).Get<QueueEntry>();
+
+    m_CommandBufferCount = 0;
+    m_QueueCount = 0;
+}
+
+void CommandMemoryMonitor::Finalize() {
+    m_pCommandBuffers = nullptr;
+    m_pQueues = nullptr;
+    m_CommandBufferCount = 0;
+    m_QueueCount = 0;
+}
+
+int CommandMemoryMonitor::RegisterCommandBuffer(const CommandBufferType* pCommandBuffer,
+                                                const char* pName) {
+    int index = FindCommandBufferIndex(pCommandBuffer);
+    if (index != InvalidIndex || m_CommandBufferCount >= m_MaxCommandBufferCount) {
+        return index;
+    }
+
+    index = m_CommandBufferCount++;
+    CommandBufferEntry& entry = m_pCommandBuffers[index];
+    std::memset(&entry, 0, sizeof(entry));
+    entry.pCommandBuffer = pCommandBuffer;
+    entry.pName = pName;
+    return index;
+}
+
+int CommandMemoryMonitor::RegisterQueue(const QueueType* pQueue, const char* pName) {
+    int index = FindQueueIndex(pQueue);
+    if (index != InvalidIndex || m_QueueCount >= m_MaxQueueCount) {
+        return index;
+    }
+
+    index = m_QueueCount++;
+    QueueEntry& entry = m_pQueues[index];
+    std::memset(&entry, 0, sizeof(entry));
+    entry.pQueue = pQueue;
+    entry.pName = pName;
+    return index;
+}
+
+void CommandMemoryMonitor::BeginRecording(const CommandBufferType* pCommandBuffer) {
+    int index = FindCommandBufferIndex(pCommandBuffer);
+    if (index == InvalidIndex) {
+        return;
+    }
+
+    // command memory is consumed linearly across recordings until new memory is added
+    const NVNcommandBuffer* pNvnCommandBuffer = GetNvnCommandBuffer(pCommandBuffer);
+    CommandBufferEntry& entry = m_pCommandBuffers[index];
+    entry.baseCommandMemoryUsed = nvnCommandBufferGetCommandMemoryUsed(pNvnCommandBuffer);
+    entry.baseControlMemoryUsed = nvnCommandBufferGetControlMemoryUsed(pNvnCommandBuffer);
+    entry.retiredCommandMemoryUsed = 0;
+    entry.retiredControlMemoryUsed = 0;
+    entry.isRecording = true;
+}
+
+void CommandMemoryMonitor::EndRecording(const CommandBufferType* pCommandBuffer) {
+    int index = FindCommandBufferIndex(pCommandBuffer);
+    if (index == InvalidIndex || !m_pCommandBuffers[index].isRecording) {
+        return;
+    }
+
+    const NVNcommandBuffer* pNvnCommandBuffer = GetNvnCommandBuffer(pCommandBuffer);
+    CommandBufferEntry& entry = m_pCommandBuffers[index];
+    CommandBufferMemoryUsage& usage = entry.usage;
+
+    usage.commandMemoryUsed = entry.retiredCommandMemoryUsed +
+                              nvnCommandBufferGetCommandMemoryUsed(pNvnCommandBuffer) -
+                              entry.baseCommandMemoryUsed;
+    usage.controlMemoryUsed = entry.retiredControlMemoryUsed +
+                              nvnCommandBufferGetControlMemoryUsed(pNvnCommandBuffer) -
+                              entry.baseControlMemoryUsed;
+    usage.peakCommandMemoryUsed = std::max(usage.peakCommandMemoryUsed, usage.commandMemoryUsed);
+    usage.peakControlMemoryUsed = std::max(usage.peakControlMemoryUsed, usage.controlMemoryUsed);
+    usage.commandMemorySize = std::max(usage.commandMemorySize,
+                                       nvnCommandBufferGetCommandMemorySize(pNvnCommandBuffer));
+    usage.controlMemorySize = std::max(usage.controlMemorySize,
+                                       nvnCommandBufferGetControlMemorySize(pNvnCommandBuffer));
+    ++usage.recordingCount;
+
+    entry.isRecording = false;
+}
+
+void CommandMemoryMonitor::NotifyOutOfCommandMemory(const CommandBufferType* pCommandBuffer) {
+    int index = FindCommandBufferIndex(pCommandBuffer);
+    if (index == InvalidIndex) {
+        return;
+    }
+
+    CommandBufferEntry& entry = m_pCommandBuffers[index];
+    ++entry.usage.outOfCommandMemoryCount;
+    if (entry.isRecording) {
+        entry.retiredCommandMemoryUsed +=
+            nvnCommandBufferGetCommandMemoryUsed(GetNvnCommandBuffer(pCommandBuffer)) -
+            entry.baseCommandMemoryUsed;
+        entry.baseCommandMemoryUsed = 0;
+    }
+}
+
+void CommandMemoryMonitor::NotifyOutOfControlMemory(const CommandBufferType* pCommandBuffer) {
+    int index = FindCommandBufferIndex(pCommandBuffer);
+    if (index == InvalidIndex) {
+        return;
+    }
+
+    CommandBufferEntry& entry = m_pCommandBuffers[index];
+    ++entry.usage.outOfControlMemoryCount;
+    if (entry.isRecording) {
+        entry.retiredControlMemoryUsed +=
+            nvnCommandBufferGetControlMemoryUsed(GetNvnCommandBuffer(pCommandBuffer)) -
+            entry.baseControlMemoryUsed;
+        entry.baseControlMemoryUsed = 0;
+    }
+}
+
+void CommandMemoryMonitor::SampleQueue(QueueType* pQueue) {
+    int index = FindQueueIndex(pQueue);
+    if (index == InvalidIndex) {
+        return;
+    }
+
+    NVNqueue* pNvnQueue = pQueue->ToData()->pNvnQueue;
+    QueueMemoryUsage& usage = m_pQueues[index].usage;
+
+    usage.commandMemoryUsed = nvnQueueGetTotalCommandMemoryUsed(pNvnQueue);
+    usage.controlMemoryUsed = nvnQueueGetTotalControlMemoryUsed(pNvnQueue);
+    usage.computeMemoryUsed = nvnQueueGetTotalComputeMemoryUsed(pNvnQueue);
+    usage.peakCommandMemoryUsed = std::max(usage.peakCommandMemoryUsed, usage.commandMemoryUsed);
+    usage.peakControlMemoryUsed = std::max(usage.peakControlMemoryUsed, usage.controlMemoryUsed);
+    usage.peakComputeMemoryUsed = std::max(usage.peakComputeMemoryUsed, usage.computeMemoryUsed);
+    ++usage.sampleCount;
+
+    // the totals accumulate in the driver, so every sample covers the span since the previous one
+    nvnQueueResetMemoryUsageCounts(pNvnQueue);
+}
+
+void CommandMemoryMonitor::ResetPeaks() {
+    for (int idx = 0; idx < m_CommandBufferCount; ++idx) {
+        CommandBufferMemoryUsage& usage = m_pCommandBuffers[idx].usage;
+        usage.peakCommandMemoryUsed = usage.commandMemoryUsed;
+        usage.peakControlMemoryUsed = usage.controlMemoryUsed;
+        usage.outOfCommandMemoryCount = 0;
+        usage.outOfControlMemoryCount = 0;
+    }
+
+    for (int idx = 0; idx < m_QueueCount; ++idx) {
+        QueueMemoryUsage& usage = m_pQueues[idx].usage;
+        usage.peakCommandMemoryUsed = usage.commandMemoryUsed;
+        usage.peakControlMemoryUsed = usage.controlMemoryUsed;
+        usage.peakComputeMemoryUsed = usage.computeMemoryUsed;
+    }
+}
+
+int CommandMemoryMonitor::FindCommandBufferIndex(const CommandBufferType* pCommandBuffer) const {
+    for (int idx = 0; idx < m_CommandBufferCount; ++idx) {
+        if (m_pCommandBuffers[idx].pCommandBuffer == pCommandBuffer) {
+            return idx;
+        }
+    }
+    return InvalidIndex;
+}
+
+const char* CommandMemoryMonitor::GetCommandBufferName(int index) const {
+    return m_pCommandBuffers[index].pName;
+}
+
+const CommandBufferMemoryUsage& CommandMemoryMonitor::GetCommandBufferUsage(int index) const {
+    return m_pCommandBuffers[index].usage;
+}
+
+size_t CommandMemoryMonitor::GetRecommendedCommandMemorySize(int index, float headroomRatio,
+                                                             size_t alignment) const {
+    return CalculateRecommendedSize(m_pCommandBuffers[index].usage.peakCommandMemoryUsed,
+                                    headroomRatio, alignment);
+}
+
+size_t CommandMemoryMonitor::GetRecommendedControlMemorySize(int index, float headroomRatio,
+                                                             size_t alignment) const {
+    return CalculateRecommendedSize(m_pCommandBuffers[index].usage.peakControlMemoryUsed,
+                                    headroomRatio, alignment);
+}
+
+int CommandMemoryMonitor::FindQueueIndex(const QueueType* pQueue) const {
+    for (int idx = 0; idx < m_QueueCount; ++idx) {
+        if (m_pQueues[idx].pQueue == pQueue) {
+            return idx;
+        }
+    }
+    return InvalidIndex;
+}
+
+const char* CommandMemoryMonitor::GetQueueName(int index) const {
+    return m_pQueues[index].pName;
+}
+
+const QueueMemoryUsage& CommandMemoryMonitor::GetQueueUsage(int index) const {
+    return m_pQueues[index].usage;
+}
+
+}  // namespace nn::gfx::util
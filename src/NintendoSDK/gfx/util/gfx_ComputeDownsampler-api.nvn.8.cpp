@@ -0,0 +1,137 @@
+#include <nn/gfx/util/gfx_ComputeDownsampler.h>
+
+#include <nn/gfx/detail/gfx_Buffer-api.nvn.8.h>
+#include <nn/gfx/detail/gfx_CommandBuffer-api.nvn.8.h>
+#include <nn/gfx/detail/gfx_Shader-api.nvn.8.h>
+#include <nn/gfx/gfx_DescriptorSlot.h>
+#include <nn/gfx/gfx_GpuAddress.h>
+#include <nn/gfx/gfx_ResShader.h>
+#include <nn/util/util_BytePtr.h>
+
+#include <algorithm>
+#include <cstring>
+
+#include "../detail/gfx_NvnHelper.h"
+
+namespace nn::gfx::util {
+
+namespace {
+
+// the levels a size halves through before reaching 1
+int CalculateLevelCountBelow(int size) {
+    int count = 0;
+    while (size > 1) {
+        size >>= 1;
+        ++count;
+    }
+    return count;
+}
+
+}  // namespace
+
+size_t ComputeDownsampler::CalculateWorkBufferSize(const InfoType& info) {
+    return ConstantBlockSize + sizeof(uint32_t) * info.GetMaxSliceCount();
+}
+
+size_t ComputeDownsampler::GetWorkBufferAlignment() {
+    // the constant block is bound at the start of the work buffer
+    return ConstantBlockSize;
+}
+
+const ComputeDownsampler::ShaderType*
+ComputeDownsampler::GetShader(const ResShaderFile* pResShaderFile, int variationIndex) {
+    const ResShaderContainer* pContainer = pResShaderFile->GetShaderContainer();
+    if (variationIndex < 0 || variationIndex >= pContainer->GetShaderVariationCount()) {
+        return nullptr;
+    }
+
+    const ResShaderProgram* pProgram =
+        pContainer->GetResShaderVariation(variationIndex)->GetResShaderProgram(
+            ShaderCodeType_Binary);
+    if (pProgram == nullptr) {
+        return nullptr;
+    }
+    return pProgram->GetShader();
+}
+
+ComputeDownsampler::ComputeDownsampler()
+    : m_pShader(nullptr), m_pWorkBuffer(nullptr), m_WorkBufferOffset(0), m_MaxSliceCount(0),
+      m_ConstantBufferSlot(0), m_CounterBufferSlot(0), m_SourceTextureSlot(0),
+      m_FirstImageSlot(0) {}
+
+ComputeDownsampler::~ComputeDownsampler() {}
+
+void ComputeDownsampler::Initialize(const InfoType& info, const ShaderType* pShader,
+                                    BufferType* pWorkBuffer, ptrdiff_t workBufferOffset) {
+    m_pShader = pShader;
+    m_pWorkBuffer = pWorkBuffer;
+    m_WorkBufferOffset = workBufferOffset;
+    m_MaxSliceCount = info.GetMaxSliceCount();
+    m_ConstantBufferSlot = info.GetConstantBufferSlot();
+    m_CounterBufferSlot = info.GetCounterBufferSlot();
+    m_SourceTextureSlot = info.GetSourceTextureSlot();
+    m_FirstImageSlot = info.GetFirstImageSlot();
+
+    // the shader puts every counter back to 0 when its slice is done
+    ptrdiff_t counterOffset = m_WorkBufferOffset + ConstantBlockSize;
+    std::memset(nn::util::BytePtr(m_pWorkBuffer->Map(), counterOffset).Get(), 0,
+                sizeof(uint32_t) * m_MaxSliceCount);
+    m_pWorkBuffer->FlushMappedRange(counterOffset, sizeof(uint32_t) * m_MaxSliceCount);
+    m_pWorkBuffer->Unmap();
+}
+
+void ComputeDownsampler::Finalize() {
+    m_pShader = nullptr;
+    m_pWorkBuffer = nullptr;
+}
+
+bool ComputeDownsampler::Downsample(CommandBufferType* pCommandBuffer,
+                                    const DescriptorSlot& sourceTexture,
+                                    const DescriptorSlot& sourceSampler,
+                                    const DescriptorSlot* pDstImages, int dstMipCount, int width,
+                                    int height, int sliceCount,
+                                    DownsampleReduction reduction) const {
+    if (width <= 0 || width > MaxSourceSize || height <= 0 || height > MaxSourceSize) {
+        return false;
+    }
+    if (dstMipCount < 1 || dstMipCount > MaxMipCount ||
+        dstMipCount > CalculateLevelCountBelow(std::max(width, height)) || sliceCount < 1 ||
+        sliceCount > m_MaxSliceCount) {
+        return false;
+    }
+
+    GpuAddress address;
+    m_pWorkBuffer->GetGpuAddress(&address);
+    address.Offset(m_WorkBufferOffset);
+
+    int workGroupCountX = CalculateWorkGroupCount(width);
+    int workGroupCountY = CalculateWorkGroupCount(height);
+
+    // the update is ordered with the dispatch, the constant block can be shared by every call
+    int32_t constants[8] = {width,           height,          dstMipCount, reduction,
+                            workGroupCountX, workGroupCountY, 0,           0};
+    nvnCommandBufferUpdateUniformBuffer(pCommandBuffer->ToData()->pNvnCommandBuffer,
+                                        gfx::detail::Nvn::GetBufferAddress(address),
+                                        ConstantBlockSize, 0, sizeof(constants), constants);
+
+    pCommandBuffer->SetShader(m_pShader, ShaderStageBit_Compute);
+    pCommandBuffer->SetConstantBuffer(m_ConstantBufferSlot, ShaderStage_Compute, address,
+                                      ConstantBlockSize);
+
+    GpuAddress counterAddress = address;
+    counterAddress.Offset(ConstantBlockSize);
+    pCommandBuffer->SetUnorderedAccessBuffer(m_CounterBufferSlot, ShaderStage_Compute,
+                                             counterAddress, sizeof(uint32_t) * m_MaxSliceCount);
+
+    pCommandBuffer->SetTextureAndSampler(m_SourceTextureSlot, ShaderStage_Compute, sourceTexture,
+                                         sourceSampler);
+    for (int idxMip = 0; idxMip < dstMipCount; ++idxMip) {
+        pCommandBuffer->SetImage(m_FirstImageSlot + idxMip, ShaderStage_Compute,
+                                 pDstImages[idxMip]);
+    }
+
+    pCommandBuffer->Dispatch(workGroupCountX, workGroupCountY, sliceCount);
+    return true;
+}
+
+}  // namespace nn::gfx::util
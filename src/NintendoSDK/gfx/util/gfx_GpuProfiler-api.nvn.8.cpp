@@ -0,0 +1,381 @@
+#include <nn/gfx/util/gfx_GpuProfiler.h>
+
+#include <nn/gfx/detail/gfx_CommandBuffer-api.nvn.8.h>
+#include <nn/gfx/gfx_GpuAddress.h>
+#include <nn/util/util_BytePtr.h>
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+#include "../detail/gfx_NvnHelper.h"
+
+namespace nn::gfx::util {
+
+namespace {
+
+const char* const g_FrameScopeName = "Frame";
+
+// the JSON string form of a scope name, cut short when it does not fit
+size_t EscapeJsonString(char* pBuffer, size_t bufferSize, const char* pString) {
+    size_t length = 0;
+    for (const char* p = pString; *p != '\0'; ++p) {
+        char c = *p;
+        char escaped[8];
+        int escapedLength;
+        if (c == '"' || c == '\\') {
+            escaped[0] = '\\';
+            escaped[1] = c;
+            escapedLength = 2;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            escapedLength = nn::util::SNPrintf(escaped, sizeof(escaped), "\\u%04x", c);
+        } else {
+            escaped[0] = c;
+            escapedLength = 1;
+        }
+
+        if (length + escapedLength >= bufferSize) {
+            break;
+        }
+        std::memcpy(pBuffer + length, escaped, escapedLength);
+        length += escapedLength;
+    }
+    if (bufferSize > 0) {
+        pBuffer[length] = '\0';
+    }
+    return length;
+}
+
+}  // namespace
+
+struct GpuProfiler::ScopeRecord {
+    const char* pName;
+    int statisticsIndex;
+    int depth;
+    int64_t beginTime;
+    int64_t endTime;
+};
+
+struct GpuProfiler::FrameRecord {
+    enum State { State_Free, State_Recording, State_Recorded, State_Resolved };
+
+    int state;
+    int scopeCount;
+    uint64_t frameNumber;
+};
+
+size_t GpuProfiler::CalculateQueryBufferSize(const InfoType& info) {
+    return detail::QueryBufferRing::CalculateBufferSize(info.GetMaxScopeCount() * 2,
+                                                        info.GetBufferedFrameCount());
+}
+
+size_t GpuProfiler::GetQueryBufferAlignment() {
+    return detail::QueryBufferRing::GetBufferAlignment();
+}
+
+size_t GpuProfiler::CalculateMemorySize(const InfoType& info) {
+    int bucketCount = detail::ObjectCacheIndex::CalculateBucketCount(
+        info.GetMaxScopeStatisticsCount());
+    return sizeof(FrameRecord) * info.GetBufferedFrameCount() +
+           sizeof(ScopeRecord) * info.GetMaxScopeCount() * info.GetBufferedFrameCount() +
+           sizeof(ScopeStatistics) * info.GetMaxScopeStatisticsCount() +
+           (sizeof(int32_t) + sizeof(uint32_t)) * bucketCount;
+}
+
+size_t GpuProfiler::GetMemoryAlignment() {
+    return alignof(int64_t);
+}
+
+GpuProfiler::GpuProfiler()
+    : m_pFrames(nullptr), m_pScopes(nullptr), m_pScopeStatistics(nullptr), m_MaxScopeCount(0),
+      m_MaxScopeStatisticsCount(0), m_ScopeStatisticsCount(0), m_BufferedFrameCount(0),
+      m_CurrentFrameIndex(-1), m_ScopeDepth(0), m_ResolvedFrameCount(0), m_DroppedFrameCount(0) {}
+
+GpuProfiler::~GpuProfiler() {}
+
+void GpuProfiler::Initialize(const InfoType& info, BufferType* pQueryBuffer,
+                             ptrdiff_t queryBufferOffset, void* pMemory,
+                             [[maybe_unused]] size_t memorySize) {
+    m_MaxScopeCount = info.GetMaxScopeCount();
+    m_MaxScopeStatisticsCount = info.GetMaxScopeStatisticsCount();
+    m_BufferedFrameCount = info.GetBufferedFrameCount();
+    m_QueryRing.Initialize(pQueryBuffer, queryBufferOffset, m_MaxScopeCount * 2,
+                           m_BufferedFrameCount);
+
+    int bucketCount = detail::ObjectCacheIndex::CalculateBucketCount(m_MaxScopeStatisticsCount);
+
+    nn::util::BytePtr ptr(pMemory);
+    m_pFrames = ptr.Get<FrameRecord>();
+    m_pScopes = ptr.Advance(sizeof(FrameRecord) * m_BufferedFrameCount).Get<ScopeRecord>();
+    m_pScopeStatistics = ptr.Advance(sizeof(ScopeRecord) * m_MaxScopeCount * m_BufferedFrameCount)
+                             .Get<ScopeStatistics>();
+    int32_t* pBuckets =
+        ptr.Advance(sizeof(ScopeStatistics) * m_MaxScopeStatisticsCount).Get<int32_t>();
+    uint32_t* pHashes = ptr.Advance(sizeof(int32_t) * bucketCount).Get<uint32_t>();
+    m_ScopeStatisticsIndex.Initialize(pBuckets, pHashes, bucketCount);
+
+    for (int idxFrame = 0; idxFrame < m_BufferedFrameCount; ++idxFrame) {
+        m_pFrames[idxFrame].state = FrameRecord::State_Free;
+        m_pFrames[idxFrame].scopeCount = 0;
+        m_pFrames[idxFrame].frameNumber = 0;
+    }
+
+    m_ScopeStatisticsCount = 0;
+    m_CurrentFrameIndex = -1;
+    m_ScopeDepth = 0;
+    m_ResolvedFrameCount = 0;
+    m_DroppedFrameCount = 0;
+}
+
+void GpuProfiler::Finalize() {
+    m_QueryRing.Finalize();
+    m_pFrames = nullptr;
+    m_pScopes = nullptr;
+    m_pScopeStatistics = nullptr;
+}
+
+void GpuProfiler::BeginFrame(CommandBufferType* pCommandBuffer) {
+    Resolve();
+
+    m_ScopeDepth = 0;
+    m_CurrentFrameIndex = m_QueryRing.GetNextSliceIndex();
+    FrameRecord& frame = m_pFrames[m_CurrentFrameIndex];
+
+    if (frame.state == FrameRecord::State_Recorded) {
+        // the GPU is more than BufferedFrameCount frames behind and may still write the slice,
+        // so this frame goes unrecorded and the next one tries the same slice again
+        ++m_DroppedFrameCount;
+        m_CurrentFrameIndex = -1;
+        BeginScope(pCommandBuffer, g_FrameScopeName);
+        return;
+    }
+
+    m_QueryRing.ClearSlice(m_CurrentFrameIndex);
+    frame.state = FrameRecord::State_Recording;
+    frame.scopeCount = 0;
+    frame.frameNumber = m_QueryRing.AdvanceFrame();
+
+    BeginScope(pCommandBuffer, g_FrameScopeName);
+}
+
+void GpuProfiler::EndFrame(CommandBufferType* pCommandBuffer) {
+    while (m_ScopeDepth > 0) {
+        EndScope(pCommandBuffer);
+    }
+
+    if (m_CurrentFrameIndex >= 0) {
+        m_pFrames[m_CurrentFrameIndex].state = FrameRecord::State_Recorded;
+        m_CurrentFrameIndex = -1;
+    }
+}
+
+void GpuProfiler::BeginScope(CommandBufferType* pCommandBuffer, const char* pName) {
+    if (m_ScopeDepth >= MaxScopeDepth) {
+        ++m_ScopeDepth;
+        return;
+    }
+
+    FrameRecord* pFrame = (m_CurrentFrameIndex >= 0) ? &m_pFrames[m_CurrentFrameIndex] : nullptr;
+    if (pFrame == nullptr || pFrame->scopeCount >= m_MaxScopeCount) {
+        m_ScopeStack[m_ScopeDepth++] = -1;
+        return;
+    }
+
+    int parentStatisticsIndex = InvalidScopeStatisticsIndex;
+    for (int idxDepth = m_ScopeDepth - 1; idxDepth >= 0; --idxDepth) {
+        if (m_ScopeStack[idxDepth] >= 0) {
+            int parentIndex = m_CurrentFrameIndex * m_MaxScopeCount + m_ScopeStack[idxDepth];
+            parentStatisticsIndex = m_pScopes[parentIndex].statisticsIndex;
+            break;
+        }
+    }
+
+    int localIndex = pFrame->scopeCount++;
+    ScopeRecord& scope = m_pScopes[m_CurrentFrameIndex * m_MaxScopeCount + localIndex];
+    scope.pName = pName;
+    scope.depth = m_ScopeDepth;
+    scope.statisticsIndex = AcquireScopeStatistics(pName, parentStatisticsIndex, m_ScopeDepth);
+    scope.beginTime = 0;
+    scope.endTime = 0;
+
+    m_ScopeStack[m_ScopeDepth++] = localIndex;
+    WriteQuery(pCommandBuffer, localIndex * 2);
+}
+
+void GpuProfiler::EndScope(CommandBufferType* pCommandBuffer) {
+    if (m_ScopeDepth <= 0) {
+        return;
+    }
+
+    if (m_ScopeDepth-- > MaxScopeDepth) {
+        return;
+    }
+
+    int localIndex = m_ScopeStack[m_ScopeDepth];
+    if (localIndex >= 0) {
+        WriteQuery(pCommandBuffer, localIndex * 2 + 1);
+    }
+}
+
+void GpuProfiler::Resolve() {
+    // oldest frames first so the statistics see samples in submission order
+    for (int idx = 0; idx < m_BufferedFrameCount; ++idx) {
+        int idxFrame = m_QueryRing.GetOrderedSliceIndex(idx);
+        if (m_pFrames[idxFrame].state == FrameRecord::State_Recorded) {
+            TryResolveFrame(idxFrame);
+        }
+    }
+}
+
+void GpuProfiler::ResetStatistics() {
+    m_ScopeStatisticsCount = 0;
+    m_ScopeStatisticsIndex.Clear();
+
+    // scopes that are still in flight refer to statistics that no longer exist
+    for (int idxFrame = 0; idxFrame < m_BufferedFrameCount; ++idxFrame) {
+        FrameRecord& frame = m_pFrames[idxFrame];
+        for (int idxScope = 0; idxScope < frame.scopeCount; ++idxScope) {
+            m_pScopes[idxFrame * m_MaxScopeCount + idxScope].statisticsIndex =
+                InvalidScopeStatisticsIndex;
+        }
+    }
+}
+
+int GpuProfiler::FindScopeStatisticsIndex(const char* pName, int parentIndex) const {
+    uint32_t hash = detail::CalculateObjectCacheHash(pName, std::strlen(pName)) ^
+                    static_cast<uint32_t>(parentIndex + 1) * 0x9E3779B9u;
+
+    return m_ScopeStatisticsIndex.Find(hash, [&](int idx) {
+        const ScopeStatistics& statistics = m_pScopeStatistics[idx];
+        return statistics.parentIndex == parentIndex &&
+               (statistics.pName == pName || std::strcmp(statistics.pName, pName) == 0);
+    });
+}
+
+int GpuProfiler::AcquireScopeStatistics(const char* pName, int parentIndex, int depth) {
+    int index = FindScopeStatisticsIndex(pName, parentIndex);
+    if (index != detail::ObjectCacheIndex::InvalidIndex) {
+        return index;
+    }
+
+    if (m_ScopeStatisticsCount >= m_MaxScopeStatisticsCount) {
+        return InvalidScopeStatisticsIndex;
+    }
+
+    index = m_ScopeStatisticsCount++;
+    ScopeStatistics& statistics = m_pScopeStatistics[index];
+    statistics.pName = pName;
+    statistics.parentIndex = parentIndex;
+    statistics.depth = depth;
+    statistics.sampleCount = 0;
+    statistics.lastTime = 0;
+    statistics.minTime = std::numeric_limits<int64_t>::max();
+    statistics.maxTime = 0;
+    statistics.totalTime = 0;
+
+    uint32_t hash = detail::CalculateObjectCacheHash(pName, std::strlen(pName)) ^
+                    static_cast<uint32_t>(parentIndex + 1) * 0x9E3779B9u;
+    m_ScopeStatisticsIndex.Insert(hash, index);
+    return index;
+}
+
+bool GpuProfiler::TryResolveFrame(int frameIndex) {
+    FrameRecord& frame = m_pFrames[frameIndex];
+    if (frame.scopeCount == 0) {
+        frame.state = FrameRecord::State_Resolved;
+        return true;
+    }
+
+    // the root scope is closed by the last report of the frame
+    if (!m_QueryRing.IsReportWritten(frameIndex, 1)) {
+        return false;
+    }
+
+    for (int idxScope = 0; idxScope < frame.scopeCount; ++idxScope) {
+        ScopeRecord& scope = m_pScopes[frameIndex * m_MaxScopeCount + idxScope];
+        auto pBegin =
+            static_cast<const NVNcounterData*>(m_QueryRing.GetReport(frameIndex, idxScope * 2));
+        auto pEnd = static_cast<const NVNcounterData*>(
+            m_QueryRing.GetReport(frameIndex, idxScope * 2 + 1));
+
+        scope.beginTime = gfx::detail::Nvn::ToTimeSpan(pBegin->timestamp).GetNanoSeconds();
+        scope.endTime = gfx::detail::Nvn::ToTimeSpan(pEnd->timestamp).GetNanoSeconds();
+
+        if (scope.statisticsIndex == InvalidScopeStatisticsIndex || pEnd->timestamp == 0) {
+            continue;
+        }
+
+        int64_t time = std::max<int64_t>(scope.endTime - scope.beginTime, 0);
+        ScopeStatistics& statistics = m_pScopeStatistics[scope.statisticsIndex];
+        statistics.lastTime = time;
+        statistics.minTime = std::min(statistics.minTime, time);
+        statistics.maxTime = std::max(statistics.maxTime, time);
+        statistics.totalTime += time;
+        ++statistics.sampleCount;
+    }
+
+    frame.state = FrameRecord::State_Resolved;
+    ++m_ResolvedFrameCount;
+    return true;
+}
+
+void GpuProfiler::WriteQuery(CommandBufferType* pCommandBuffer, int reportIndex) {
+    GpuAddress address;
+    m_QueryRing.GetReportAddress(&address, m_CurrentFrameIndex, reportIndex);
+    pCommandBuffer->WriteTimestamp(address);
+}
+
+size_t GpuProfiler::WriteChromeTrace(char* pBuffer, size_t bufferSize) const {
+    size_t length = 0;
+    auto append = [&](const char* pFormat, auto... args) {
+        if (length + 1 >= bufferSize) {
+            return;
+        }
+        int written = nn::util::SNPrintf(pBuffer + length, bufferSize - length, pFormat, args...);
+        if (written > 0) {
+            length = std::min(length + written, bufferSize - 1);
+        }
+    };
+
+    int64_t baseTime = std::numeric_limits<int64_t>::max();
+    for (int idxFrame = 0; idxFrame < m_BufferedFrameCount; ++idxFrame) {
+        const FrameRecord& frame = m_pFrames[idxFrame];
+        if (frame.state == FrameRecord::State_Resolved && frame.scopeCount > 0) {
+            baseTime = std::min(baseTime, m_pScopes[idxFrame * m_MaxScopeCount].beginTime);
+        }
+    }
+
+    append("{\"traceEvents\":[");
+
+    bool isFirst = true;
+    for (int idx = 0; idx < m_BufferedFrameCount; ++idx) {
+        int idxFrame = m_QueryRing.GetOrderedSliceIndex(idx);
+        const FrameRecord& frame = m_pFrames[idxFrame];
+        if (frame.state != FrameRecord::State_Resolved) {
+            continue;
+        }
+
+        for (int idxScope = 0; idxScope < frame.scopeCount; ++idxScope) {
+            const ScopeRecord& scope = m_pScopes[idxFrame * m_MaxScopeCount + idxScope];
+            if (scope.endTime < scope.beginTime) {
+                continue;
+            }
+
+            append("%s{\"name\":\"", isFirst ? "" : ",");
+            if (length + 1 < bufferSize) {
+                length += EscapeJsonString(pBuffer + length, bufferSize - length, scope.pName);
+            }
+            append("\",\"cat\":\"gpu\",\"ph\":\"X\",\"pid\":0,\"tid\":0,"
+                   "\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"frame\":%llu,\"depth\":%d}}",
+                   (scope.beginTime - baseTime) / 1000.0,
+                   (scope.endTime - scope.beginTime) / 1000.0,
+                   static_cast<unsigned long long>(frame.frameNumber), scope.depth);
+            isFirst = false;
+        }
+    }
+
+    append("]}");
+    return length;
+}
+
+}  // namespace nn::gfx::util
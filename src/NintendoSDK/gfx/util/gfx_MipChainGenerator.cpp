@@ -0,0 +1,464 @@
+#include <nn/gfx/util/gfx_MipChainGenerator.h>
+
+#include <nn/gfx/gfx_TextureInfo.h>
+#include <nn/util/util_BytePtr.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "../detail/gfx_CommonHelper.h"
+
+namespace nn::gfx::util {
+
+struct MipChainGenerator::LevelLayout {
+    void* pData;
+    int width;
+    int height;
+    size_t rowSize;
+};
+
+namespace {
+
+const int KaiserTapCount = 6;
+const float Pi = 3.14159265358979f;
+
+float ConvertFromSrgb(float value) {
+    return value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+}
+
+// zeroth order modified bessel function of the first kind
+float CalculateBessel0(float value) {
+    float sum = 1.0f;
+    float term = 1.0f;
+    float halfSquared = value * value * 0.25f;
+    for (int idx = 1; idx < 32 && term > sum * 1e-7f; ++idx) {
+        term *= halfSquared / static_cast<float>(idx * idx);
+        sum += term;
+    }
+    return sum;
+}
+
+float CalculateSinc(float value) {
+    if (std::fabs(value) < 1e-5f) {
+        return 1.0f;
+    }
+    return std::sin(Pi * value) / (Pi * value);
+}
+
+float ConvertFromFloat16(uint16_t value) {
+    uint32_t sign = static_cast<uint32_t>(value & 0x8000) << 16;
+    uint32_t exponent = (value >> 10) & 0x1F;
+    uint32_t mantissa = value & 0x3FF;
+
+    uint32_t bits;
+    if (exponent == 0) {
+        // denormals are flushed like ConvertToFloat16 does
+        bits = sign;
+    } else if (exponent == 31) {
+        bits = sign | 0x7F800000 | (mantissa << 13);
+    } else {
+        bits = sign | ((exponent - 15 + 127) << 23) | (mantissa << 13);
+    }
+
+    float result;
+    std::memcpy(&result, &bits, sizeof(result));
+    return result;
+}
+
+uint16_t ConvertToFloat16(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+
+    uint32_t sign = (bits >> 16) & 0x8000;
+    int exponent = static_cast<int>((bits >> 23) & 0xFF) - 127 + 15;
+    uint32_t mantissa = bits & 0x7FFFFF;
+
+    if (exponent <= 0) {
+        return static_cast<uint16_t>(sign);
+    }
+    if (exponent >= 31) {
+        return static_cast<uint16_t>(sign | 0x7C00);
+    }
+
+    uint32_t half = sign | (exponent << 10) | (mantissa >> 13);
+    if (mantissa & 0x1000) {
+        ++half;
+    }
+    return static_cast<uint16_t>(half);
+}
+
+uint32_t ConvertToUnorm(float value, float maxValue) {
+    float clamped = std::min(std::max(value, 0.0f), 1.0f);
+    return static_cast<uint32_t>(clamped * maxValue + 0.5f);
+}
+
+}  // namespace
+
+bool MipChainGenerator::GetElementType(ElementType* pOutType, int* pOutChannelCount,
+                                       ImageFormat format) {
+    TypeFormat typeFormat = static_cast<TypeFormat>(format & ((1 << TypeFormat_Bits) - 1));
+    bool isUnorm = typeFormat == TypeFormat_Unorm || gfx::detail::IsSrgbFormat(typeFormat);
+    bool isFloat = typeFormat == TypeFormat_Float;
+    bool isSupported;
+
+    switch (gfx::detail::GetChannelFormat(format)) {
+    case ChannelFormat_R8:
+    case ChannelFormat_R8_G8:
+    case ChannelFormat_R8_G8_B8_A8:
+    case ChannelFormat_B8_G8_R8_A8:
+        *pOutType = ElementType_Unorm8;
+        isSupported = isUnorm;
+        break;
+    case ChannelFormat_R16:
+    case ChannelFormat_R16_G16:
+    case ChannelFormat_R16_G16_B16_A16:
+        *pOutType = isFloat ? ElementType_Float16 : ElementType_Unorm16;
+        isSupported = isUnorm || isFloat;
+        break;
+    case ChannelFormat_R32:
+    case ChannelFormat_R32_G32:
+    case ChannelFormat_R32_G32_B32_A32:
+        *pOutType = ElementType_Float32;
+        isSupported = isFloat;
+        break;
+    case ChannelFormat_R10_G10_B10_A2:
+        *pOutType = ElementType_Unorm10_10_10_2;
+        isSupported = isUnorm;
+        break;
+    default:
+        return false;
+    }
+
+    *pOutChannelCount = gfx::detail::GetChannelCount(gfx::detail::GetChannelFormat(format));
+    return isSupported;
+}
+
+bool MipChainGenerator::IsSupportedFormat(ImageFormat format) {
+    ElementType elementType;
+    int channelCount;
+    return GetElementType(&elementType, &channelCount, format);
+}
+
+size_t MipChainGenerator::CalculateWorkMemorySize(const InfoType& info,
+                                                  const TextureInfo& textureInfo) {
+    int tapCount = info.GetFilter() == MipFilter_Kaiser ? KaiserTapCount : 2;
+    size_t width = textureInfo.GetWidth();
+    size_t halfWidth = std::max<size_t>(width / 2, 1);
+
+    // one decoded source row, the horizontally filtered rows under the kernel and the result row
+    return sizeof(float) * 4 * (width + halfWidth * (tapCount + 1));
+}
+
+size_t MipChainGenerator::GetWorkMemoryAlignment() {
+    return alignof(float);
+}
+
+MipChainGenerator::MipChainGenerator()
+    : m_pMipData(nullptr), m_pMipOffsets(nullptr), m_ElementType(ElementType_Unorm8),
+      m_ChannelFormat(ChannelFormat_Undefined), m_Width(0), m_Height(0), m_MipCount(0),
+      m_SliceCount(0), m_ChannelCount(0), m_TapCount(0), m_IsSrgb(false) {}
+
+MipChainGenerator::~MipChainGenerator() {}
+
+bool MipChainGenerator::Initialize(const InfoType& info, const TextureInfo& textureInfo,
+                                   void* pMipData, const ptrdiff_t* pMipOffsets) {
+    ImageFormat format = textureInfo.GetImageFormat();
+    ImageStorageDimension storageDimension = textureInfo.GetImageStorageDimension();
+    if (storageDimension == ImageStorageDimension_3d ||
+        !GetElementType(&m_ElementType, &m_ChannelCount, format)) {
+        return false;
+    }
+
+    m_pMipOffsets = pMipOffsets;
+    m_ChannelFormat = gfx::detail::GetChannelFormat(format);
+    m_Width = textureInfo.GetWidth();
+    m_Height = storageDimension == ImageStorageDimension_1d ? 1 : textureInfo.GetHeight();
+    m_MipCount = textureInfo.GetMipCount();
+    m_SliceCount = std::max(textureInfo.GetArrayLength(), 1);
+    m_IsSrgb = gfx::detail::IsSrgbFormat(
+        static_cast<TypeFormat>(format & ((1 << TypeFormat_Bits) - 1)));
+
+    if (info.GetFilter() == MipFilter_Kaiser) {
+        // windowed sinc with a cutoff at the new nyquist, centered between two source texels
+        m_TapCount = KaiserTapCount;
+        float radius = static_cast<float>(m_TapCount) * 0.5f;
+        float alpha = info.GetKaiserAlpha();
+        float sum = 0.0f;
+        for (int idx = 0; idx < m_TapCount; ++idx) {
+            float distance = static_cast<float>(idx - m_TapCount / 2) + 0.5f;
+            float window = distance / radius;
+            m_Weights[idx] = CalculateSinc(distance * 0.5f) *
+                             CalculateBessel0(alpha * std::sqrt(1.0f - window * window)) /
+                             CalculateBessel0(alpha);
+            sum += m_Weights[idx];
+        }
+        for (int idx = 0; idx < m_TapCount; ++idx) {
+            m_Weights[idx] /= sum;
+        }
+    } else {
+        m_TapCount = 2;
+        m_Weights[0] = 0.5f;
+        m_Weights[1] = 0.5f;
+    }
+
+    if (m_IsSrgb) {
+        for (int idx = 0; idx < 256; ++idx) {
+            m_SrgbToLinear[idx] = ConvertFromSrgb(static_cast<float>(idx) / 255.0f);
+        }
+        for (int idx = 0; idx < 255; ++idx) {
+            m_SrgbThresholds[idx] = ConvertFromSrgb((static_cast<float>(idx) + 0.5f) / 255.0f);
+        }
+        for (int idx = 0; idx < SrgbEncodeTableSize; ++idx) {
+            float value = static_cast<float>(idx) / SrgbEncodeTableSize;
+            m_SrgbEncodeTable[idx] = static_cast<uint8_t>(
+                std::upper_bound(m_SrgbThresholds, m_SrgbThresholds + 255, value) -
+                m_SrgbThresholds);
+        }
+    }
+
+    m_pMipData = pMipData;
+    return true;
+}
+
+void MipChainGenerator::Finalize() {
+    m_pMipData = nullptr;
+    m_pMipOffsets = nullptr;
+}
+
+void MipChainGenerator::GetLevelLayout(LevelLayout* pOutLayout, int mipLevel,
+                                       int sliceIndex) const {
+    pOutLayout->width = std::max(m_Width >> mipLevel, 1);
+    pOutLayout->height = std::max(m_Height >> mipLevel, 1);
+    pOutLayout->rowSize = gfx::detail::CalculateRowSize(pOutLayout->width, m_ChannelFormat);
+
+    // array layers of a level are stored back to back, a 1d array keeps them as rows
+    ptrdiff_t sliceOffset = pOutLayout->rowSize * pOutLayout->height * sliceIndex;
+    pOutLayout->pData = nn::util::BytePtr(m_pMipData, m_pMipOffsets[mipLevel] + sliceOffset).Get();
+}
+
+uint8_t MipChainGenerator::EncodeSrgb(float value) const {
+    // also catches nan
+    if (!(value > 0.0f)) {
+        return 0;
+    }
+    if (value >= 1.0f) {
+        return 255;
+    }
+
+    // the table gives the code at the start of the step, the thresholds finish the rounding
+    int code = m_SrgbEncodeTable[static_cast<int>(value * SrgbEncodeTableSize)];
+    while (code < 255 && value >= m_SrgbThresholds[code]) {
+        ++code;
+    }
+    return static_cast<uint8_t>(code);
+}
+
+void MipChainGenerator::DecodeRow(float* pDst, const void* pSrc, int width) const {
+    int count = width * m_ChannelCount;
+
+    switch (m_ElementType) {
+    case ElementType_Unorm8: {
+        const uint8_t* pElements = static_cast<const uint8_t*>(pSrc);
+        if (m_IsSrgb) {
+            // alpha is the fourth channel of both rgba and bgra and stays linear
+            for (int idx = 0; idx < count; ++idx) {
+                pDst[idx] = (m_ChannelCount == 4 && (idx & 3) == 3) ?
+                                static_cast<float>(pElements[idx]) * (1.0f / 255.0f) :
+                                m_SrgbToLinear[pElements[idx]];
+            }
+        } else {
+            for (int idx = 0; idx < count; ++idx) {
+                pDst[idx] = static_cast<float>(pElements[idx]) * (1.0f / 255.0f);
+            }
+        }
+        break;
+    }
+    case ElementType_Unorm16: {
+        const uint16_t* pElements = static_cast<const uint16_t*>(pSrc);
+        for (int idx = 0; idx < count; ++idx) {
+            pDst[idx] = static_cast<float>(pElements[idx]) * (1.0f / 65535.0f);
+        }
+        break;
+    }
+    case ElementType_Float16: {
+        const uint16_t* pElements = static_cast<const uint16_t*>(pSrc);
+        for (int idx = 0; idx < count; ++idx) {
+            pDst[idx] = ConvertFromFloat16(pElements[idx]);
+        }
+        break;
+    }
+    case ElementType_Float32:
+        std::memcpy(pDst, pSrc, sizeof(float) * count);
+        break;
+    case ElementType_Unorm10_10_10_2: {
+        const uint32_t* pElements = static_cast<const uint32_t*>(pSrc);
+        for (int idx = 0; idx < width; ++idx) {
+            uint32_t value = pElements[idx];
+            pDst[idx * 4 + 0] = static_cast<float>(value & 0x3FF) * (1.0f / 1023.0f);
+            pDst[idx * 4 + 1] = static_cast<float>((value >> 10) & 0x3FF) * (1.0f / 1023.0f);
+            pDst[idx * 4 + 2] = static_cast<float>((value >> 20) & 0x3FF) * (1.0f / 1023.0f);
+            pDst[idx * 4 + 3] = static_cast<float>(value >> 30) * (1.0f / 3.0f);
+        }
+        break;
+    }
+    default:
+        NN_UNEXPECTED_DEFAULT;
+        break;
+    }
+}
+
+void MipChainGenerator::EncodeRow(void* pDst, const float* pSrc, int width) const {
+    int count = width * m_ChannelCount;
+
+    switch (m_ElementType) {
+    case ElementType_Unorm8: {
+        uint8_t* pElements = static_cast<uint8_t*>(pDst);
+        if (m_IsSrgb) {
+            for (int idx = 0; idx < count; ++idx) {
+                pElements[idx] = (m_ChannelCount == 4 && (idx & 3) == 3) ?
+                                     static_cast<uint8_t>(ConvertToUnorm(pSrc[idx], 255.0f)) :
+                                     EncodeSrgb(pSrc[idx]);
+            }
+        } else {
+            for (int idx = 0; idx < count; ++idx) {
+                pElements[idx] = static_cast<uint8_t>(ConvertToUnorm(pSrc[idx], 255.0f));
+            }
+        }
+        break;
+    }
+    case ElementType_Unorm16: {
+        uint16_t* pElements = static_cast<uint16_t*>(pDst);
+        for (int idx = 0; idx < count; ++idx) {
+            pElements[idx] = static_cast<uint16_t>(ConvertToUnorm(pSrc[idx], 65535.0f));
+        }
+        break;
+    }
+    case ElementType_Float16: {
+        uint16_t* pElements = static_cast<uint16_t*>(pDst);
+        for (int idx = 0; idx < count; ++idx) {
+            pElements[idx] = ConvertToFloat16(pSrc[idx]);
+        }
+        break;
+    }
+    case ElementType_Float32:
+        std::memcpy(pDst, pSrc, sizeof(float) * count);
+        break;
+    case ElementType_Unorm10_10_10_2: {
+        uint32_t* pElements = static_cast<uint32_t*>(pDst);
+        for (int idx = 0; idx < width; ++idx) {
+            pElements[idx] = ConvertToUnorm(pSrc[idx * 4 + 0], 1023.0f) |
+                             ConvertToUnorm(pSrc[idx * 4 + 1], 1023.0f) << 10 |
+                             ConvertToUnorm(pSrc[idx * 4 + 2], 1023.0f) << 20 |
+                             ConvertToUnorm(pSrc[idx * 4 + 3], 3.0f) << 30;
+        }
+        break;
+    }
+    default:
+        NN_UNEXPECTED_DEFAULT;
+        break;
+    }
+}
+
+void MipChainGenerator::FilterRow(float* pDst, const float* pSrc, int srcWidth,
+                                  int dstWidth) const {
+    int channelCount = m_ChannelCount;
+    int firstTap = 1 - m_TapCount / 2;
+
+    for (int x = 0; x < dstWidth; ++x) {
+        int first = x * 2 + firstTap;
+        bool isInterior = first >= 0 && first + m_TapCount <= srcWidth;
+        float* pOut = pDst + x * channelCount;
+        std::fill(pOut, pOut + channelCount, 0.0f);
+
+        for (int idxTap = 0; idxTap < m_TapCount; ++idxTap) {
+            // edges clamp, which also covers odd widths and the last 1 texel wide levels
+            int srcX = isInterior ? first + idxTap : std::clamp(first + idxTap, 0, srcWidth - 1);
+            const float* pIn = pSrc + srcX * channelCount;
+            float weight = m_Weights[idxTap];
+            for (int idxChannel = 0; idxChannel < channelCount; ++idxChannel) {
+                pOut[idxChannel] += weight * pIn[idxChannel];
+            }
+        }
+    }
+}
+
+void MipChainGenerator::FilterRows(const LevelLayout& src, const LevelLayout& dst, int beginRow,
+                                   int endRow, void* pWorkMemory) const {
+    size_t rowCount = m_ChannelCount * static_cast<size_t>(std::max(m_Width / 2, 1));
+    nn::util::BytePtr ptr(pWorkMemory);
+    float* pDecodedRow = ptr.Get<float>();
+    float* pFilteredRows = ptr.Advance(sizeof(float) * m_ChannelCount * m_Width).Get<float>();
+    float* pResultRow = ptr.Advance(sizeof(float) * rowCount * m_TapCount).Get<float>();
+    int firstTap = 1 - m_TapCount / 2;
+
+    // the rows under the kernel form a sliding window, so a source row keeps the slot
+    // row % tapCount until the window has moved past it
+    int slotRows[MaxTapCount];
+    std::fill(slotRows, slotRows + MaxTapCount, -1);
+    int count = dst.width * m_ChannelCount;
+
+    for (int y = beginRow; y < endRow; ++y) {
+        for (int idxTap = 0; idxTap < m_TapCount; ++idxTap) {
+            int srcY = std::clamp(y * 2 + firstTap + idxTap, 0, src.height - 1);
+            int slot = srcY % m_TapCount;
+            if (slotRows[slot] != srcY) {
+                DecodeRow(pDecodedRow, nn::util::ConstBytePtr(src.pData, src.rowSize * srcY).Get(),
+                          src.width);
+                FilterRow(pFilteredRows + rowCount * slot, pDecodedRow, src.width, dst.width);
+                slotRows[slot] = srcY;
+            }
+        }
+
+        std::fill(pResultRow, pResultRow + count, 0.0f);
+        for (int idxTap = 0; idxTap < m_TapCount; ++idxTap) {
+            int srcY = std::clamp(y * 2 + firstTap + idxTap, 0, src.height - 1);
+            const float* pRow = pFilteredRows + rowCount * (srcY % m_TapCount);
+            float weight = m_Weights[idxTap];
+            for (int idx = 0; idx < count; ++idx) {
+                pResultRow[idx] += weight * pRow[idx];
+            }
+        }
+
+        EncodeRow(nn::util::BytePtr(dst.pData, dst.rowSize * y).Get(), pResultRow, dst.width);
+    }
+}
+
+bool MipChainGenerator::GenerateSlice(int sliceIndex, void* pWorkMemory,
+                                      size_t workMemorySize) const {
+    for (int mipLevel = 1; mipLevel < m_MipCount; ++mipLevel) {
+        if (!GenerateRows(sliceIndex, mipLevel, 0, GetLevelHeight(mipLevel), pWorkMemory,
+                          workMemorySize)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool MipChainGenerator::GenerateRows(int sliceIndex, int mipLevel, int beginRow, int endRow,
+                                     void* pWorkMemory, size_t workMemorySize) const {
+    if (sliceIndex < 0 || sliceIndex >= m_SliceCount || mipLevel < 1 || mipLevel >= m_MipCount ||
+        beginRow < 0 || endRow > GetLevelHeight(mipLevel) || beginRow > endRow) {
+        return false;
+    }
+
+    size_t rowCount = m_ChannelCount * static_cast<size_t>(std::max(m_Width / 2, 1));
+    if (workMemorySize < sizeof(float) * (m_ChannelCount * m_Width + rowCount * (m_TapCount + 1))) {
+        return false;
+    }
+
+    LevelLayout src;
+    LevelLayout dst;
+    GetLevelLayout(&src, mipLevel - 1, sliceIndex);
+    GetLevelLayout(&dst, mipLevel, sliceIndex);
+    FilterRows(src, dst, beginRow, endRow, pWorkMemory);
+    return true;
+}
+
+void MipChainGenerator::GenerateAll(void* pWorkMemory, size_t workMemorySize) const {
+    for (int idx = 0; idx < m_SliceCount; ++idx) {
+        GenerateSlice(idx, pWorkMemory, workMemorySize);
+    }
+}
+
+}  // namespace nn::gfx::util
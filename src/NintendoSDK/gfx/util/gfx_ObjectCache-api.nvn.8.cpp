@@ -0,0 +1,356 @@
+#include <nn/gfx/util/gfx_ObjectCache.h>
+
+#include <nn/gfx/detail/gfx_DescriptorPool-api.nvn.8.h>
+#include <nn/gfx/detail/gfx_Device-api.nvn.8.h>
+#include <nn/gfx/detail/gfx_Sampler-api.nvn.8.h>
+#include <nn/gfx/detail/gfx_Texture-api.nvn.8.h>
+#include <nn/gfx/gfx_DescriptorSlot.h>
+#include <nn/gfx/gfx_SamplerInfo.h>
+#include <nn/gfx/gfx_TextureInfo.h>
+#include <nn/util/util_BytePtr.h>
+
+#include <cstring>
+#include <new>
+
+namespace nn::gfx::util {
+
+namespace detail {
+
+int ObjectCacheIndex::CalculateBucketCount(int maxEntryCount) {
+    // keep the load factor at or below one half so probe sequences stay short
+    int bucketCount = 8;
+    while (bucketCount < maxEntryCount * 2) {
+        bucketCount <<= 1;
+    }
+    return bucketCount;
+}
+
+ObjectCacheIndex::ObjectCacheIndex() : m_pBuckets(nullptr), m_pHashes(nullptr), m_BucketMask(0) {}
+
+void ObjectCacheIndex::Initialize(int32_t* pBuckets, uint32_t* pHashes, int bucketCount) {
+    m_pBuckets = pBuckets;
+    m_pHashes = pHashes;
+    m_BucketMask = bucketCount - 1;
+    Clear();
+}
+
+void ObjectCacheIndex::Clear() {
+    for (int idx = 0; idx <= m_BucketMask; ++idx) {
+        m_pBuckets[idx] = Bucket_Empty;
+        m_pHashes[idx] = 0;
+    }
+}
+
+void ObjectCacheIndex::Insert(uint32_t hash, int entryIndex) {
+    int idx = hash & m_BucketMask;
+    while (m_pBuckets[idx] >= 0) {
+        idx = (idx + 1) & m_BucketMask;
+    }
+    m_pBuckets[idx] = entryIndex;
+    m_pHashes[idx] = hash;
+}
+
+void ObjectCacheIndex::Remove(uint32_t hash, int entryIndex) {
+    for (int idx = hash & m_BucketMask, probe = 0; probe <= m_BucketMask;
+         idx = (idx + 1) & m_BucketMask, ++probe) {
+        if (m_pBuckets[idx] == Bucket_Empty) {
+            return;
+        }
+        if (m_pBuckets[idx] == entryIndex) {
+            // a removed bucket still has to be probed through, unless nothing follows it
+            m_pBuckets[idx] =
+                (m_pBuckets[(idx + 1) & m_BucketMask] == Bucket_Empty) ? Bucket_Empty :
+                                                                         Bucket_Removed;
+            return;
+        }
+    }
+}
+
+uint32_t CalculateObjectCacheHash(const void* pData, size_t size) {
+    // FNV-1a
+    const uint8_t* pBytes = static_cast<const uint8_t*>(pData);
+    uint32_t hash = 2166136261u;
+    for (size_t idx = 0; idx < size; ++idx) {
+        hash ^= pBytes[idx];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+}  // namespace detail
+
+namespace {
+
+template <typename TEntry>
+size_t CalculateCacheMemorySize(int maxEntryCount) {
+    int bucketCount = detail::ObjectCacheIndex::CalculateBucketCount(maxEntryCount);
+    return sizeof(TEntry) * maxEntryCount + (sizeof(int32_t) + sizeof(uint32_t)) * bucketCount;
+}
+
+template <typename TEntry>
+TEntry* SetupCacheMemory(detail::ObjectCacheIndex* pIndex, int maxEntryCount, void* pMemory) {
+    int bucketCount = detail::ObjectCacheIndex::CalculateBucketCount(maxEntryCount);
+
+    nn::util::BytePtr ptr(pMemory);
+    TEntry* pEntries = ptr.Get<TEntry>();
+    int32_t* pBuckets = ptr.Advance(sizeof(TEntry) * maxEntryCount).Get<int32_t>();
+    uint32_t* pHashes = ptr.Advance(sizeof(int32_t) * bucketCount).Get<uint32_t>();
+
+    for (int idxEntry = 0; idxEntry < maxEntryCount; ++idxEntry) {
+        new (&pEntries[idxEntry]) TEntry();
+        pEntries[idxEntry].refCount = 0;
+        pEntries[idxEntry].nextFreeIndex =
+            (idxEntry + 1 < maxEntryCount) ? idxEntry + 1 : detail::ObjectCacheIndex::InvalidIndex;
+    }
+
+    pIndex->Initialize(pBuckets, pHashes, bucketCount);
+    return pEntries;
+}
+
+SamplerInfoData MakeSamplerKey(const SamplerInfo& info) {
+    // reserved bytes are left to the caller and must not take part in the comparison
+    SamplerInfoData key;
+    std::memset(&key, 0, sizeof(key));
+    key.addressU = info.GetAddressU();
+    key.addressV = info.GetAddressV();
+    key.addressW = info.GetAddressW();
+    key.comparisonFunction = info.GetComparisonFunction();
+    key.borderColorType = info.GetBorderColorType();
+    key.maxAnisotropy = info.GetMaxAnisotropy();
+    key.filterMode = info.GetFilterMode();
+    key.minLod = info.GetMinLod();
+    key.maxLod = info.GetMaxLod();
+    key.lodBias = info.GetLodBias();
+    return key;
+}
+
+TextureViewInfoData MakeTextureViewKey(const TextureViewInfo& info) {
+    const TextureViewInfoData& data = info.ToData();
+    const TextureSubresourceRangeData& range = data.subresourceRange;
+
+    TextureViewInfoData key;
+    std::memset(&key, 0, sizeof(key));
+    key.imageDimension = data.imageDimension;
+    key.depthStencilTextureMode = data.depthStencilTextureMode;
+    key.imageFormat = data.imageFormat;
+    std::memcpy(key.channelMapping, data.channelMapping, sizeof(key.channelMapping));
+    key.subresourceRange.mipRange.minMipLevel = range.mipRange.minMipLevel;
+    key.subresourceRange.mipRange.mipCount = range.mipRange.mipCount;
+    key.subresourceRange.arrayRange.baseArrayIndex = range.arrayRange.baseArrayIndex;
+    key.subresourceRange.arrayRange.arrayLength = range.arrayRange.arrayLength;
+    key.pTexture = data.pTexture;
+    return key;
+}
+
+}  // namespace
+
+struct SamplerCache::Entry {
+    SamplerInfoData key;
+    uint32_t hash;
+    int refCount;
+    int nextFreeIndex;
+    SamplerType sampler;
+};
+
+size_t SamplerCache::CalculateMemorySize(int maxEntryCount) {
+    return CalculateCacheMemorySize<Entry>(maxEntryCount);
+}
+
+size_t SamplerCache::GetMemoryAlignment() {
+    return alignof(Entry);
+}
+
+SamplerCache::SamplerCache()
+    : m_pDevice(nullptr), m_pDescriptorPool(nullptr), m_pEntries(nullptr), m_BaseSlotIndex(0),
+      m_MaxEntryCount(0), m_EntryCount(0), m_FreeEntryIndex(detail::ObjectCacheIndex::InvalidIndex) {
+}
+
+SamplerCache::~SamplerCache() {}
+
+void SamplerCache::Initialize(DeviceType* pDevice, DescriptorPoolType* pSamplerDescriptorPool,
+                              int baseSlotIndex, int maxEntryCount, void* pMemory,
+                              [[maybe_unused]] size_t memorySize) {
+    m_pDevice = pDevice;
+    m_pDescriptorPool = pSamplerDescriptorPool;
+    m_BaseSlotIndex = baseSlotIndex;
+    m_MaxEntryCount = maxEntryCount;
+    m_EntryCount = 0;
+    m_pEntries = SetupCacheMemory<Entry>(&m_Index, maxEntryCount, pMemory);
+    m_FreeEntryIndex = (maxEntryCount > 0) ? 0 : detail::ObjectCacheIndex::InvalidIndex;
+}
+
+void SamplerCache::Finalize() {
+    for (int idxEntry = 0; idxEntry < m_MaxEntryCount; ++idxEntry) {
+        Entry& entry = m_pEntries[idxEntry];
+        if (entry.refCount > 0) {
+            entry.sampler.Finalize(m_pDevice);
+        }
+        entry.~Entry();
+    }
+
+    m_pEntries = nullptr;
+    m_MaxEntryCount = 0;
+    m_EntryCount = 0;
+    m_FreeEntryIndex = detail::ObjectCacheIndex::InvalidIndex;
+}
+
+const SamplerCache::SamplerType* SamplerCache::Acquire(DescriptorSlot* pOutDescriptorSlot,
+                                                       const SamplerInfo& info) {
+    SamplerInfoData key = MakeSamplerKey(info);
+    uint32_t hash = detail::CalculateObjectCacheHash(&key, sizeof(key));
+
+    int entryIndex = m_Index.Find(hash, [&](int idx) {
+        return std::memcmp(&m_pEntries[idx].key, &key, sizeof(key)) == 0;
+    });
+
+    if (entryIndex == detail::ObjectCacheIndex::InvalidIndex) {
+        if (m_FreeEntryIndex == detail::ObjectCacheIndex::InvalidIndex) {
+            return nullptr;
+        }
+
+        entryIndex = m_FreeEntryIndex;
+        Entry& entry = m_pEntries[entryIndex];
+        m_FreeEntryIndex = entry.nextFreeIndex;
+
+        entry.key = key;
+        entry.hash = hash;
+        entry.refCount = 0;
+        entry.sampler.Initialize(m_pDevice, info);
+        m_pDescriptorPool->SetSampler(m_BaseSlotIndex + entryIndex, &entry.sampler);
+
+        m_Index.Insert(hash, entryIndex);
+        ++m_EntryCount;
+    }
+
+    Entry& entry = m_pEntries[entryIndex];
+    ++entry.refCount;
+
+    if (pOutDescriptorSlot) {
+        m_pDescriptorPool->GetDescriptorSlot(pOutDescriptorSlot, m_BaseSlotIndex + entryIndex);
+    }
+
+    return &entry.sampler;
+}
+
+void SamplerCache::Release(const SamplerType* pSampler) {
+    Entry* pEntry = reinterpret_cast<Entry*>(nn::util::BytePtr(const_cast<SamplerType*>(pSampler))
+                                                 .Advance(-offsetof(Entry, sampler))
+                                                 .Get());
+    if (--pEntry->refCount > 0) {
+        return;
+    }
+
+    int entryIndex = static_cast<int>(pEntry - m_pEntries);
+    m_Index.Remove(pEntry->hash, entryIndex);
+    pEntry->sampler.Finalize(m_pDevice);
+    pEntry->nextFreeIndex = m_FreeEntryIndex;
+    m_FreeEntryIndex = entryIndex;
+    --m_EntryCount;
+}
+
+struct TextureViewCache::Entry {
+    TextureViewInfoData key;
+    uint32_t hash;
+    int refCount;
+    int nextFreeIndex;
+    TextureViewType textureView;
+};
+
+size_t TextureViewCache::CalculateMemorySize(int maxEntryCount) {
+    return CalculateCacheMemorySize<Entry>(maxEntryCount);
+}
+
+size_t TextureViewCache::GetMemoryAlignment() {
+    return alignof(Entry);
+}
+
+TextureViewCache::TextureViewCache()
+    : m_pDevice(nullptr), m_pDescriptorPool(nullptr), m_pEntries(nullptr), m_BaseSlotIndex(0),
+      m_MaxEntryCount(0), m_EntryCount(0), m_FreeEntryIndex(detail::ObjectCacheIndex::InvalidIndex) {
+}
+
+TextureViewCache::~TextureViewCache() {}
+
+void TextureViewCache::Initialize(DeviceType* pDevice, DescriptorPoolType* pTextureDescriptorPool,
+                                  int baseSlotIndex, int maxEntryCount, void* pMemory,
+                                  [[maybe_unused]] size_t memorySize) {
+    m_pDevice = pDevice;
+    m_pDescriptorPool = pTextureDescriptorPool;
+    m_BaseSlotIndex = baseSlotIndex;
+    m_MaxEntryCount = maxEntryCount;
+    m_EntryCount = 0;
+    m_pEntries = SetupCacheMemory<Entry>(&m_Index, maxEntryCount, pMemory);
+    m_FreeEntryIndex = (maxEntryCount > 0) ? 0 : detail::ObjectCacheIndex::InvalidIndex;
+}
+
+void TextureViewCache::Finalize() {
+    for (int idxEntry = 0; idxEntry < m_MaxEntryCount; ++idxEntry) {
+        Entry& entry = m_pEntries[idxEntry];
+        if (entry.refCount > 0) {
+            entry.textureView.Finalize(m_pDevice);
+        }
+        entry.~Entry();
+    }
+
+    m_pEntries = nullptr;
+    m_MaxEntryCount = 0;
+    m_EntryCount = 0;
+    m_FreeEntryIndex = detail::ObjectCacheIndex::InvalidIndex;
+}
+
+const TextureViewCache::TextureViewType*
+TextureViewCache::Acquire(DescriptorSlot* pOutDescriptorSlot, const TextureViewInfo& info) {
+    TextureViewInfoData key = MakeTextureViewKey(info);
+    uint32_t hash = detail::CalculateObjectCacheHash(&key, sizeof(key));
+
+    int entryIndex = m_Index.Find(hash, [&](int idx) {
+        return std::memcmp(&m_pEntries[idx].key, &key, sizeof(key)) == 0;
+    });
+
+    if (entryIndex == detail::ObjectCacheIndex::InvalidIndex) {
+        if (m_FreeEntryIndex == detail::ObjectCacheIndex::InvalidIndex) {
+            return nullptr;
+        }
+
+        entryIndex = m_FreeEntryIndex;
+        Entry& entry = m_pEntries[entryIndex];
+        m_FreeEntryIndex = entry.nextFreeIndex;
+
+        entry.key = key;
+        entry.hash = hash;
+        entry.refCount = 0;
+        entry.textureView.Initialize(m_pDevice, gfx::DataToAccessor(entry.key));
+        m_pDescriptorPool->SetTextureView(m_BaseSlotIndex + entryIndex, &entry.textureView);
+
+        m_Index.Insert(hash, entryIndex);
+        ++m_EntryCount;
+    }
+
+    Entry& entry = m_pEntries[entryIndex];
+    ++entry.refCount;
+
+    if (pOutDescriptorSlot) {
+        m_pDescriptorPool->GetDescriptorSlot(pOutDescriptorSlot, m_BaseSlotIndex + entryIndex);
+    }
+
+    return &entry.textureView;
+}
+
+void TextureViewCache::Release(const TextureViewType* pTextureView) {
+    Entry* pEntry =
+        reinterpret_cast<Entry*>(nn::util::BytePtr(const_cast<TextureViewType*>(pTextureView))
+                                     .Advance(-offsetof(Entry, textureView))
+                                     .Get());
+    if (--pEntry->refCount > 0) {
+        return;
+    }
+
+    int entryIndex = static_cast<int>(pEntry - m_pEntries);
+    m_Index.Remove(pEntry->hash, entryIndex);
+    pEntry->textureView.Finalize(m_pDevice);
+    pEntry->nextFreeIndex = m_FreeEntryIndex;
+    m_FreeEntryIndex = entryIndex;
+    --m_EntryCount;
+}
+
+}  // namespace nn::gfx::util
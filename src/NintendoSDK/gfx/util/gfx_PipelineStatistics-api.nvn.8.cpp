@@ -0,0 +1,293 @@
+#include <nn/gfx/util/gfx_PipelineStatistics.h>
+
+#include <nn/gfx/detail/gfx_CommandBuffer-api.nvn.8.h>
+#include <nn/gfx/gfx_GpuAddress.h>
+#include <nn/util/util_BytePtr.h>
+
+#include <cstring>
+
+#include "../detail/gfx_NvnHelper.h"
+
+namespace nn::gfx::util {
+
+namespace {
+
+// every target except QueryTarget_Timestamp is snapshotted per pass
+const int CounterCount = QueryTarget_End - QueryTarget_SamplesPassed;
+
+uint64_t PipelineStatistics::* const g_CounterTable[QueryTarget_End] = {
+    nullptr,
+    &PipelineStatistics::samplesPassed,
+    &PipelineStatistics::inputVertices,
+    &PipelineStatistics::inputPrimitives,
+    &PipelineStatistics::vertexShaderInvocations,
+    &PipelineStatistics::geometryShaderInvocations,
+    &PipelineStatistics::geometryShaderPrimitives,
+    &PipelineStatistics::clippingInputPrimitives,
+    &PipelineStatistics::clippingOutputPrimitives,
+    &PipelineStatistics::pixelShaderInvocations,
+    &PipelineStatistics::hullShaderInvocations,
+    &PipelineStatistics::domainShaderInvocations,
+    &PipelineStatistics::computeShaderInvocations,
+};
+
+float CalculateRatio(uint64_t numerator, uint64_t denominator) {
+    return denominator > 0 ? static_cast<float>(static_cast<double>(numerator) / denominator)
+                           : 0.0f;
+}
+
+}  // namespace
+
+void PipelineStatistics::Clear() {
+    std::memset(this, 0, sizeof(*this));
+}
+
+uint64_t PipelineStatistics::Get(QueryTarget target) const {
+    return target > QueryTarget_Timestamp && target < QueryTarget_End ?
+               this->*g_CounterTable[target] :
+               0;
+}
+
+void PipelineStatistics::Set(QueryTarget target, uint64_t value) {
+    if (target > QueryTarget_Timestamp && target < QueryTarget_End) {
+        this->*g_CounterTable[target] = value;
+    }
+}
+
+float PipelineStatistics::GetOverdraw(int renderTargetPixelCount) const {
+    return CalculateRatio(pixelShaderInvocations, renderTargetPixelCount);
+}
+
+float PipelineStatistics::GetPixelRejectRatio() const {
+    if (pixelShaderInvocations <= samplesPassed) {
+        return 0.0f;
+    }
+    return CalculateRatio(pixelShaderInvocations - samplesPassed, pixelShaderInvocations);
+}
+
+float PipelineStatistics::GetCullingEfficiency() const {
+    // clipping can split primitives, so more can leave the clipper than entered the pipeline
+    if (clippingOutputPrimitives >= inputPrimitives) {
+        return 0.0f;
+    }
+    return CalculateRatio(inputPrimitives - clippingOutputPrimitives, inputPrimitives);
+}
+
+struct PipelineStatisticsCollector::PassRecord {
+    const char* pName;
+    PipelineStatistics statistics;
+};
+
+struct PipelineStatisticsCollector::FrameRecord {
+    enum State { State_Free, State_Recording, State_Recorded };
+
+    int state;
+    int passCount;
+    uint64_t frameNumber;
+};
+
+bool PipelineStatisticsCollector::IsSupported(QueryTarget target) {
+    return target > QueryTarget_Timestamp && target < QueryTarget_ComputeShaderInvocations;
+}
+
+size_t PipelineStatisticsCollector::CalculateQueryBufferSize(const InfoType& info) {
+    return detail::QueryBufferRing::CalculateBufferSize(
+        info.GetMaxPassCount() * CounterCount + 1, info.GetBufferedFrameCount());
+}
+
+size_t PipelineStatisticsCollector::GetQueryBufferAlignment() {
+    return detail::QueryBufferRing::GetBufferAlignment();
+}
+
+size_t PipelineStatisticsCollector::CalculateMemorySize(const InfoType& info) {
+    return sizeof(FrameRecord) * info.GetBufferedFrameCount() +
+           sizeof(PassRecord) * info.GetMaxPassCount() * (info.GetBufferedFrameCount() + 1);
+}
+
+size_t PipelineStatisticsCollector::GetMemoryAlignment() {
+    return alignof(uint64_t);
+}
+
+PipelineStatisticsCollector::PipelineStatisticsCollector()
+    : m_pFrames(nullptr), m_pPasses(nullptr), m_pResultPasses(nullptr), m_MaxPassCount(0),
+      m_BufferedFrameCount(0), m_CurrentFrameIndex(-1), m_CurrentPassIndex(InvalidPassIndex),
+      m_ResultPassCount(0), m_DroppedFrameCount(0), m_ResultFrameNumber(0) {
+    m_TotalStatistics.Clear();
+}
+
+PipelineStatisticsCollector::~PipelineStatisticsCollector() {}
+
+void PipelineStatisticsCollector::Initialize(const InfoType& info, BufferType* pQueryBuffer,
+                                             ptrdiff_t queryBufferOffset, void* pMemory,
+                                             [[maybe_unused]] size_t memorySize) {
+    m_MaxPassCount = info.GetMaxPassCount();
+    m_BufferedFrameCount = info.GetBufferedFrameCount();
+    m_QueryRing.Initialize(pQueryBuffer, queryBufferOffset, m_MaxPassCount * CounterCount + 1,
+                           m_BufferedFrameCount);
+
+    nn::util::BytePtr ptr(pMemory);
+    m_pFrames = ptr.Get<FrameRecord>();
+    m_pPasses = ptr.Advance(sizeof(FrameRecord) * m_BufferedFrameCount).Get<PassRecord>();
+    m_pResultPasses =
+        ptr.Advance(sizeof(PassRecord) * m_MaxPassCount * m_BufferedFrameCount).Get<PassRecord>();
+
+    for (int idxFrame = 0; idxFrame < m_BufferedFrameCount; ++idxFrame) {
+        m_pFrames[idxFrame].state = FrameRecord::State_Free;
+        m_pFrames[idxFrame].passCount = 0;
+        m_pFrames[idxFrame].frameNumber = 0;
+    }
+
+    m_TotalStatistics.Clear();
+    m_CurrentFrameIndex = -1;
+    m_CurrentPassIndex = InvalidPassIndex;
+    m_ResultPassCount = 0;
+    m_DroppedFrameCount = 0;
+    m_ResultFrameNumber = 0;
+}
+
+void PipelineStatisticsCollector::Finalize() {
+    m_QueryRing.Finalize();
+    m_pFrames = nullptr;
+    m_pPasses = nullptr;
+    m_pResultPasses = nullptr;
+}
+
+void PipelineStatisticsCollector::BeginFrame() {
+    Resolve();
+
+    m_CurrentPassIndex = InvalidPassIndex;
+    m_CurrentFrameIndex = m_QueryRing.GetNextSliceIndex();
+    FrameRecord& frame = m_pFrames[m_CurrentFrameIndex];
+
+    if (frame.state == FrameRecord::State_Recorded) {
+        // the GPU may still write the slice, so this frame goes unmeasured
+        ++m_DroppedFrameCount;
+        m_CurrentFrameIndex = -1;
+        return;
+    }
+
+    m_QueryRing.ClearSlice(m_CurrentFrameIndex);
+    frame.state = FrameRecord::State_Recording;
+    frame.passCount = 0;
+    frame.frameNumber = m_QueryRing.AdvanceFrame();
+}
+
+void PipelineStatisticsCollector::EndFrame(CommandBufferType* pCommandBuffer) {
+    if (m_CurrentPassIndex != InvalidPassIndex) {
+        EndPass(pCommandBuffer);
+    }
+    if (m_CurrentFrameIndex < 0) {
+        return;
+    }
+
+    GpuAddress address;
+    m_QueryRing.GetReportAddress(&address, m_CurrentFrameIndex, GetFenceReportIndex());
+    pCommandBuffer->WriteTimestamp(address);
+
+    m_pFrames[m_CurrentFrameIndex].state = FrameRecord::State_Recorded;
+    m_CurrentFrameIndex = -1;
+}
+
+void PipelineStatisticsCollector::BeginPass(CommandBufferType* pCommandBuffer,
+                                            const char* pName) {
+    // counters are reset at the start of a pass, so passes cannot nest
+    if (m_CurrentFrameIndex < 0 || m_CurrentPassIndex != InvalidPassIndex) {
+        return;
+    }
+
+    FrameRecord& frame = m_pFrames[m_CurrentFrameIndex];
+    if (frame.passCount >= m_MaxPassCount) {
+        return;
+    }
+
+    m_CurrentPassIndex = frame.passCount++;
+    m_pPasses[m_CurrentFrameIndex * m_MaxPassCount + m_CurrentPassIndex].pName = pName;
+
+    for (int target = QueryTarget_SamplesPassed; target < QueryTarget_End; ++target) {
+        pCommandBuffer->BeginQuery(static_cast<QueryTarget>(target));
+    }
+}
+
+void PipelineStatisticsCollector::EndPass(CommandBufferType* pCommandBuffer) {
+    if (m_CurrentPassIndex == InvalidPassIndex) {
+        return;
+    }
+
+    int baseReportIndex = m_CurrentPassIndex * CounterCount;
+    for (int target = QueryTarget_SamplesPassed; target < QueryTarget_End; ++target) {
+        GpuAddress address;
+        m_QueryRing.GetReportAddress(&address, m_CurrentFrameIndex,
+                                     baseReportIndex + target - QueryTarget_SamplesPassed);
+        pCommandBuffer->EndQuery(address, static_cast<QueryTarget>(target));
+    }
+
+    m_CurrentPassIndex = InvalidPassIndex;
+}
+
+bool PipelineStatisticsCollector::Resolve() {
+    bool isResolved = false;
+    for (int idx = 0; idx < m_BufferedFrameCount; ++idx) {
+        int idxFrame = m_QueryRing.GetOrderedSliceIndex(idx);
+        if (m_pFrames[idxFrame].state == FrameRecord::State_Recorded) {
+            isResolved |= TryResolveFrame(idxFrame);
+        }
+    }
+    return isResolved;
+}
+
+const char* PipelineStatisticsCollector::GetPassName(int index) const {
+    return m_pResultPasses[index].pName;
+}
+
+const PipelineStatistics& PipelineStatisticsCollector::GetPassStatistics(int index) const {
+    return m_pResultPasses[index].statistics;
+}
+
+int PipelineStatisticsCollector::FindPassIndex(const char* pName) const {
+    for (int idxPass = 0; idxPass < m_ResultPassCount; ++idxPass) {
+        const char* pPassName = m_pResultPasses[idxPass].pName;
+        if (pPassName == pName || std::strcmp(pPassName, pName) == 0) {
+            return idxPass;
+        }
+    }
+    return InvalidPassIndex;
+}
+
+bool PipelineStatisticsCollector::TryResolveFrame(int frameIndex) {
+    FrameRecord& frame = m_pFrames[frameIndex];
+
+    if (!m_QueryRing.IsReportWritten(frameIndex, GetFenceReportIndex())) {
+        return false;
+    }
+
+    // a newer frame may already have been resolved out of order
+    if (m_ResultPassCount > 0 && frame.frameNumber < m_ResultFrameNumber) {
+        frame.state = FrameRecord::State_Free;
+        return true;
+    }
+
+    m_TotalStatistics.Clear();
+    for (int idxPass = 0; idxPass < frame.passCount; ++idxPass) {
+        PassRecord& result = m_pResultPasses[idxPass];
+        result.pName = m_pPasses[frameIndex * m_MaxPassCount + idxPass].pName;
+
+        for (int target = QueryTarget_SamplesPassed; target < QueryTarget_End; ++target) {
+            auto pReport = static_cast<const NVNcounterData*>(m_QueryRing.GetReport(
+                frameIndex, idxPass * CounterCount + target - QueryTarget_SamplesPassed));
+            result.statistics.Set(static_cast<QueryTarget>(target), pReport->counter);
+            m_TotalStatistics.*g_CounterTable[target] += pReport->counter;
+        }
+    }
+
+    m_ResultPassCount = frame.passCount;
+    m_ResultFrameNumber = frame.frameNumber;
+    frame.state = FrameRecord::State_Free;
+    return true;
+}
+
+int PipelineStatisticsCollector::GetFenceReportIndex() const {
+    // the fence follows the reports of every pass
+    return m_MaxPassCount * CounterCount;
+}
+
+}  // namespace nn::gfx::util
@@ -4,11 +4,155 @@
 #include <nn/util/MathTypes.h>
 #include <nn/util/util_Arithmetic.h>
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
 // todo: most of these functions are still non-matching
 // matching should be done using odyssey 1.2 as a base
 
 namespace nn::gfx::util {
 
+namespace {
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmissing-braces"
+const nn::util::Float3 CubeVertexPos[8] = {
+    {1.0f, 1.0f, -1.0f}, {1.0f, -1.0f, -1.0f}, {-1.0f, -1.0f, -1.0f}, {-1.0f, 1.0f, -1.0f},
+    {1.0f, 1.0f, 1.0f},  {1.0f, -1.0f, 1.0f},  {-1.0f, -1.0f, 1.0f},  {-1.0f, 1.0f, 1.0f},
+};
+#pragma GCC diagnostic pop
+
+const uint32_t CubeFaceTable[6][4] = {
+    {0, 1, 2, 3}, {3, 2, 6, 7}, {7, 6, 5, 4}, {4, 5, 1, 0}, {1, 5, 6, 2}, {4, 0, 3, 7},
+};
+
+const uint32_t CubeEdgeTable[12][2] = {
+    {0, 1}, {1, 2}, {2, 3}, {3, 0}, {4, 5}, {5, 6}, {6, 7}, {7, 4}, {0, 4}, {1, 5}, {2, 6}, {3, 7},
+};
+
+uint16_t ConvertToFloat16(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+
+    uint32_t sign = (bits >> 16) & 0x8000;
+    int exponent = static_cast<int>((bits >> 23) & 0xFF) - 127 + 15;
+    uint32_t mantissa = bits & 0x7FFFFF;
+
+    if (exponent <= 0) {
+        // too small for a normal half, flush to signed zero
+        return static_cast<uint16_t>(sign);
+    }
+    if (exponent >= 31) {
+        return static_cast<uint16_t>(sign | 0x7C00);
+    }
+
+    // round to nearest, a mantissa carry correctly bumps the exponent
+    uint32_t half = sign | (exponent << 10) | (mantissa >> 13);
+    if (mantissa & 0x1000) {
+        ++half;
+    }
+    return static_cast<uint16_t>(half);
+}
+
+int32_t ConvertToSnorm(float value, int bitCount) {
+    float scale = static_cast<float>((1 << (bitCount - 1)) - 1);
+    float clamped = std::min(std::max(value, -1.0f), 1.0f);
+    return static_cast<int32_t>(clamped * scale + (clamped >= 0.0f ? 0.5f : -0.5f));
+}
+
+uint16_t ConvertToUnorm16(float value) {
+    float clamped = std::min(std::max(value, 0.0f), 1.0f);
+    return static_cast<uint16_t>(clamped * 65535.0f + 0.5f);
+}
+
+template <typename T>
+uint8_t* WriteElement(uint8_t* pDst, T value) {
+    std::memcpy(pDst, &value, sizeof(T));
+    return pDst + sizeof(T);
+}
+
+void* WriteVertex(void* pVertexBuffer, PrimitiveShapeFormat vertexFormat, float x, float y,
+                  float z, float normalX, float normalY, float normalZ, float u, float v) {
+    uint8_t* pDst = static_cast<uint8_t*>(pVertexBuffer);
+
+    if (vertexFormat & PrimitiveShapeFormat_Pos) {
+        if (vertexFormat & PrimitiveShapeFormat_PosFloat16) {
+            pDst = WriteElement(pDst, ConvertToFloat16(x));
+            pDst = WriteElement(pDst, ConvertToFloat16(y));
+            pDst = WriteElement(pDst, ConvertToFloat16(z));
+            pDst = WriteElement(pDst, ConvertToFloat16(1.0f));
+        } else {
+            pDst = WriteElement(pDst, x);
+            pDst = WriteElement(pDst, y);
+            pDst = WriteElement(pDst, z);
+        }
+    }
+
+    if (vertexFormat & PrimitiveShapeFormat_Normal) {
+        if (vertexFormat & PrimitiveShapeFormat_NormalOctahedral) {
+            float length = std::abs(normalX) + std::abs(normalY) + std::abs(normalZ);
+            float octX = length > 0.0f ? normalX / length : 0.0f;
+            float octY = length > 0.0f ? normalY / length : 0.0f;
+            if (normalZ < 0.0f) {
+                float foldX = (1.0f - std::abs(octY)) * (octX >= 0.0f ? 1.0f : -1.0f);
+                float foldY = (1.0f - std::abs(octX)) * (octY >= 0.0f ? 1.0f : -1.0f);
+                octX = foldX;
+                octY = foldY;
+            }
+            pDst = WriteElement(pDst, static_cast<int16_t>(ConvertToSnorm(octX, 16)));
+            pDst = WriteElement(pDst, static_cast<int16_t>(ConvertToSnorm(octY, 16)));
+        } else if (vertexFormat & PrimitiveShapeFormat_NormalSnorm10) {
+            uint32_t packed = (ConvertToSnorm(normalX, 10) & 0x3FF) |
+                              ((ConvertToSnorm(normalY, 10) & 0x3FF) << 10) |
+                              ((ConvertToSnorm(normalZ, 10) & 0x3FF) << 20);
+            pDst = WriteElement(pDst, packed);
+        } else {
+            pDst = WriteElement(pDst, normalX);
+            pDst = WriteElement(pDst, normalY);
+            pDst = WriteElement(pDst, normalZ);
+        }
+    }
+
+    if (vertexFormat & PrimitiveShapeFormat_Uv) {
+        if (vertexFormat & PrimitiveShapeFormat_UvUnorm16) {
+            pDst = WriteElement(pDst, ConvertToUnorm16(u));
+            pDst = WriteElement(pDst, ConvertToUnorm16(v));
+        } else {
+            pDst = WriteElement(pDst, u);
+            pDst = WriteElement(pDst, v);
+        }
+    }
+
+    return pDst;
+}
+
+size_t GetPosStride(PrimitiveShapeFormat vertexFormat) {
+    if (!(vertexFormat & PrimitiveShapeFormat_Pos)) {
+        return 0;
+    }
+    return (vertexFormat & PrimitiveShapeFormat_PosFloat16) ? 8 : 12;
+}
+
+size_t GetNormalStride(PrimitiveShapeFormat vertexFormat) {
+    if (!(vertexFormat & PrimitiveShapeFormat_Normal)) {
+        return 0;
+    }
+    return (vertexFormat & (PrimitiveShapeFormat_NormalOctahedral |
+                            PrimitiveShapeFormat_NormalSnorm10)) ?
+               4 :
+               12;
+}
+
+size_t GetUvStride(PrimitiveShapeFormat vertexFormat) {
+    if (!(vertexFormat & PrimitiveShapeFormat_Uv)) {
+        return 0;
+    }
+    return (vertexFormat & PrimitiveShapeFormat_UvUnorm16) ? 4 : 8;
+}
+
+}  // namespace
+
 PrimitiveShape::PrimitiveShape(PrimitiveShapeFormat vertexFormat,
                                PrimitiveTopology primitiveTopology) {
     m_pIndexBuffer = nullptr;
@@ -33,18 +177,7 @@ void* PrimitiveShape::GetVertexBuffer() const {
 }
 
 size_t PrimitiveShape::GetStride() const {
-    size_t stride = 0;
-    if (m_VertexFormat & PrimitiveShapeFormat_Pos) {
-        stride += 12;
-    }
-    if (m_VertexFormat & PrimitiveShapeFormat_Normal) {
-        stride += 12;
-    }
-    if (m_VertexFormat & PrimitiveShapeFormat_Uv) {
-        stride += 8;
-    }
-
-    return stride;
+    return PrimitiveShapeVertexStateInfo::GetStride(m_VertexFormat);
 }
 
 size_t PrimitiveShape::GetVertexBufferSize() const {
@@ -80,6 +213,46 @@ void PrimitiveShape::Calculate(void* pVertexMemory, size_t vertexSize, void* pIn
     CalculateImpl(pVertexMemory, vertexSize, pIndexMemory, indexSize);
 }
 
+bool PrimitiveShape::Calculate(void* pVertexMemory, size_t vertexSize, void* pIndexMemory,
+                               size_t indexSize, void* pWorkMemory, size_t workMemorySize,
+                               VertexCacheStatistics* pOutStatistics) {
+    CalculateImpl(pVertexMemory, vertexSize, pIndexMemory, indexSize);
+
+    size_t requiredSize = CalculateWorkMemorySize();
+    bool isOptimized = requiredSize > 0 && pWorkMemory != nullptr && workMemorySize >= requiredSize;
+    VertexCacheStatistics statistics;
+    if (isOptimized) {
+        VertexCacheOptimizer::Optimize(&statistics, m_pVertexBuffer, GetStride(), m_VertexCount,
+                                       m_pIndexBuffer, m_IndexBufferFormat, m_IndexCount,
+                                       VertexCacheOptimizer::DefaultCacheSize, pWorkMemory,
+                                       workMemorySize);
+    } else if (pOutStatistics != nullptr &&
+               m_PrimitiveTopology == PrimitiveTopology_TriangleList) {
+        statistics.acmrBefore =
+            VertexCacheOptimizer::CalculateAcmr(m_pIndexBuffer, m_IndexBufferFormat, m_IndexCount,
+                                                VertexCacheOptimizer::DefaultCacheSize);
+        statistics.acmrAfter = statistics.acmrBefore;
+    } else {
+        statistics.acmrBefore = 0.0f;
+        statistics.acmrAfter = 0.0f;
+    }
+
+    if (pOutStatistics != nullptr) {
+        *pOutStatistics = statistics;
+    }
+    // nothing to optimize is not a failure
+    return isOptimized || requiredSize == 0;
+}
+
+size_t PrimitiveShape::CalculateWorkMemorySize() const {
+    if ((m_VertexFormat & PrimitiveShapeFormat_OptimizeVertexCache) &&
+        m_PrimitiveTopology == PrimitiveTopology_TriangleList) {
+        return VertexCacheOptimizer::CalculateWorkMemorySize(m_VertexCount, m_IndexCount,
+                                                             GetStride());
+    }
+    return 0;
+}
+
 void PrimitiveShape::SetVertexBuffer(void* pVertexBuffer) {
     m_pVertexBuffer = pVertexBuffer;
 }
@@ -113,6 +286,102 @@ void PrimitiveShape::SetIndexCount(int indexCount) {
     }
 }
 
+AttributeFormat PrimitiveShapeVertexStateInfo::GetAttributeFormat(
+    PrimitiveShapeFormat vertexFormat, Attribute attribute) {
+    switch (attribute) {
+    case Attribute_Pos:
+        return (vertexFormat & PrimitiveShapeFormat_PosFloat16) ?
+                   AttributeFormat_16_16_16_16_Float :
+                   AttributeFormat_32_32_32_Float;
+
+    case Attribute_Normal:
+        if (vertexFormat & PrimitiveShapeFormat_NormalOctahedral) {
+            return AttributeFormat_16_16_Snorm;
+        }
+        return (vertexFormat & PrimitiveShapeFormat_NormalSnorm10) ?
+                   AttributeFormat_10_10_10_2_Snorm :
+                   AttributeFormat_32_32_32_Float;
+
+    case Attribute_Uv:
+        return (vertexFormat & PrimitiveShapeFormat_UvUnorm16) ? AttributeFormat_16_16_Unorm :
+                                                                 AttributeFormat_32_32_Float;
+
+    default:
+        NN_UNEXPECTED_DEFAULT;
+        return AttributeFormat_Undefined;
+    }
+}
+
+ptrdiff_t PrimitiveShapeVertexStateInfo::GetAttributeOffset(PrimitiveShapeFormat vertexFormat,
+                                                            Attribute attribute) {
+    switch (attribute) {
+    case Attribute_Pos:
+        return 0;
+
+    case Attribute_Normal:
+        return GetPosStride(vertexFormat);
+
+    case Attribute_Uv:
+        return GetPosStride(vertexFormat) + GetNormalStride(vertexFormat);
+
+    default:
+        NN_UNEXPECTED_DEFAULT;
+        return 0;
+    }
+}
+
+size_t PrimitiveShapeVertexStateInfo::GetStride(PrimitiveShapeFormat vertexFormat) {
+    return GetPosStride(vertexFormat) + GetNormalStride(vertexFormat) + GetUvStride(vertexFormat);
+}
+
+PrimitiveShapeVertexStateInfo::PrimitiveShapeVertexStateInfo() {
+    for (int idxAttribute = 0; idxAttribute < Attribute_End; ++idxAttribute) {
+        m_AttributeIndex[idxAttribute] = -1;
+    }
+}
+
+void PrimitiveShapeVertexStateInfo::Initialize(PrimitiveShapeFormat vertexFormat) {
+    const PrimitiveShapeFormat AttributeFlag[Attribute_End] = {
+        PrimitiveShapeFormat_Pos, PrimitiveShapeFormat_Normal, PrimitiveShapeFormat_Uv};
+
+    int attributeCount = 0;
+    for (int idxAttribute = 0; idxAttribute < Attribute_End; ++idxAttribute) {
+        if (!(vertexFormat & AttributeFlag[idxAttribute])) {
+            m_AttributeIndex[idxAttribute] = -1;
+            continue;
+        }
+
+        Attribute attribute = static_cast<Attribute>(idxAttribute);
+        VertexAttributeStateInfo& info = m_VertexAttributeStateInfo[attributeCount];
+        info.SetDefault();
+        info.SetBufferIndex(0);
+        info.SetShaderSlot(idxAttribute);
+        info.SetOffset(GetAttributeOffset(vertexFormat, attribute));
+        info.SetFormat(GetAttributeFormat(vertexFormat, attribute));
+
+        m_AttributeIndex[idxAttribute] = attributeCount++;
+    }
+
+    m_VertexBufferStateInfo.SetDefault();
+    m_VertexBufferStateInfo.SetStride(GetStride(vertexFormat));
+
+    m_VertexStateInfo.SetDefault();
+    m_VertexStateInfo.SetVertexAttributeStateInfoArray(m_VertexAttributeStateInfo, attributeCount);
+    m_VertexStateInfo.SetVertexBufferStateInfoArray(&m_VertexBufferStateInfo, 1);
+}
+
+void PrimitiveShapeVertexStateInfo::SetShaderSlot(Attribute attribute, int shaderSlot) {
+    if (m_AttributeIndex[attribute] >= 0) {
+        m_VertexAttributeStateInfo[m_AttributeIndex[attribute]].SetShaderSlot(shaderSlot);
+    }
+}
+
+void PrimitiveShapeVertexStateInfo::SetNamePtr(Attribute attribute, const char* pName) {
+    if (m_AttributeIndex[attribute] >= 0) {
+        m_VertexAttributeStateInfo[m_AttributeIndex[attribute]].SetNamePtr(pName);
+    }
+}
+
 SphereShape::SphereShape(PrimitiveShapeFormat vertexFormat, PrimitiveTopology primitiveTopology,
                          int sliceCount, int stackCount)
     : PrimitiveShape(vertexFormat, primitiveTopology) {
@@ -156,20 +425,30 @@ int SphereShape::CalculateIndexCount() {
 }
 
 void* SphereShape::CalculateVertexBuffer() {
-    return nullptr;
-}
-
-/*
-    switch (primitiveTopology) {
-    case PrimitiveTopology_LineList: {
-    } break;
-    case PrimitiveTopology_TriangleList: {
-    } break;
-
-    default:
-        break;
+    void* pVertexBuffer = GetVertexBuffer();
+    const PrimitiveShapeFormat vertexFormat = GetVertexFormat();
+
+    for (int idxStack = 0; idxStack <= m_StackCount; ++idxStack) {
+        float stackRad = nn::util::DegreeToRadian(180.0f) * idxStack / m_StackCount;
+        float cosStack = nn::util::CosTable(nn::util::RadianToAngleIndex(stackRad));
+        float sinStack = nn::util::SinTable(nn::util::RadianToAngleIndex(stackRad));
+
+        for (int idxSlice = 0; idxSlice <= m_SliceCount; ++idxSlice) {
+            float sliceRad = nn::util::DegreeToRadian(360.0f) * idxSlice / m_SliceCount;
+            float cosSlice = nn::util::CosTable(nn::util::RadianToAngleIndex(sliceRad));
+            float sinSlice = nn::util::SinTable(nn::util::RadianToAngleIndex(sliceRad));
+
+            float x = sinStack * cosSlice;
+            float y = cosStack;
+            float z = -sinStack * sinSlice;
+            pVertexBuffer = WriteVertex(pVertexBuffer, vertexFormat, x, y, z, x, y, z,
+                                        static_cast<float>(idxSlice) / m_SliceCount,
+                                        static_cast<float>(idxStack) / m_StackCount);
+        }
     }
-*/
+
+    return pVertexBuffer;
+}
 
 template <typename T>
 void SphereShape::CalculateIndexBuffer() {
@@ -222,7 +501,8 @@ void SphereShape::CalculateIndexBuffer() {
                 pIndexData[(idxFace * 3) + 0] = idxSlice + idxStack * (m_SliceCount + 1);
                 pIndexData[(idxFace * 3) + 1] =
                     idxSlice + idxStack * (m_SliceCount + 1) + m_SliceCount + 1;
-                pIndexData[(idxFace * 3) + 2] = idxSlice + idxStack * (m_SliceCount + 1);
+                pIndexData[(idxFace * 3) + 2] =
+                    idxSlice + idxStack * (m_SliceCount + 1) + m_SliceCount + 2;
 
                 ++idxFace;
             }
@@ -303,7 +583,8 @@ int CircleShape::CalculateIndexCount() {
 }
 
 void* CircleShape::CalculateVertexBuffer() {
-    float* pVertexBuffer = static_cast<float*>(GetVertexBuffer());
+    void* pVertexBuffer = GetVertexBuffer();
+    const PrimitiveShapeFormat vertexFormat = GetVertexFormat();
 
     if (m_SliceCount > 0) {
         for (int idxSlice = 0; idxSlice < m_SliceCount; ++idxSlice) {
@@ -311,45 +592,69 @@ void* CircleShape::CalculateVertexBuffer() {
             float cosXY = nn::util::CosTable(nn::util::RadianToAngleIndex(rad));
             float sinXY = nn::util::SinTable(nn::util::RadianToAngleIndex(rad));
 
-            if (GetVertexFormat() & PrimitiveShapeFormat_Pos) {
-                *pVertexBuffer++ = cosXY;
-                *pVertexBuffer++ = sinXY;
-                *pVertexBuffer++ = 0.0f;
-            }
-            if (GetVertexFormat() & PrimitiveShapeFormat_Normal) {
-                *pVertexBuffer++ = 0.0f;
-                *pVertexBuffer++ = 0.0f;
-                *pVertexBuffer++ = 1.0f;
-            }
-            if (GetVertexFormat() & PrimitiveShapeFormat_Uv) {
-                *pVertexBuffer++ = cosXY * 0.5f + 0.5f;
-                *pVertexBuffer++ = 1.0f - (sinXY * 0.5f + 0.5f);
-            }
+            pVertexBuffer = WriteVertex(pVertexBuffer, vertexFormat, cosXY, sinXY, 0.0f, 0.0f, 0.0f,
+                                        1.0f, cosXY * 0.5f + 0.5f, 1.0f - (sinXY * 0.5f + 0.5f));
         }
     }
 
-    if (GetVertexFormat() & PrimitiveShapeFormat_Pos) {
-        *pVertexBuffer++ = 0.0f;
-        *pVertexBuffer++ = 0.0f;
-        *pVertexBuffer++ = 0.0f;
-    }
-    if (GetVertexFormat() & PrimitiveShapeFormat_Normal) {
-        *pVertexBuffer++ = 0.0f;
-        *pVertexBuffer++ = 0.0f;
-        *pVertexBuffer++ = 1.0f;
-    }
-    if (GetVertexFormat() & PrimitiveShapeFormat_Uv) {
-        *pVertexBuffer++ = 0.5f;
-        *pVertexBuffer++ = 0.5f;
-    }
+    pVertexBuffer =
+        WriteVertex(pVertexBuffer, vertexFormat, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.5f, 0.5f);
 
     return pVertexBuffer;
 }
 
-/*
-void CircleShape::CalculateImpl(void* pVertexMemory, size_t vertexSize, void* pIndexMemory,
-                                size_t indexSize);
-*/
+template <typename T>
+void CircleShape::CalculateIndexBuffer() {
+    T* pIndexData = static_cast<T*>(GetIndexBuffer());
+    int idx = 0;
+
+    switch (GetPrimitiveTopology()) {
+    case PrimitiveTopology_LineStrip: {
+        for (int idxSlice = 0; idxSlice < m_SliceCount; ++idxSlice) {
+            pIndexData[idx++] = idxSlice;
+        }
+        pIndexData[idx++] = 0;
+    } break;
+
+    case PrimitiveTopology_TriangleList: {
+        // the center vertex is stored after the rim
+        for (int idxSlice = 0; idxSlice < m_SliceCount; ++idxSlice) {
+            pIndexData[idx++] = m_SliceCount;
+            pIndexData[idx++] = idxSlice;
+            pIndexData[idx++] = (idxSlice + 1) % m_SliceCount;
+        }
+    } break;
+
+    default:
+        break;
+    }
+}
+
+void CircleShape::CalculateImpl(void* pVertexMemory, [[maybe_unused]] size_t vertexSize,
+                                void* pIndexMemory, [[maybe_unused]] size_t indexSize) {
+    SetVertexBuffer(pVertexMemory);
+    SetIndexBuffer(pIndexMemory);
+
+    CalculateVertexBuffer();
+
+    switch (GetIndexBufferFormat()) {
+    case IndexFormat_Uint8:
+        CalculateIndexBuffer<uint8_t>();
+        break;
+
+    case IndexFormat_Uint16:
+        CalculateIndexBuffer<uint16_t>();
+        break;
+
+    case IndexFormat_Uint32:
+        CalculateIndexBuffer<uint32_t>();
+        break;
+
+    default:
+        NN_UNEXPECTED_DEFAULT;
+        break;
+    }
+}
 
 CubeShape::CubeShape(PrimitiveShapeFormat vertexFormat, PrimitiveTopology primitiveTopology)
     : PrimitiveShape(vertexFormat, primitiveTopology) {
@@ -409,11 +714,6 @@ int CubeShape::CalculateIndexCount() {
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wmissing-braces"
 void* CubeShape::CalculateVertexBuffer() {
-    const nn::util::Float3 VertexPos[8] = {
-        {1.0f, 1.0f, -1.0f}, {1.0f, -1.0f, -1.0f}, {-1.0f, -1.0f, -1.0f}, {-1.0f, 1.0f, -1.0f},
-        {1.0f, 1.0f, 1.0f},  {1.0f, -1.0f, 1.0f},  {-1.0f, -1.0f, 1.0f},  {-1.0f, 1.0f, 1.0f},
-    };
-
     const nn::util::Float3 VertexNormal[6] = {
         {0.0, 0.0, -1.0}, {-1.0, 0.0, 0.0}, {0.0, 0.0, 1.0},
         {1.0, 0.0, 0.0},  {0.0, -1.0, 0.0}, {0.0, 1.0, 0.0},
@@ -426,70 +726,29 @@ void* CubeShape::CalculateVertexBuffer() {
         {1.0f, 0.0f},
     };
 
-    const uint32_t FaceTable[6][4] = {
-        {0, 1, 2, 3}, {3, 2, 6, 7}, {7, 6, 5, 4}, {4, 5, 1, 0}, {1, 5, 6, 2}, {4, 0, 3, 7},
-    };
-
-    float* pVertexBuffer = static_cast<float*>(GetVertexBuffer());
+    void* pVertexBuffer = GetVertexBuffer();
+    const PrimitiveShapeFormat vertexFormat = GetVertexFormat();
     const PrimitiveTopology primitiveTopology = GetPrimitiveTopology();
 
     if (primitiveTopology == PrimitiveTopology_LineList) {
-        int idx = 0;
-        pVertexBuffer[idx++] = 0.5f;
-        pVertexBuffer[idx++] = 0.5f;
-        pVertexBuffer[idx++] = -0.5f;
-        pVertexBuffer[idx++] = 0.5f;
-        pVertexBuffer[idx++] = -0.5f;
-        pVertexBuffer[idx++] = -0.5f;
-        pVertexBuffer[idx++] = -0.5f;
-        pVertexBuffer[idx++] = -0.5f;
-        pVertexBuffer[idx++] = -0.5f;
-        pVertexBuffer[idx++] = -0.5f;
-        pVertexBuffer[idx++] = 0.5f;
-        pVertexBuffer[idx++] = -0.5f;
-        pVertexBuffer[idx++] = 0.5f;
-        pVertexBuffer[idx++] = 0.5f;
-        pVertexBuffer[idx++] = 0.5f;
-        pVertexBuffer[idx++] = 0.5f;
-        pVertexBuffer[idx++] = -0.5f;
-        pVertexBuffer[idx++] = 0.5f;
-        pVertexBuffer[idx++] = -0.5f;
-        pVertexBuffer[idx++] = -0.5f;
-        pVertexBuffer[idx++] = 0.5f;
-        pVertexBuffer[idx++] = -0.5f;
-        pVertexBuffer[idx++] = 0.5f;
-        pVertexBuffer[idx++] = 0.5f;
-        pVertexBuffer += idx;
+        // corners are shared between faces, so their normals point away from the center
+        const float InvSqrt3 = 0.57735027f;
+        for (int idxCorner = 0; idxCorner < CubeVertexCount_Wired; ++idxCorner) {
+            const nn::util::Float3& pos = CubeVertexPos[idxCorner];
+            pVertexBuffer = WriteVertex(pVertexBuffer, vertexFormat, pos.x * 0.5f, pos.y * 0.5f,
+                                        pos.z * 0.5f, pos.x * InvSqrt3, pos.y * InvSqrt3,
+                                        pos.z * InvSqrt3, 0.0f, 0.0f);
+        }
         return pVertexBuffer;
     }
 
     for (int idxFace = 0; idxFace < 6; ++idxFace) {
         for (int idxCorner = 0; idxCorner < 4; ++idxCorner) {
-            int idx = 0;
-
-            switch (GetVertexFormat()) {
-            case PrimitiveShapeFormat_Pos:
-                pVertexBuffer[idx++] = VertexPos[FaceTable[idxFace][idxCorner]].x * 0.5f;
-                pVertexBuffer[idx++] = VertexPos[FaceTable[idxFace][idxCorner]].y * 0.5f;
-                pVertexBuffer[idx++] = VertexPos[FaceTable[idxFace][idxCorner]].z * 0.5f;
-                break;
-
-            case PrimitiveShapeFormat_Normal:
-                pVertexBuffer[idx++] = VertexNormal[idxFace].x;
-                pVertexBuffer[idx++] = VertexNormal[idxFace].y;
-                pVertexBuffer[idx++] = VertexNormal[idxFace].z;
-                break;
-
-            case PrimitiveShapeFormat_Uv:
-                pVertexBuffer[idx++] = VertexUv[idxCorner].x;
-                pVertexBuffer[idx++] = VertexUv[idxCorner].y;
-                break;
-
-            default:
-                break;
-            }
-
-            pVertexBuffer += idx;
+            const nn::util::Float3& pos = CubeVertexPos[CubeFaceTable[idxFace][idxCorner]];
+            pVertexBuffer = WriteVertex(pVertexBuffer, vertexFormat, pos.x * 0.5f, pos.y * 0.5f,
+                                        pos.z * 0.5f, VertexNormal[idxFace].x,
+                                        VertexNormal[idxFace].y, VertexNormal[idxFace].z,
+                                        VertexUv[idxCorner].x, VertexUv[idxCorner].y);
         }
     }
 
@@ -497,37 +756,320 @@ void* CubeShape::CalculateVertexBuffer() {
 }
 #pragma GCC diagnostic pop
 
-/*
-
 template <typename T>
-void CubeShape::CalculateIndexBuffer();
-void CubeShape::CalculateImpl(void* pVertexMemory, size_t vertexSize, void* pIndexMemory,
-                                size_t indexSize);
-void QuadShape::QuadShape(PrimitiveShapeFormat, PrimitiveTopology);
-*/
+void CubeShape::CalculateIndexBuffer() {
+    T* pIndexData = static_cast<T*>(GetIndexBuffer());
+    int idx = 0;
+
+    switch (GetPrimitiveTopology()) {
+    case PrimitiveTopology_LineList: {
+        // the twelve edges followed by both diagonals of every face
+        for (int idxEdge = 0; idxEdge < 12; ++idxEdge) {
+            pIndexData[idx++] = CubeEdgeTable[idxEdge][0];
+            pIndexData[idx++] = CubeEdgeTable[idxEdge][1];
+        }
+        for (int idxFace = 0; idxFace < 6; ++idxFace) {
+            pIndexData[idx++] = CubeFaceTable[idxFace][0];
+            pIndexData[idx++] = CubeFaceTable[idxFace][2];
+            pIndexData[idx++] = CubeFaceTable[idxFace][1];
+            pIndexData[idx++] = CubeFaceTable[idxFace][3];
+        }
+    } break;
+
+    case PrimitiveTopology_TriangleList: {
+        for (int idxFace = 0; idxFace < 6; ++idxFace) {
+            int baseVertex = idxFace * 4;
+            pIndexData[idx++] = baseVertex + 0;
+            pIndexData[idx++] = baseVertex + 1;
+            pIndexData[idx++] = baseVertex + 2;
+            pIndexData[idx++] = baseVertex + 0;
+            pIndexData[idx++] = baseVertex + 2;
+            pIndexData[idx++] = baseVertex + 3;
+        }
+    } break;
+
+    default:
+        break;
+    }
+}
+
+void CubeShape::CalculateImpl(void* pVertexMemory, [[maybe_unused]] size_t vertexSize,
+                              void* pIndexMemory, [[maybe_unused]] size_t indexSize) {
+    SetVertexBuffer(pVertexMemory);
+    SetIndexBuffer(pIndexMemory);
+
+    CalculateVertexBuffer();
+
+    switch (GetIndexBufferFormat()) {
+    case IndexFormat_Uint8:
+        CalculateIndexBuffer<uint8_t>();
+        break;
+
+    case IndexFormat_Uint16:
+        CalculateIndexBuffer<uint16_t>();
+        break;
+
+    case IndexFormat_Uint32:
+        CalculateIndexBuffer<uint32_t>();
+        break;
+
+    default:
+        NN_UNEXPECTED_DEFAULT;
+        break;
+    }
+}
+
+QuadShape::QuadShape(PrimitiveShapeFormat vertexFormat, PrimitiveTopology primitiveTopology)
+    : PrimitiveShape(vertexFormat, primitiveTopology) {
+    SetVertexCount(CalculateVertexCount());
+    SetIndexCount(CalculateIndexCount());
+
+    const size_t stride = GetStride();
+
+    SetVertexBufferSize(GetVertexCount() * stride);
+    SetIndexBufferSize(GetIndexCount() * size_t(4));
+}
 
 QuadShape::~QuadShape() {}
 
-/*
-int QuadShape::CalculateVertexCount();
-int QuadShape::CalculateIndexCount();
-void* QuadShape::CalculateVertexBuffer();
-void QuadShape::CalculateImpl(void* pVertexMemory, size_t vertexSize, void* pIndexMemory,
-                                size_t indexSize);
-void HemiSphereShape::HemiSphereShape(PrimitiveShapeFormat, PrimitiveTopology, int);
-*/
+int QuadShape::CalculateVertexCount() {
+    return QuadVertexCount;
+}
+
+int QuadShape::CalculateIndexCount() {
+    switch (GetPrimitiveTopology()) {
+    case PrimitiveTopology_LineStrip:
+        return QuadIndexCount_Wired;
+
+    case PrimitiveTopology_TriangleList:
+        return QuadIndexCountt_Solid;
+
+    default:
+        return 0;
+    }
+}
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmissing-braces"
+void* QuadShape::CalculateVertexBuffer() {
+    const nn::util::Float2 VertexPos[4] = {
+        {-0.5f, 0.5f},
+        {-0.5f, -0.5f},
+        {0.5f, -0.5f},
+        {0.5f, 0.5f},
+    };
+
+    void* pVertexBuffer = GetVertexBuffer();
+    const PrimitiveShapeFormat vertexFormat = GetVertexFormat();
+
+    for (int idxCorner = 0; idxCorner < QuadVertexCount; ++idxCorner) {
+        pVertexBuffer = WriteVertex(pVertexBuffer, vertexFormat, VertexPos[idxCorner].x,
+                                    VertexPos[idxCorner].y, 0.0f, 0.0f, 0.0f, 1.0f,
+                                    VertexPos[idxCorner].x + 0.5f,
+                                    0.5f - VertexPos[idxCorner].y);
+    }
+
+    return pVertexBuffer;
+}
+#pragma GCC diagnostic pop
+
+template <typename T>
+void QuadShape::CalculateIndexBuffer() {
+    T* pIndexData = static_cast<T*>(GetIndexBuffer());
+    int idx = 0;
+
+    switch (GetPrimitiveTopology()) {
+    case PrimitiveTopology_LineStrip: {
+        for (int idxCorner = 0; idxCorner < QuadVertexCount; ++idxCorner) {
+            pIndexData[idx++] = idxCorner;
+        }
+        pIndexData[idx++] = 0;
+    } break;
+
+    case PrimitiveTopology_TriangleList: {
+        pIndexData[idx++] = 0;
+        pIndexData[idx++] = 1;
+        pIndexData[idx++] = 2;
+        pIndexData[idx++] = 0;
+        pIndexData[idx++] = 2;
+        pIndexData[idx++] = 3;
+    } break;
+
+    default:
+        break;
+    }
+}
+
+void QuadShape::CalculateImpl(void* pVertexMemory, [[maybe_unused]] size_t vertexSize,
+                              void* pIndexMemory, [[maybe_unused]] size_t indexSize) {
+    SetVertexBuffer(pVertexMemory);
+    SetIndexBuffer(pIndexMemory);
+
+    CalculateVertexBuffer();
+
+    switch (GetIndexBufferFormat()) {
+    case IndexFormat_Uint8:
+        CalculateIndexBuffer<uint8_t>();
+        break;
+
+    case IndexFormat_Uint16:
+        CalculateIndexBuffer<uint16_t>();
+        break;
+
+    case IndexFormat_Uint32:
+        CalculateIndexBuffer<uint32_t>();
+        break;
+
+    default:
+        NN_UNEXPECTED_DEFAULT;
+        break;
+    }
+}
+
+HemiSphereShape::HemiSphereShape(PrimitiveShapeFormat vertexFormat,
+                                 PrimitiveTopology primitiveTopology, int sliceCount)
+    : PrimitiveShape(vertexFormat, primitiveTopology) {
+    m_SliceCount = sliceCount;
+
+    SetVertexCount(CalculateVertexCount());
+    SetIndexCount(CalculateIndexCount());
+
+    const size_t stride = GetStride();
+    SetVertexBufferSize(GetVertexCount() * stride);
+    SetIndexBufferSize(GetIndexCount() * size_t(4));
+}
 
 HemiSphereShape::~HemiSphereShape() {}
 
-/*
-int HemiSphereShape::CalculateVertexCount();
-int HemiSphereShape::CalculateIndexCount();
-void* HemiSphereShape::CalculateVertexBuffer();
+int HemiSphereShape::CalculateStackCount() const {
+    // a quarter of the slices keeps the latitude step equal to the longitude step
+    return m_SliceCount >= 8 ? m_SliceCount / 4 : 2;
+}
+
+int HemiSphereShape::CalculateVertexCount() {
+    return (CalculateStackCount() + 1) * (m_SliceCount + 1);
+}
+
+int HemiSphereShape::CalculateIndexCount() {
+    const int stackCount = CalculateStackCount();
+
+    switch (GetPrimitiveTopology()) {
+    case PrimitiveTopology_LineList:
+        return 4 * m_SliceCount * stackCount;
+
+    case PrimitiveTopology_TriangleList:
+        return 3 * m_SliceCount * (2 * stackCount - 1);
+
+    default:
+        return 0;
+    }
+}
+
+void* HemiSphereShape::CalculateVertexBuffer() {
+    void* pVertexBuffer = GetVertexBuffer();
+    const PrimitiveShapeFormat vertexFormat = GetVertexFormat();
+    const int stackCount = CalculateStackCount();
+
+    for (int idxStack = 0; idxStack <= stackCount; ++idxStack) {
+        float stackRad = nn::util::DegreeToRadian(90.0f) * idxStack / stackCount;
+        float cosStack = nn::util::CosTable(nn::util::RadianToAngleIndex(stackRad));
+        float sinStack = nn::util::SinTable(nn::util::RadianToAngleIndex(stackRad));
+
+        for (int idxSlice = 0; idxSlice <= m_SliceCount; ++idxSlice) {
+            float sliceRad = nn::util::DegreeToRadian(360.0f) * idxSlice / m_SliceCount;
+            float cosSlice = nn::util::CosTable(nn::util::RadianToAngleIndex(sliceRad));
+            float sinSlice = nn::util::SinTable(nn::util::RadianToAngleIndex(sliceRad));
+
+            float x = sinStack * cosSlice;
+            float y = cosStack;
+            float z = -sinStack * sinSlice;
+            pVertexBuffer = WriteVertex(pVertexBuffer, vertexFormat, x, y, z, x, y, z,
+                                        static_cast<float>(idxSlice) / m_SliceCount,
+                                        static_cast<float>(idxStack) / stackCount);
+        }
+    }
+
+    return pVertexBuffer;
+}
 
 template <typename T>
-void HemiSphereShape::CalculateIndexBuffer();
-void HemiSphereShape::CalculateImpl(void* pVertexMemory, size_t vertexSize, void* pIndexMemory,
-                                size_t indexSize);
+void HemiSphereShape::CalculateIndexBuffer() {
+    T* pIndexData = static_cast<T*>(GetIndexBuffer());
+    int idx = 0;
+
+    const int stackCount = CalculateStackCount();
+    const int numVertsPerStack = m_SliceCount + 1;
+
+    switch (GetPrimitiveTopology()) {
+    case PrimitiveTopology_LineList: {
+        for (int idxSlice = 0; idxSlice < m_SliceCount; ++idxSlice) {
+            for (int idxStack = 0; idxStack < stackCount; ++idxStack) {
+                pIndexData[idx++] = idxStack * numVertsPerStack + idxSlice;
+                pIndexData[idx++] = (idxStack + 1) * numVertsPerStack + idxSlice;
+            }
+        }
+
+        // the rim is closed as well as the inner rings
+        for (int idxStack = 1; idxStack <= stackCount; ++idxStack) {
+            for (int idxSlice = 0; idxSlice < m_SliceCount; ++idxSlice) {
+                pIndexData[idx++] = idxStack * numVertsPerStack + idxSlice;
+                pIndexData[idx++] = idxStack * numVertsPerStack + idxSlice + 1;
+            }
+        }
+    } break;
+
+    case PrimitiveTopology_TriangleList: {
+        for (int idxSlice = 0; idxSlice < m_SliceCount; ++idxSlice) {
+            pIndexData[idx++] = idxSlice;
+            pIndexData[idx++] = idxSlice + numVertsPerStack;
+            pIndexData[idx++] = idxSlice + numVertsPerStack + 1;
+        }
+
+        for (int idxStack = 1; idxStack < stackCount; ++idxStack) {
+            for (int idxSlice = 0; idxSlice < m_SliceCount; ++idxSlice) {
+                int baseVertex = idxStack * numVertsPerStack + idxSlice;
+                pIndexData[idx++] = baseVertex;
+                pIndexData[idx++] = baseVertex + numVertsPerStack + 1;
+                pIndexData[idx++] = baseVertex + 1;
+                pIndexData[idx++] = baseVertex;
+                pIndexData[idx++] = baseVertex + numVertsPerStack;
+                pIndexData[idx++] = baseVertex + numVertsPerStack + 1;
+            }
+        }
+    } break;
+
+    default:
+        break;
+    }
+}
+
+void HemiSphereShape::CalculateImpl(void* pVertexMemory, [[maybe_unused]] size_t vertexSize,
+                                    void* pIndexMemory, [[maybe_unused]] size_t indexSize) {
+    SetVertexBuffer(pVertexMemory);
+    SetIndexBuffer(pIndexMemory);
+
+    CalculateVertexBuffer();
+
+    switch (GetIndexBufferFormat()) {
+    case IndexFormat_Uint8:
+        CalculateIndexBuffer<uint8_t>();
+        break;
+
+    case IndexFormat_Uint16:
+        CalculateIndexBuffer<uint16_t>();
+        break;
+
+    case IndexFormat_Uint32:
+        CalculateIndexBuffer<uint32_t>();
+        break;
+
+    default:
+        NN_UNEXPECTED_DEFAULT;
+        break;
+    }
+}
+
+/*
 void PipeShape::PipeShape(PrimitiveShapeFormat, PrimitiveTopology, int);
 */
 
@@ -0,0 +1,406 @@
+#include <nn/gfx/util/gfx_PrimitiveShapeBatchRenderer.h>
+
+#include <nn/gfx/detail/gfx_Buffer-api.nvn.8.h>
+#include <nn/gfx/detail/gfx_CommandBuffer-api.nvn.8.h>
+#include <nn/gfx/gfx_GpuAddress.h>
+#include <nn/util/util_BytePtr.h>
+
+#include <algorithm>
+#include <cstring>
+
+namespace nn::gfx::util {
+
+struct PrimitiveShapeBatchRenderer::ShapeRecord {
+    PrimitiveTopology primitiveTopology;
+    IndexFormat indexFormat;
+    ptrdiff_t indexBufferOffset;
+    int indexCount;
+    int baseVertex;
+};
+
+struct PrimitiveShapeBatchRenderer::BatchRecord {
+    int baseInstance;
+    int instanceCount;
+};
+
+namespace {
+
+const size_t ShapeBufferAlignment = sizeof(uint32_t);
+
+int GetShapeIndex(PrimitiveShapeBatchRenderer::ShapeType shapeType,
+                  PrimitiveShapeBatchRenderer::DrawMode drawMode) {
+    return drawMode * PrimitiveShapeBatchRenderer::ShapeType_End + shapeType;
+}
+
+// constructs every shape in shape index order and hands it to the function
+template <typename TFunction>
+void ForEachShape(const PrimitiveShapeBatchRendererInfo& info, TFunction function) {
+    PrimitiveShapeFormat vertexFormat = info.GetVertexFormat();
+
+    for (int idxMode = 0; idxMode < PrimitiveShapeBatchRenderer::DrawMode_End; ++idxMode) {
+        PrimitiveShapeBatchRenderer::DrawMode drawMode =
+            static_cast<PrimitiveShapeBatchRenderer::DrawMode>(idxMode);
+        bool isWired = drawMode == PrimitiveShapeBatchRenderer::DrawMode_Wired;
+        PrimitiveTopology listTopology =
+            isWired ? PrimitiveTopology_LineList : PrimitiveTopology_TriangleList;
+        PrimitiveTopology stripTopology =
+            isWired ? PrimitiveTopology_LineStrip : PrimitiveTopology_TriangleList;
+
+        SphereShape sphere(vertexFormat, listTopology, info.GetSphereSliceCount(),
+                           info.GetSphereStackCount());
+        function(GetShapeIndex(PrimitiveShapeBatchRenderer::ShapeType_Sphere, drawMode), &sphere);
+
+        HemiSphereShape hemiSphere(vertexFormat, listTopology, info.GetHemiSphereSliceCount());
+        function(GetShapeIndex(PrimitiveShapeBatchRenderer::ShapeType_HemiSphere, drawMode),
+                 &hemiSphere);
+
+        CircleShape circle(vertexFormat, stripTopology, info.GetCircleSliceCount());
+        function(GetShapeIndex(PrimitiveShapeBatchRenderer::ShapeType_Circle, drawMode), &circle);
+
+        CubeShape cube(vertexFormat, listTopology);
+        function(GetShapeIndex(PrimitiveShapeBatchRenderer::ShapeType_Cube, drawMode), &cube);
+
+        QuadShape quad(vertexFormat, stripTopology);
+        function(GetShapeIndex(PrimitiveShapeBatchRenderer::ShapeType_Quad, drawMode), &quad);
+    }
+}
+
+size_t CalculateInstanceSliceSize(int maxInstanceCount) {
+    return sizeof(PrimitiveShapeBatchRenderer::InstanceData) * maxInstanceCount;
+}
+
+}  // namespace
+
+size_t PrimitiveShapeBatchRenderer::CalculateShapeBufferSize(const InfoType& info) {
+    // all vertices first so a single vertex buffer binding covers every shape
+    size_t vertexBufferSize = 0;
+    size_t indexBufferSize = 0;
+    ForEachShape(info, [&](int, const PrimitiveShape* pShape) {
+        vertexBufferSize += pShape->GetVertexBufferSize();
+        indexBufferSize += nn::util::align_up(pShape->GetIndexBufferSize(), ShapeBufferAlignment);
+    });
+    return nn::util::align_up(vertexBufferSize, ShapeBufferAlignment) + indexBufferSize;
+}
+
+size_t PrimitiveShapeBatchRenderer::GetShapeBufferAlignment() {
+    return ShapeBufferAlignment;
+}
+
+size_t PrimitiveShapeBatchRenderer::CalculateInstanceBufferSize(const InfoType& info) {
+    return CalculateInstanceSliceSize(info.GetMaxInstanceCount()) * info.GetBufferedFrameCount();
+}
+
+size_t PrimitiveShapeBatchRenderer::GetInstanceBufferAlignment() {
+    return alignof(InstanceData);
+}
+
+size_t PrimitiveShapeBatchRenderer::CalculateMemorySize(const InfoType& info) {
+    // vertex cache optimization only runs during Initialize, so its work memory is shared with
+    // the instance staging area
+    size_t workMemorySize = 0;
+    ForEachShape(info, [&](int, const PrimitiveShape* pShape) {
+        workMemorySize = std::max(workMemorySize, pShape->CalculateWorkMemorySize());
+    });
+
+    size_t stagingSize = sizeof(InstanceData) * info.GetMaxInstanceCount() +
+                         sizeof(uint8_t) * info.GetMaxInstanceCount();
+    return sizeof(ShapeRecord) * ShapeCount + sizeof(BatchRecord) * ShapeCount +
+           std::max(stagingSize, workMemorySize);
+}
+
+size_t PrimitiveShapeBatchRenderer::GetMemoryAlignment() {
+    return std::max(alignof(ShapeRecord), VertexCacheOptimizer::GetWorkMemoryAlignment());
+}
+
+PrimitiveShapeBatchRenderer::PrimitiveShapeBatchRenderer()
+    : m_pShapeBuffer(nullptr), m_ShapeBufferOffset(0), m_pInstanceBuffer(nullptr),
+      m_InstanceBufferOffset(0), m_pShapes(nullptr), m_pBatches(nullptr), m_pInstances(nullptr),
+      m_pInstanceShapes(nullptr), m_Stride(0), m_VertexBufferSize(0), m_MaxInstanceCount(0),
+      m_BufferedFrameCount(0), m_CurrentFrameIndex(0), m_InstanceCount(0),
+      m_DroppedInstanceCount(0) {
+    for (int idxAttribute = 0; idxAttribute < Attribute_End; ++idxAttribute) {
+        m_AttributeIndex[idxAttribute] = -1;
+    }
+}
+
+PrimitiveShapeBatchRenderer::~PrimitiveShapeBatchRenderer() {}
+
+void PrimitiveShapeBatchRenderer::Initialize(const InfoType& info, BufferType* pShapeBuffer,
+                                             ptrdiff_t shapeBufferOffset,
+                                             BufferType* pInstanceBuffer,
+                                             ptrdiff_t instanceBufferOffset, void* pMemory,
+                                             size_t memorySize) {
+    m_pShapeBuffer = pShapeBuffer;
+    m_ShapeBufferOffset = shapeBufferOffset;
+    m_pInstanceBuffer = pInstanceBuffer;
+    m_InstanceBufferOffset = instanceBufferOffset;
+    m_MaxInstanceCount = info.GetMaxInstanceCount();
+    m_BufferedFrameCount = info.GetBufferedFrameCount();
+    m_Stride = PrimitiveShapeVertexStateInfo::GetStride(info.GetVertexFormat());
+
+    nn::util::BytePtr ptr(pMemory);
+    m_pShapes = ptr.Get<ShapeRecord>();
+    m_pBatches = ptr.Advance(sizeof(ShapeRecord) * ShapeCount).Get<BatchRecord>();
+    void* pStagingMemory = ptr.Advance(sizeof(BatchRecord) * ShapeCount).Get();
+    size_t stagingMemorySize =
+        memorySize - (sizeof(ShapeRecord) + sizeof(BatchRecord)) * ShapeCount;
+    m_pInstances = static_cast<InstanceData*>(pStagingMemory);
+    m_pInstanceShapes = ptr.Advance(sizeof(InstanceData) * m_MaxInstanceCount).Get<uint8_t>();
+
+    m_VertexBufferSize = 0;
+    ForEachShape(info, [&](int, const PrimitiveShape* pShape) {
+        m_VertexBufferSize += pShape->GetVertexBufferSize();
+    });
+
+    nn::util::BytePtr shapeBuffer(m_pShapeBuffer->Map(), m_ShapeBufferOffset);
+    ptrdiff_t indexBufferOffset = nn::util::align_up(m_VertexBufferSize, ShapeBufferAlignment);
+    int baseVertex = 0;
+
+    ForEachShape(info, [&](int shapeIndex, PrimitiveShape* pShape) {
+        pShape->Calculate(nn::util::BytePtr(shapeBuffer.Get(), baseVertex * m_Stride).Get(),
+                          pShape->GetVertexBufferSize(),
+                          nn::util::BytePtr(shapeBuffer.Get(), indexBufferOffset).Get(),
+                          pShape->GetIndexBufferSize(), pStagingMemory, stagingMemorySize,
+                          nullptr);
+
+        ShapeRecord& shape = m_pShapes[shapeIndex];
+        shape.primitiveTopology = pShape->GetPrimitiveTopology();
+        shape.indexFormat = pShape->GetIndexBufferFormat();
+        shape.indexBufferOffset = indexBufferOffset;
+        shape.indexCount = pShape->GetIndexCount();
+        shape.baseVertex = baseVertex;
+
+        baseVertex += pShape->GetVertexCount();
+        indexBufferOffset +=
+            nn::util::align_up(pShape->GetIndexBufferSize(), ShapeBufferAlignment);
+    });
+
+    m_pShapeBuffer->FlushMappedRange(m_ShapeBufferOffset, indexBufferOffset);
+    m_pShapeBuffer->Unmap();
+
+    InitializeVertexState(info.GetVertexFormat());
+
+    std::memset(m_pBatches, 0, sizeof(BatchRecord) * ShapeCount);
+    m_CurrentFrameIndex = 0;
+    m_InstanceCount = 0;
+    m_DroppedInstanceCount = 0;
+}
+
+void PrimitiveShapeBatchRenderer::Finalize() {
+    m_pShapeBuffer = nullptr;
+    m_pInstanceBuffer = nullptr;
+    m_pShapes = nullptr;
+    m_pBatches = nullptr;
+    m_pInstances = nullptr;
+    m_pInstanceShapes = nullptr;
+    m_InstanceCount = 0;
+}
+
+void PrimitiveShapeBatchRenderer::InitializeVertexState(PrimitiveShapeFormat vertexFormat) {
+    const PrimitiveShapeFormat ShapeAttributeFlag[PrimitiveShapeVertexStateInfo::Attribute_End] =
+        {PrimitiveShapeFormat_Pos, PrimitiveShapeFormat_Normal, PrimitiveShapeFormat_Uv};
+
+    int attributeCount = 0;
+    for (int idxAttribute = 0; idxAttribute < Attribute_End; ++idxAttribute) {
+        VertexAttributeStateInfo& info = m_VertexAttributeStateInfo[attributeCount];
+
+        if (idxAttribute < PrimitiveShapeVertexStateInfo::Attribute_End) {
+            if (!(vertexFormat & ShapeAttributeFlag[idxAttribute])) {
+                m_AttributeIndex[idxAttribute] = -1;
+                continue;
+            }
+
+            PrimitiveShapeVertexStateInfo::Attribute attribute =
+                static_cast<PrimitiveShapeVertexStateInfo::Attribute>(idxAttribute);
+            info.SetDefault();
+            info.SetBufferIndex(VertexBufferIndex_Shape);
+            info.SetOffset(PrimitiveShapeVertexStateInfo::GetAttributeOffset(vertexFormat,
+                                                                             attribute));
+            info.SetFormat(PrimitiveShapeVertexStateInfo::GetAttributeFormat(vertexFormat,
+                                                                             attribute));
+        } else {
+            // transform rows are laid out back to back, followed by the color
+            info.SetDefault();
+            info.SetBufferIndex(VertexBufferIndex_Instance);
+            info.SetOffset(sizeof(nn::util::Float4) * (idxAttribute - Attribute_Transform0));
+            info.SetFormat(AttributeFormat_32_32_32_32_Float);
+        }
+
+        info.SetShaderSlot(idxAttribute);
+        m_AttributeIndex[idxAttribute] = attributeCount++;
+    }
+
+    m_VertexBufferStateInfo[VertexBufferIndex_Shape].SetDefault();
+    m_VertexBufferStateInfo[VertexBufferIndex_Shape].SetStride(m_Stride);
+    m_VertexBufferStateInfo[VertexBufferIndex_Instance].SetDefault();
+    m_VertexBufferStateInfo[VertexBufferIndex_Instance].SetStride(sizeof(InstanceData));
+    m_VertexBufferStateInfo[VertexBufferIndex_Instance].SetDivisor(1);
+
+    m_VertexStateInfo.SetDefault();
+    m_VertexStateInfo.SetVertexAttributeStateInfoArray(m_VertexAttributeStateInfo, attributeCount);
+    m_VertexStateInfo.SetVertexBufferStateInfoArray(m_VertexBufferStateInfo,
+                                                    VertexBufferIndex_End);
+}
+
+void PrimitiveShapeBatchRenderer::SetShaderSlot(Attribute attribute, int shaderSlot) {
+    if (m_AttributeIndex[attribute] >= 0) {
+        m_VertexAttributeStateInfo[m_AttributeIndex[attribute]].SetShaderSlot(shaderSlot);
+    }
+}
+
+void PrimitiveShapeBatchRenderer::Begin() {
+    m_CurrentFrameIndex = (m_CurrentFrameIndex + 1) % m_BufferedFrameCount;
+    m_InstanceCount = 0;
+    m_DroppedInstanceCount = 0;
+    std::memset(m_pBatches, 0, sizeof(BatchRecord) * ShapeCount);
+}
+
+int PrimitiveShapeBatchRenderer::AcquireInstances(ShapeType shapeType, DrawMode drawMode,
+                                                  int count) {
+    int acquiredCount = std::min(count, m_MaxInstanceCount - m_InstanceCount);
+    m_DroppedInstanceCount += count - acquiredCount;
+
+    int shapeIndex = GetShapeIndex(shapeType, drawMode);
+    std::memset(m_pInstanceShapes + m_InstanceCount, shapeIndex, acquiredCount);
+    m_pBatches[shapeIndex].instanceCount += acquiredCount;
+
+    int firstInstance = m_InstanceCount;
+    m_InstanceCount += acquiredCount;
+    return firstInstance;
+}
+
+int PrimitiveShapeBatchRenderer::AddInstances(ShapeType shapeType, DrawMode drawMode,
+                                              const nn::util::FloatColumnMajor4x3* pTransforms,
+                                              const nn::util::Float4* pColors, int count) {
+    int firstInstance = AcquireInstances(shapeType, drawMode, count);
+    int addedCount = m_InstanceCount - firstInstance;
+
+    for (int idx = 0; idx < addedCount; ++idx) {
+        InstanceData& instance = m_pInstances[firstInstance + idx];
+        instance.transform = pTransforms[idx];
+        instance.color = pColors[idx];
+    }
+    return addedCount;
+}
+
+int PrimitiveShapeBatchRenderer::AddInstances(ShapeType shapeType, DrawMode drawMode,
+                                              const nn::util::FloatColumnMajor4x3* pTransforms,
+                                              const nn::util::Float4& color, int count) {
+    int firstInstance = AcquireInstances(shapeType, drawMode, count);
+    int addedCount = m_InstanceCount - firstInstance;
+
+    for (int idx = 0; idx < addedCount; ++idx) {
+        InstanceData& instance = m_pInstances[firstInstance + idx];
+        instance.transform = pTransforms[idx];
+        instance.color = color;
+    }
+    return addedCount;
+}
+
+bool PrimitiveShapeBatchRenderer::AddInstance(ShapeType shapeType, DrawMode drawMode,
+                                              const nn::util::FloatColumnMajor4x3& transform,
+                                              const nn::util::Float4& color) {
+    return AddInstances(shapeType, drawMode, &transform, color, 1) == 1;
+}
+
+void PrimitiveShapeBatchRenderer::End() {
+    // counting sort by shape so every shape draws one contiguous instance range
+    int cursors[ShapeCount];
+    int baseInstance = 0;
+    for (int idxShape = 0; idxShape < ShapeCount; ++idxShape) {
+        m_pBatches[idxShape].baseInstance = baseInstance;
+        cursors[idxShape] = baseInstance;
+        baseInstance += m_pBatches[idxShape].instanceCount;
+    }
+
+    ptrdiff_t sliceOffset = GetInstanceSliceOffset();
+    InstanceData* pDst =
+        nn::util::BytePtr(m_pInstanceBuffer->Map(), sliceOffset).Get<InstanceData>();
+
+    int idxInstance = 0;
+    while (idxInstance < m_InstanceCount) {
+        // instances are usually added in runs of the same shape, copy each run at once
+        int shapeIndex = m_pInstanceShapes[idxInstance];
+        int runEnd = idxInstance + 1;
+        while (runEnd < m_InstanceCount && m_pInstanceShapes[runEnd] == shapeIndex) {
+            ++runEnd;
+        }
+
+        int runCount = runEnd - idxInstance;
+        std::memcpy(pDst + cursors[shapeIndex], m_pInstances + idxInstance,
+                    sizeof(InstanceData) * runCount);
+        cursors[shapeIndex] += runCount;
+        idxInstance = runEnd;
+    }
+
+    m_pInstanceBuffer->FlushMappedRange(sliceOffset, sizeof(InstanceData) * m_InstanceCount);
+    m_pInstanceBuffer->Unmap();
+}
+
+void PrimitiveShapeBatchRenderer::Draw(CommandBufferType* pCommandBuffer) const {
+    for (int idxMode = 0; idxMode < DrawMode_End; ++idxMode) {
+        Draw(pCommandBuffer, static_cast<DrawMode>(idxMode));
+    }
+}
+
+void PrimitiveShapeBatchRenderer::Draw(CommandBufferType* pCommandBuffer,
+                                       DrawMode drawMode) const {
+    int drawShapeBegin = GetShapeIndex(ShapeType_Sphere, drawMode);
+    int drawShapeEnd = drawShapeBegin + ShapeType_End;
+
+    int instanceCount = 0;
+    for (int idxShape = drawShapeBegin; idxShape < drawShapeEnd; ++idxShape) {
+        instanceCount += m_pBatches[idxShape].instanceCount;
+    }
+    if (instanceCount == 0) {
+        return;
+    }
+
+    GpuAddress shapeAddress;
+    m_pShapeBuffer->GetGpuAddress(&shapeAddress);
+    shapeAddress.Offset(m_ShapeBufferOffset);
+
+    GpuAddress instanceAddress;
+    m_pInstanceBuffer->GetGpuAddress(&instanceAddress);
+    instanceAddress.Offset(GetInstanceSliceOffset());
+
+    pCommandBuffer->SetVertexBuffer(VertexBufferIndex_Shape, shapeAddress, m_Stride,
+                                    m_VertexBufferSize);
+    pCommandBuffer->SetVertexBuffer(VertexBufferIndex_Instance, instanceAddress,
+                                    sizeof(InstanceData), sizeof(InstanceData) * m_InstanceCount);
+
+    for (int idxShape = drawShapeBegin; idxShape < drawShapeEnd; ++idxShape) {
+        const BatchRecord& batch = m_pBatches[idxShape];
+        if (batch.instanceCount == 0) {
+            continue;
+        }
+
+        const ShapeRecord& shape = m_pShapes[idxShape];
+        GpuAddress indexAddress = shapeAddress;
+        indexAddress.Offset(shape.indexBufferOffset);
+        pCommandBuffer->DrawIndexed(shape.primitiveTopology, shape.indexFormat, indexAddress,
+                                    shape.indexCount, shape.baseVertex, batch.instanceCount,
+                                    batch.baseInstance);
+    }
+}
+
+ptrdiff_t PrimitiveShapeBatchRenderer::GetInstanceSliceOffset() const {
+    return m_InstanceBufferOffset +
+           CalculateInstanceSliceSize(m_MaxInstanceCount) * m_CurrentFrameIndex;
+}
+
+int PrimitiveShapeBatchRenderer::GetInstanceCount(ShapeType shapeType, DrawMode drawMode) const {
+    return m_pBatches[GetShapeIndex(shapeType, drawMode)].instanceCount;
+}
+
+int PrimitiveShapeBatchRenderer::GetDrawCount() const {
+    int drawCount = 0;
+    for (int idxShape = 0; idxShape < ShapeCount; ++idxShape) {
+        if (m_pBatches[idxShape].instanceCount > 0) {
+            ++drawCount;
+        }
+    }
+    return drawCount;
+}
+
+}  // namespace nn::gfx::util
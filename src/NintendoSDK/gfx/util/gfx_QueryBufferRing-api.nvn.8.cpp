@@ -0,0 +1,69 @@
+#include <nn/gfx/util/gfx_QueryBufferRing.h>
+
+#include <nn/gfx/detail/gfx_Buffer-api.nvn.8.h>
+#include <nn/gfx/gfx_GpuAddress.h>
+#include <nn/util/util_BytePtr.h>
+
+#include <cstring>
+
+#include "../detail/gfx_NvnHelper.h"
+
+namespace nn::gfx::util::detail {
+
+size_t QueryBufferRing::CalculateBufferSize(int reportCountPerSlice, int sliceCount) {
+    return sizeof(NVNcounterData) * reportCountPerSlice * sliceCount;
+}
+
+size_t QueryBufferRing::GetBufferAlignment() {
+    return sizeof(NVNcounterData);
+}
+
+QueryBufferRing::QueryBufferRing()
+    : m_pBuffer(nullptr), m_Offset(0), m_ReportCountPerSlice(0), m_SliceCount(0),
+      m_FrameCounter(0) {}
+
+void QueryBufferRing::Initialize(BufferType* pBuffer, ptrdiff_t offset, int reportCountPerSlice,
+                                 int sliceCount) {
+    m_pBuffer = pBuffer;
+    m_Offset = offset;
+    m_ReportCountPerSlice = reportCountPerSlice;
+    m_SliceCount = sliceCount;
+    m_FrameCounter = 0;
+}
+
+void QueryBufferRing::Finalize() {
+    m_pBuffer = nullptr;
+}
+
+void QueryBufferRing::ClearSlice(int sliceIndex) {
+    size_t sliceSize = sizeof(NVNcounterData) * m_ReportCountPerSlice;
+    ptrdiff_t offset = GetReportOffset(sliceIndex, 0);
+
+    std::memset(nn::util::BytePtr(m_pBuffer->Map(), offset).Get(), 0, sliceSize);
+    m_pBuffer->FlushMappedRange(offset, sliceSize);
+}
+
+bool QueryBufferRing::IsReportWritten(int sliceIndex, int reportIndex) const {
+    m_pBuffer->InvalidateMappedRange(GetReportOffset(sliceIndex, 0),
+                                     sizeof(NVNcounterData) * m_ReportCountPerSlice);
+
+    // a cleared slice holds zero until the GPU writes the report
+    return static_cast<const NVNcounterData*>(GetReport(sliceIndex, reportIndex))->timestamp != 0;
+}
+
+void QueryBufferRing::GetReportAddress(GpuAddress* pOutAddress, int sliceIndex,
+                                       int reportIndex) const {
+    m_pBuffer->GetGpuAddress(pOutAddress);
+    pOutAddress->Offset(GetReportOffset(sliceIndex, reportIndex));
+}
+
+const void* QueryBufferRing::GetReport(int sliceIndex, int reportIndex) const {
+    return nn::util::BytePtr(m_pBuffer->Map(), GetReportOffset(sliceIndex, reportIndex)).Get();
+}
+
+ptrdiff_t QueryBufferRing::GetReportOffset(int sliceIndex, int reportIndex) const {
+    return m_Offset +
+           sizeof(NVNcounterData) * (m_ReportCountPerSlice * sliceIndex + reportIndex);
+}
+
+}  // namespace nn::gfx::util::detail
@@ -0,0 +1,139 @@
+#include <nn/gfx/util/gfx_TextureLayoutCache.h>
+
+#include <nn/gfx/detail/gfx_Texture-api.nvn.8.h>
+#include <nn/gfx/gfx_ResTexture.h>
+#include <nn/gfx/gfx_TextureInfo.h>
+#include <nn/util/util_BytePtr.h>
+
+#include <algorithm>
+#include <cstring>
+
+namespace nn::gfx::util {
+
+struct TextureLayoutCache::Entry {
+    TextureInfoData key;
+    TextureLayout layout;
+};
+
+namespace {
+
+TextureInfoData MakeTextureKey(const TextureInfo& info) {
+    // reserved bytes are left to the caller and must not take part in the comparison
+    const TextureInfoData& data = info.ToData();
+
+    TextureInfoData key;
+    std::memset(&key, 0, sizeof(key));
+    key.flags = data.flags;
+    key.imageStorageDimension = data.imageStorageDimension;
+    key.tileMode = data.tileMode;
+    key.swizzle = data.swizzle;
+    key.mipCount = data.mipCount;
+    key.multisampleCount = data.multisampleCount;
+    key.imageFormat = data.imageFormat;
+    key.gpuAccessFlags = data.gpuAccessFlags;
+    key.width = data.width;
+    key.height = data.height;
+    key.depth = data.depth;
+    key.arrayLength = data.arrayLength;
+    std::memcpy(key.textureLayout, data.textureLayout, sizeof(key.textureLayout));
+    return key;
+}
+
+}  // namespace
+
+size_t TextureLayoutCache::CalculateMemorySize(int maxEntryCount) {
+    int bucketCount = detail::ObjectCacheIndex::CalculateBucketCount(maxEntryCount);
+    return sizeof(Entry) * maxEntryCount + (sizeof(int32_t) + sizeof(uint32_t)) * bucketCount;
+}
+
+size_t TextureLayoutCache::GetMemoryAlignment() {
+    return alignof(Entry);
+}
+
+TextureLayoutCache::TextureLayoutCache()
+    : m_pDevice(nullptr), m_pEntries(nullptr), m_MaxEntryCount(0), m_EntryCount(0),
+      m_HitCount(0), m_MissCount(0) {}
+
+TextureLayoutCache::~TextureLayoutCache() {}
+
+void TextureLayoutCache::Initialize(DeviceType* pDevice, int maxEntryCount, void* pMemory,
+                                    [[maybe_unused]] size_t memorySize) {
+    int bucketCount = detail::ObjectCacheIndex::CalculateBucketCount(maxEntryCount);
+
+    nn::util::BytePtr ptr(pMemory);
+    m_pEntries = ptr.Get<Entry>();
+    int32_t* pBuckets = ptr.Advance(sizeof(Entry) * maxEntryCount).Get<int32_t>();
+    uint32_t* pHashes = ptr.Advance(sizeof(int32_t) * bucketCount).Get<uint32_t>();
+
+    m_pDevice = pDevice;
+    m_MaxEntryCount = maxEntryCount;
+    m_Index.Initialize(pBuckets, pHashes, bucketCount);
+    Clear();
+}
+
+void TextureLayoutCache::Finalize() {
+    m_pDevice = nullptr;
+    m_pEntries = nullptr;
+    m_MaxEntryCount = 0;
+    m_EntryCount = 0;
+}
+
+void TextureLayoutCache::Clear() {
+    m_Index.Clear();
+    m_EntryCount = 0;
+    m_HitCount = 0;
+    m_MissCount = 0;
+}
+
+bool TextureLayoutCache::Calculate(TextureLayout* pOutLayout, const TextureInfo& info) {
+    if (info.GetMipCount() > TextureLayout::MaxMipCount) {
+        return false;
+    }
+
+    TextureInfoData key = MakeTextureKey(info);
+    uint32_t hash = detail::CalculateObjectCacheHash(&key, sizeof(key));
+
+    int entryIndex = m_Index.Find(hash, [&](int idx) {
+        return std::memcmp(&m_pEntries[idx].key, &key, sizeof(key)) == 0;
+    });
+
+    if (entryIndex != detail::ObjectCacheIndex::InvalidIndex) {
+        *pOutLayout = m_pEntries[entryIndex].layout;
+        ++m_HitCount;
+        return true;
+    }
+
+    typedef gfx::detail::TextureImpl<ApiVariationNvn8> TextureType;
+    pOutLayout->mipDataSize = TextureType::CalculateMipDataSize(m_pDevice, info);
+    pOutLayout->mipDataAlignment = TextureType::CalculateMipDataAlignment(m_pDevice, info);
+    pOutLayout->rowPitch = TextureType::GetRowPitch(m_pDevice, info);
+    pOutLayout->mipCount = info.GetMipCount();
+    TextureType::CalculateMipDataOffsets(pOutLayout->mipOffsets, m_pDevice, info);
+    ++m_MissCount;
+
+    if (m_EntryCount < m_MaxEntryCount) {
+        Entry& entry = m_pEntries[m_EntryCount];
+        entry.key = key;
+        entry.layout = *pOutLayout;
+        m_Index.Insert(hash, m_EntryCount);
+        ++m_EntryCount;
+    }
+    return true;
+}
+
+int TextureLayoutCache::Calculate(TextureLayout* pOutLayouts, int layoutCount,
+                                  const ResTextureFile* pResTextureFile) {
+    int textureCount = std::min(layoutCount, pResTextureFile->GetTextureCount());
+
+    int writtenCount = 0;
+    for (int idxTexture = 0; idxTexture < textureCount; ++idxTexture) {
+        const TextureInfo* pInfo = pResTextureFile->GetResTexture(idxTexture)->GetTextureInfo();
+        if (!Calculate(&pOutLayouts[writtenCount], *pInfo)) {
+            break;
+        }
+        ++writtenCount;
+    }
+    return writtenCount;
+}
+
+}  // namespace nn::gfx::util
@@ -0,0 +1,228 @@
+#include <nn/gfx/util/gfx_TextureUploadQueue.h>
+
+#include <nn/gfx/detail/gfx_Buffer-api.nvn.8.h>
+#include <nn/gfx/detail/gfx_CommandBuffer-api.nvn.8.h>
+#include <nn/gfx/detail/gfx_Sync-api.nvn.8.h>
+#include <nn/gfx/detail/gfx_Texture-api.nvn.8.h>
+#include <nn/gfx/gfx_TextureInfo.h>
+#include <nn/util/util_BytePtr.h>
+
+#include <algorithm>
+#include <cstring>
+
+#include "../detail/gfx_NvnCopyHelper.h"
+#include "../detail/gfx_NvnHelper.h"
+
+namespace nn::gfx::util {
+
+struct TextureUploadQueue::Request {
+    TextureType* pDstTexture;
+    BufferTextureCopyRegion copyRegion;
+    ptrdiff_t rowStride;
+    ptrdiff_t imageStride;
+};
+
+struct TextureUploadQueue::Batch {
+    const FenceType* pFence;
+    uint64_t stagingEnd;
+};
+
+namespace {
+
+// covers the largest texel block so every format can copy from any staging offset
+const size_t StagingAlignment = 16;
+
+}  // namespace
+
+size_t TextureUploadQueue::CalculateMemorySize(const InfoType& info) {
+    // the int array comes last so it cannot break the alignment of the batches
+    return sizeof(Request) * info.GetMaxRequestCount() + sizeof(Batch) * info.GetMaxBatchCount() +
+           sizeof(int) * info.GetMaxRequestCount();
+}
+
+size_t TextureUploadQueue::GetMemoryAlignment() {
+    return alignof(Request);
+}
+
+size_t TextureUploadQueue::GetStagingBufferAlignment() {
+    return StagingAlignment;
+}
+
+TextureUploadQueue::TextureUploadQueue()
+    : m_pStagingBuffer(nullptr), m_StagingBufferOffset(0), m_StagingBufferSize(0),
+      m_StagingBegin(0), m_StagingEnd(0), m_pRequests(nullptr), m_pSortedRequests(nullptr),
+      m_pBatches(nullptr), m_MaxRequestCount(0), m_MaxBatchCount(0), m_RequestCount(0),
+      m_FirstBatch(0), m_BatchCount(0), m_RowStrideChangeCount(0) {}
+
+TextureUploadQueue::~TextureUploadQueue() {}
+
+void TextureUploadQueue::Initialize(const InfoType& info, BufferType* pStagingBuffer,
+                                    ptrdiff_t stagingBufferOffset, void* pMemory,
+                                    [[maybe_unused]] size_t memorySize) {
+    m_pStagingBuffer = pStagingBuffer;
+    m_StagingBufferOffset = stagingBufferOffset;
+    m_StagingBufferSize = info.GetStagingBufferSize();
+    m_MaxRequestCount = info.GetMaxRequestCount();
+    m_MaxBatchCount = info.GetMaxBatchCount();
+
+    nn::util::BytePtr ptr(pMemory);
+    m_pRequests = ptr.Get<Request>();
+    m_pBatches = ptr.Advance(sizeof(Request) * m_MaxRequestCount).Get<Batch>();
+    m_pSortedRequests = ptr.Advance(sizeof(Batch) * m_MaxBatchCount).Get<int>();
+
+    m_StagingBegin = 0;
+    m_StagingEnd = 0;
+    m_RequestCount = 0;
+    m_FirstBatch = 0;
+    m_BatchCount = 0;
+    m_RowStrideChangeCount = 0;
+}
+
+void TextureUploadQueue::Finalize() {
+    m_pStagingBuffer = nullptr;
+    m_pRequests = nullptr;
+    m_pSortedRequests = nullptr;
+    m_pBatches = nullptr;
+    m_RequestCount = 0;
+    m_BatchCount = 0;
+}
+
+bool TextureUploadQueue::AllocateStaging(ptrdiff_t* pOutOffset, size_t size) {
+    // begin and end only grow, positions in the ring are taken modulo its size
+    size = nn::util::align_up(size, StagingAlignment);
+    size_t position = static_cast<size_t>(m_StagingEnd % m_StagingBufferSize);
+    size_t padding = position + size > m_StagingBufferSize ? m_StagingBufferSize - position : 0;
+
+    if (GetStagingUsedSize() + padding + size > m_StagingBufferSize) {
+        return false;
+    }
+
+    m_StagingEnd += padding;
+    *pOutOffset = static_cast<ptrdiff_t>(m_StagingEnd % m_StagingBufferSize);
+    m_StagingEnd += size;
+    return true;
+}
+
+bool TextureUploadQueue::Upload(TextureType* pDstTexture,
+                                const BufferTextureCopyRegion& copyRegion, const void* pData,
+                                size_t dataSize) {
+    ptrdiff_t dataOffset = copyRegion.GetBufferOffset();
+    if (m_RequestCount >= m_MaxRequestCount || dataOffset < 0 ||
+        static_cast<size_t>(dataOffset) >= dataSize) {
+        return false;
+    }
+
+    size_t copySize = dataSize - dataOffset;
+    ptrdiff_t stagingOffset;
+    if (!AllocateStaging(&stagingOffset, copySize)) {
+        return false;
+    }
+
+    ptrdiff_t bufferOffset = m_StagingBufferOffset + stagingOffset;
+    std::memcpy(nn::util::BytePtr(m_pStagingBuffer->Map(), bufferOffset).Get(),
+                nn::util::ConstBytePtr(pData, dataOffset).Get(), copySize);
+    m_pStagingBuffer->FlushMappedRange(bufferOffset, copySize);
+
+    Request& request = m_pRequests[m_RequestCount];
+    request.pDstTexture = pDstTexture;
+    request.copyRegion = copyRegion;
+    request.copyRegion.SetBufferOffset(static_cast<int>(bufferOffset));
+    gfx::detail::GetNvnCopyStride(&request.rowStride, &request.imageStride, request.copyRegion,
+                                  pDstTexture->ToData()->pNvnTexture);
+
+    m_pSortedRequests[m_RequestCount] = m_RequestCount;
+    ++m_RequestCount;
+    return true;
+}
+
+int TextureUploadQueue::Record(CommandBufferType* pCommandBuffer, const FenceType* pFence) {
+    m_RowStrideChangeCount = 0;
+    if (m_RequestCount == 0) {
+        return 0;
+    }
+
+    Retire();
+    if (m_BatchCount >= m_MaxBatchCount) {
+        return 0;
+    }
+
+    // grouping by texture and level keeps consecutive copies on the same stride
+    std::sort(m_pSortedRequests, m_pSortedRequests + m_RequestCount, [this](int lhs, int rhs) {
+        const Request& left = m_pRequests[lhs];
+        const Request& right = m_pRequests[rhs];
+        if (left.pDstTexture != right.pDstTexture) {
+            return left.pDstTexture < right.pDstTexture;
+        }
+        int leftLevel = left.copyRegion.GetTextureCopyRegion().GetSubresource().GetMipLevel();
+        int rightLevel = right.copyRegion.GetTextureCopyRegion().GetSubresource().GetMipLevel();
+        if (leftLevel != rightLevel) {
+            return leftLevel < rightLevel;
+        }
+        if (left.rowStride != right.rowStride) {
+            return left.rowStride < right.rowStride;
+        }
+        return left.imageStride < right.imageStride;
+    });
+
+    NVNcommandBuffer* pNvnCommandBuffer = pCommandBuffer->ToData()->pNvnCommandBuffer;
+    NVNbufferAddress stagingAddress = nvnBufferGetAddress(m_pStagingBuffer->ToData()->pNvnBuffer);
+
+    // CommandBufferImpl copies always set both strides, so the state left behind is harmless
+    ptrdiff_t rowStride = -1;
+    ptrdiff_t imageStride = -1;
+
+    for (int idx = 0; idx < m_RequestCount; ++idx) {
+        const Request& request = m_pRequests[m_pSortedRequests[idx]];
+        const TextureCopyRegion& dstRegion = request.copyRegion.GetTextureCopyRegion();
+        NVNtexture* pNvnTexture = request.pDstTexture->ToData()->pNvnTexture;
+
+        NVNcopyRegion region;
+        gfx::detail::GetNvnCopyRegion(&region.yoffset, &region.height, &region.zoffset,
+                                      &region.depth, dstRegion, nvnTextureGetTarget(pNvnTexture));
+        region.xoffset = dstRegion.GetOffsetU();
+        region.width = dstRegion.GetWidth();
+
+        NVNtextureView view;
+        nvnTextureViewSetDefaults(&view);
+        nvnTextureViewSetLevels(&view, dstRegion.GetSubresource().GetMipLevel(), 1);
+
+        if (request.rowStride != rowStride) {
+            rowStride = request.rowStride;
+            nvnCommandBufferSetCopyRowStride(pNvnCommandBuffer, rowStride);
+            ++m_RowStrideChangeCount;
+        }
+        if (request.imageStride != imageStride) {
+            imageStride = request.imageStride;
+            nvnCommandBufferSetCopyImageStride(pNvnCommandBuffer, imageStride);
+        }
+
+        nvnCommandBufferCopyBufferToTexture(
+            pNvnCommandBuffer, stagingAddress + request.copyRegion.GetBufferOffset(), pNvnTexture,
+            &view, &region, NVN_COPY_FLAGS_NONE);
+    }
+
+    Batch& batch = m_pBatches[(m_FirstBatch + m_BatchCount) % m_MaxBatchCount];
+    batch.pFence = pFence;
+    batch.stagingEnd = m_StagingEnd;
+    ++m_BatchCount;
+
+    int recordedCount = m_RequestCount;
+    m_RequestCount = 0;
+    return recordedCount;
+}
+
+void TextureUploadQueue::Retire() {
+    while (m_BatchCount > 0) {
+        const Batch& batch = m_pBatches[m_FirstBatch];
+        if (!batch.pFence->IsSignaled()) {
+            break;
+        }
+
+        // pending requests were allocated after this batch and stay untouched
+        m_StagingBegin = batch.stagingEnd;
+        m_FirstBatch = (m_FirstBatch + 1) % m_MaxBatchCount;
+        --m_BatchCount;
+    }
+}
+
+}  // namespace nn::gfx::util
@@ -0,0 +1,271 @@
+#include <nn/gfx/util/gfx_VertexCacheOptimizer.h>
+
+#include <nn/util/util_BytePtr.h>
+
+#include <algorithm>
+#include <cstring>
+
+namespace nn::gfx::util {
+
+namespace {
+
+uint32_t ReadIndex(const void* pIndexBuffer, IndexFormat indexFormat, int index) {
+    switch (indexFormat) {
+    case IndexFormat_Uint8:
+        return static_cast<const uint8_t*>(pIndexBuffer)[index];
+
+    case IndexFormat_Uint16:
+        return static_cast<const uint16_t*>(pIndexBuffer)[index];
+
+    case IndexFormat_Uint32:
+        return static_cast<const uint32_t*>(pIndexBuffer)[index];
+
+    default:
+        NN_UNEXPECTED_DEFAULT;
+        return 0;
+    }
+}
+
+void WriteIndex(void* pIndexBuffer, IndexFormat indexFormat, int index, uint32_t value) {
+    switch (indexFormat) {
+    case IndexFormat_Uint8:
+        static_cast<uint8_t*>(pIndexBuffer)[index] = static_cast<uint8_t>(value);
+        break;
+
+    case IndexFormat_Uint16:
+        static_cast<uint16_t*>(pIndexBuffer)[index] = static_cast<uint16_t>(value);
+        break;
+
+    case IndexFormat_Uint32:
+        static_cast<uint32_t*>(pIndexBuffer)[index] = value;
+        break;
+
+    default:
+        NN_UNEXPECTED_DEFAULT;
+        break;
+    }
+}
+
+size_t CalculateIndexWorkMemorySize(int vertexCount, int indexCount) {
+    // source indices, adjacency offsets, adjacency, live counts, cache stamps, dead-end stack,
+    // emitted flags
+    return sizeof(uint32_t) * indexCount + sizeof(int32_t) * (vertexCount + 1) +
+           sizeof(int32_t) * indexCount + sizeof(int32_t) * vertexCount * 2 +
+           sizeof(int32_t) * indexCount + sizeof(uint8_t) * (indexCount / 3);
+}
+
+size_t CalculateVertexWorkMemorySize(int vertexCount, size_t stride) {
+    return sizeof(int32_t) * vertexCount + stride * vertexCount;
+}
+
+}  // namespace
+
+size_t VertexCacheOptimizer::CalculateWorkMemorySize(int vertexCount, int indexCount,
+                                                     size_t stride) {
+    return std::max(CalculateIndexWorkMemorySize(vertexCount, indexCount),
+                    CalculateVertexWorkMemorySize(vertexCount, stride));
+}
+
+size_t VertexCacheOptimizer::GetWorkMemoryAlignment() {
+    return alignof(int32_t);
+}
+
+float VertexCacheOptimizer::CalculateAcmr(const void* pIndexBuffer, IndexFormat indexFormat,
+                                          int indexCount, int cacheSize) {
+    int triangleCount = indexCount / 3;
+    if (triangleCount == 0) {
+        return 0.0f;
+    }
+
+    cacheSize = std::min(std::max(cacheSize, 1), static_cast<int>(MaxCacheSize));
+
+    uint32_t cache[MaxCacheSize];
+    int cacheCount = 0;
+    int cacheHead = 0;
+    int missCount = 0;
+
+    for (int idx = 0; idx < triangleCount * 3; ++idx) {
+        uint32_t vertex = ReadIndex(pIndexBuffer, indexFormat, idx);
+        if (std::find(cache, cache + cacheCount, vertex) != cache + cacheCount) {
+            continue;
+        }
+
+        ++missCount;
+        if (cacheCount < cacheSize) {
+            cache[cacheCount++] = vertex;
+        } else {
+            cache[cacheHead] = vertex;
+            cacheHead = (cacheHead + 1) % cacheSize;
+        }
+    }
+
+    return static_cast<float>(missCount) / triangleCount;
+}
+
+void VertexCacheOptimizer::OptimizeIndexBuffer(void* pIndexBuffer, IndexFormat indexFormat,
+                                               int indexCount, int vertexCount, int cacheSize,
+                                               void* pWorkMemory,
+                                               [[maybe_unused]] size_t workMemorySize) {
+    const int triangleCount = indexCount / 3;
+    if (triangleCount == 0 || vertexCount == 0) {
+        return;
+    }
+
+    nn::util::BytePtr ptr(pWorkMemory);
+    uint32_t* pSource = ptr.Get<uint32_t>();
+    int32_t* pOffsets = ptr.Advance(sizeof(uint32_t) * indexCount).Get<int32_t>();
+    int32_t* pAdjacency = ptr.Advance(sizeof(int32_t) * (vertexCount + 1)).Get<int32_t>();
+    int32_t* pLiveCounts = ptr.Advance(sizeof(int32_t) * indexCount).Get<int32_t>();
+    int32_t* pCacheStamps = ptr.Advance(sizeof(int32_t) * vertexCount).Get<int32_t>();
+    int32_t* pDeadEnds = ptr.Advance(sizeof(int32_t) * vertexCount).Get<int32_t>();
+    uint8_t* pEmitted = ptr.Advance(sizeof(int32_t) * indexCount).Get<uint8_t>();
+
+    for (int idx = 0; idx < triangleCount * 3; ++idx) {
+        pSource[idx] = ReadIndex(pIndexBuffer, indexFormat, idx);
+    }
+
+    // vertex to triangle adjacency
+    std::fill(pLiveCounts, pLiveCounts + vertexCount, 0);
+    for (int idx = 0; idx < triangleCount * 3; ++idx) {
+        ++pLiveCounts[pSource[idx]];
+    }
+    pOffsets[0] = 0;
+    for (int idxVertex = 0; idxVertex < vertexCount; ++idxVertex) {
+        pOffsets[idxVertex + 1] = pOffsets[idxVertex] + pLiveCounts[idxVertex];
+        pCacheStamps[idxVertex] = pOffsets[idxVertex];
+    }
+    for (int idx = 0; idx < triangleCount * 3; ++idx) {
+        pAdjacency[pCacheStamps[pSource[idx]]++] = idx / 3;
+    }
+
+    std::fill(pCacheStamps, pCacheStamps + vertexCount, 0);
+    std::fill(pEmitted, pEmitted + triangleCount, 0);
+
+    int deadEndCount = 0;
+    int outputCount = 0;
+    int timeStamp = cacheSize + 1;
+    int cursor = 1;
+    int fanningVertex = 0;
+
+    while (fanningVertex >= 0) {
+        // vertices pushed during this fan are the candidates for the next fanning vertex
+        int candidateBegin = deadEndCount;
+
+        for (int idxAdjacency = pOffsets[fanningVertex];
+             idxAdjacency < pOffsets[fanningVertex + 1]; ++idxAdjacency) {
+            int triangle = pAdjacency[idxAdjacency];
+            if (pEmitted[triangle]) {
+                continue;
+            }
+
+            for (int idxCorner = 0; idxCorner < 3; ++idxCorner) {
+                uint32_t vertex = pSource[triangle * 3 + idxCorner];
+                WriteIndex(pIndexBuffer, indexFormat, outputCount++, vertex);
+                pDeadEnds[deadEndCount++] = vertex;
+                --pLiveCounts[vertex];
+                if (timeStamp - pCacheStamps[vertex] > cacheSize) {
+                    pCacheStamps[vertex] = timeStamp++;
+                }
+            }
+            pEmitted[triangle] = 1;
+        }
+
+        int nextVertex = -1;
+        int bestPriority = -1;
+        for (int idxCandidate = candidateBegin; idxCandidate < deadEndCount; ++idxCandidate) {
+            int vertex = pDeadEnds[idxCandidate];
+            if (pLiveCounts[vertex] <= 0) {
+                continue;
+            }
+
+            // prefer the oldest vertex that will still be in the cache once its fan is emitted
+            int priority = 0;
+            if (timeStamp - pCacheStamps[vertex] + 2 * pLiveCounts[vertex] <= cacheSize) {
+                priority = timeStamp - pCacheStamps[vertex];
+            }
+            if (priority > bestPriority) {
+                bestPriority = priority;
+                nextVertex = vertex;
+            }
+        }
+
+        if (nextVertex < 0) {
+            while (deadEndCount > 0) {
+                int vertex = pDeadEnds[--deadEndCount];
+                if (pLiveCounts[vertex] > 0) {
+                    nextVertex = vertex;
+                    break;
+                }
+            }
+        }
+
+        if (nextVertex < 0) {
+            while (cursor < vertexCount) {
+                if (pLiveCounts[cursor] > 0) {
+                    nextVertex = cursor;
+                    break;
+                }
+                ++cursor;
+            }
+        }
+
+        fanningVertex = nextVertex;
+    }
+}
+
+void VertexCacheOptimizer::OptimizeVertexFetch(void* pVertexBuffer, size_t stride,
+                                               int vertexCount, void* pIndexBuffer,
+                                               IndexFormat indexFormat, int indexCount,
+                                               void* pWorkMemory,
+                                               [[maybe_unused]] size_t workMemorySize) {
+    if (vertexCount == 0) {
+        return;
+    }
+
+    nn::util::BytePtr ptr(pWorkMemory);
+    int32_t* pRemap = ptr.Get<int32_t>();
+    void* pVertexCopy = ptr.Advance(sizeof(int32_t) * vertexCount).Get();
+
+    std::fill(pRemap, pRemap + vertexCount, -1);
+
+    int nextVertex = 0;
+    for (int idx = 0; idx < indexCount; ++idx) {
+        uint32_t vertex = ReadIndex(pIndexBuffer, indexFormat, idx);
+        if (pRemap[vertex] < 0) {
+            pRemap[vertex] = nextVertex++;
+        }
+        WriteIndex(pIndexBuffer, indexFormat, idx, pRemap[vertex]);
+    }
+
+    // unreferenced vertices keep their relative order at the end of the buffer
+    for (int idxVertex = 0; idxVertex < vertexCount; ++idxVertex) {
+        if (pRemap[idxVertex] < 0) {
+            pRemap[idxVertex] = nextVertex++;
+        }
+    }
+
+    std::memcpy(pVertexCopy, pVertexBuffer, stride * vertexCount);
+    for (int idxVertex = 0; idxVertex < vertexCount; ++idxVertex) {
+        std::memcpy(nn::util::BytePtr(pVertexBuffer, stride * pRemap[idxVertex]).Get(),
+                    nn::util::BytePtr(pVertexCopy, stride * idxVertex).Get(), stride);
+    }
+}
+
+void VertexCacheOptimizer::Optimize(VertexCacheStatistics* pOutStatistics, void* pVertexBuffer,
+                                    size_t stride, int vertexCount, void* pIndexBuffer,
+                                    IndexFormat indexFormat, int indexCount, int cacheSize,
+                                    void* pWorkMemory, size_t workMemorySize) {
+    float acmrBefore = CalculateAcmr(pIndexBuffer, indexFormat, indexCount, cacheSize);
+
+    OptimizeIndexBuffer(pIndexBuffer, indexFormat, indexCount, vertexCount, cacheSize,
+                        pWorkMemory, workMemorySize);
+    OptimizeVertexFetch(pVertexBuffer, stride, vertexCount, pIndexBuffer, indexFormat, indexCount,
+                        pWorkMemory, workMemorySize);
+
+    if (pOutStatistics != nullptr) {
+        pOutStatistics->acmrBefore = acmrBefore;
+        pOutStatistics->acmrAfter = CalculateAcmr(pIndexBuffer, indexFormat, indexCount, cacheSize);
+    }
+}
+
+}  // namespace nn::gfx::util
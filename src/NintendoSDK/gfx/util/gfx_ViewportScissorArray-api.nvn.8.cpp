@@ -0,0 +1,128 @@
+#include <nn/gfx/util/gfx_ViewportScissorArray.h>
+
+#include <nn/gfx/detail/gfx_CommandBuffer-api.nvn.8.h>
+
+#include <algorithm>
+#include <cstring>
+
+#include <nvn/nvn_FuncPtrInline.h>
+
+namespace nn::gfx::util {
+
+namespace {
+
+const int ScissorDisabledSize = 0x7FFFFFFF;
+
+bool IsValidRange(int first, int count, int maxCount) {
+    return first >= 0 && count >= 0 && first + count <= maxCount;
+}
+
+}  // namespace
+
+ViewportScissorArray::ViewportScissorArray() : m_ViewportCount(0), m_ScissorCount(0) {}
+
+bool ViewportScissorArray::Initialize(const ViewportScissorStateInfo& info) {
+    int viewportCount = info.GetViewportCount();
+    if (!IsValidRange(0, viewportCount, MaxViewportCount)) {
+        return false;
+    }
+
+    m_ViewportCount = 0;
+    m_ScissorCount = 0;
+    SetViewports(0, viewportCount, info.GetViewportStateInfoArray());
+
+    // like ViewportScissorStateImpl, every viewport gets a scissor
+    if (info.IsScissorEnabled()) {
+        SetScissors(0, viewportCount, info.GetScissorStateInfoArray());
+    } else {
+        for (int idx = 0; idx < viewportCount; ++idx) {
+            DisableScissor(idx);
+        }
+    }
+    return true;
+}
+
+bool ViewportScissorArray::SetViewports(int firstViewport, int viewportCount,
+                                        const ViewportStateInfo* pViewports) {
+    if (!IsValidRange(firstViewport, viewportCount, MaxViewportCount)) {
+        return false;
+    }
+
+    for (int idx = 0; idx < viewportCount; ++idx) {
+        // origin and size are laid out like NVN's float4, copy them as one block
+        const ViewportStateInfoData& viewport = pViewports[idx].ToData();
+        std::memcpy(m_Viewports[firstViewport + idx], &viewport.originX, sizeof(float) * 4);
+        m_DepthRanges[firstViewport + idx][0] = viewport.depthRange.minDepth;
+        m_DepthRanges[firstViewport + idx][1] = viewport.depthRange.maxDepth;
+    }
+
+    m_ViewportCount = std::max(m_ViewportCount, firstViewport + viewportCount);
+    return true;
+}
+
+bool ViewportScissorArray::SetScissors(int firstScissor, int scissorCount,
+                                       const ScissorStateInfo* pScissors) {
+    if (!IsValidRange(firstScissor, scissorCount, MaxViewportCount)) {
+        return false;
+    }
+
+    for (int idx = 0; idx < scissorCount; ++idx) {
+        std::memcpy(m_Scissors[firstScissor + idx], &pScissors[idx].ToData()->originX,
+                    sizeof(int) * 4);
+    }
+
+    m_ScissorCount = std::max(m_ScissorCount, firstScissor + scissorCount);
+    return true;
+}
+
+bool ViewportScissorArray::SetViewport(int index, float originX, float originY, float width,
+                                       float height, float minDepth, float maxDepth) {
+    if (!IsValidRange(index, 1, MaxViewportCount)) {
+        return false;
+    }
+
+    float* pViewport = m_Viewports[index];
+    pViewport[0] = originX;
+    pViewport[1] = originY;
+    pViewport[2] = width;
+    pViewport[3] = height;
+    m_DepthRanges[index][0] = minDepth;
+    m_DepthRanges[index][1] = maxDepth;
+
+    m_ViewportCount = std::max(m_ViewportCount, index + 1);
+    return true;
+}
+
+bool ViewportScissorArray::SetScissor(int index, int originX, int originY, int width,
+                                      int height) {
+    if (!IsValidRange(index, 1, MaxViewportCount)) {
+        return false;
+    }
+
+    int* pScissor = m_Scissors[index];
+    pScissor[0] = originX;
+    pScissor[1] = originY;
+    pScissor[2] = width;
+    pScissor[3] = height;
+
+    m_ScissorCount = std::max(m_ScissorCount, index + 1);
+    return true;
+}
+
+bool ViewportScissorArray::DisableScissor(int index) {
+    return SetScissor(index, 0, 0, ScissorDisabledSize, ScissorDisabledSize);
+}
+
+void ViewportScissorArray::Bind(CommandBufferType* pCommandBuffer) const {
+    NVNcommandBuffer* pNvnCommandBuffer = pCommandBuffer->ToData()->pNvnCommandBuffer;
+
+    if (m_ViewportCount > 0) {
+        nvnCommandBufferSetViewports(pNvnCommandBuffer, 0, m_ViewportCount, m_Viewports[0]);
+        nvnCommandBufferSetDepthRanges(pNvnCommandBuffer, 0, m_ViewportCount, m_DepthRanges[0]);
+    }
+    if (m_ScissorCount > 0) {
+        nvnCommandBufferSetScissors(pNvnCommandBuffer, 0, m_ScissorCount, m_Scissors[0]);
+    }
+}
+
+}  // namespace nn::gfx::util
@@ -0,0 +1,363 @@
+#include <nn/gfx/util/gfx_VirtualTextureTileManager.h>
+
+#include <nn/gfx/detail/gfx_MemoryPool-api.nvn.8.h>
+#include <nn/gfx/detail/gfx_Texture-api.nvn.8.h>
+#include <nn/gfx/gfx_TextureInfo.h>
+#include <nn/util/util_BytePtr.h>
+
+#include <algorithm>
+#include <cstring>
+
+#include <nvn/nvn_FuncPtrInline.h>
+
+#include "../detail/gfx_CommonHelper.h"
+
+namespace nn::gfx::util {
+
+struct VirtualTextureTileManager::Page {
+    int32_t tileIndex;
+    int32_t prev;
+    int32_t next;
+    uint32_t lastUsedFrame;
+};
+
+struct VirtualTextureTileManager::Mapping {
+    NVNmappingRequest request;
+};
+
+struct VirtualTextureTileManager::TileLayout {
+    int tileWidth;
+    int tileHeight;
+    int sparseMipCount;
+    int tileCount;
+    int tileCountX[MaxMipCount];
+    int tileCountY[MaxMipCount];
+    int firstTileIndex[MaxMipCount];
+};
+
+namespace {
+
+// a tile that is pending in the request list, resident tiles hold their page index instead
+const int32_t TileRequested = -2;
+
+}  // namespace
+
+void VirtualTextureTileManager::CalculateTileLayout(TileLayout* pOutLayout, const InfoType& info,
+                                                    const TextureInfo& textureInfo) {
+    ChannelFormat channelFormat = gfx::detail::GetChannelFormat(textureInfo.GetImageFormat());
+    size_t blockCount = info.GetPageSize() / gfx::detail::GetBytePerPixel(channelFormat);
+
+    // the standard square-ish tile shapes: 256x256 for 1 byte texels down to 64x64 for 16 bytes
+    int blockCountLog2 = 0;
+    while ((static_cast<size_t>(2) << blockCountLog2) <= blockCount) {
+        ++blockCountLog2;
+    }
+    int tileBlockWidth = 1 << ((blockCountLog2 + 1) / 2);
+    int tileBlockHeight = static_cast<int>(blockCount / tileBlockWidth);
+
+    bool isCompressed = gfx::detail::IsCompressedFormat(channelFormat);
+    pOutLayout->tileWidth =
+        tileBlockWidth * (isCompressed ? gfx::detail::GetBlockWidth(channelFormat) : 1);
+    pOutLayout->tileHeight =
+        tileBlockHeight * (isCompressed ? gfx::detail::GetBlockHeight(channelFormat) : 1);
+
+    int mipCount = std::min(textureInfo.GetMipCount(), static_cast<int>(MaxMipCount));
+    pOutLayout->sparseMipCount = 0;
+    pOutLayout->tileCount = 0;
+    for (int mipLevel = 0; mipLevel < mipCount; ++mipLevel) {
+        int width = std::max(textureInfo.GetWidth() >> mipLevel, 1);
+        int height = std::max(textureInfo.GetHeight() >> mipLevel, 1);
+        if (width < pOutLayout->tileWidth || height < pOutLayout->tileHeight) {
+            break;
+        }
+
+        pOutLayout->tileCountX[mipLevel] =
+            (width + pOutLayout->tileWidth - 1) / pOutLayout->tileWidth;
+        pOutLayout->tileCountY[mipLevel] =
+            (height + pOutLayout->tileHeight - 1) / pOutLayout->tileHeight;
+        pOutLayout->firstTileIndex[mipLevel] = pOutLayout->tileCount;
+        pOutLayout->tileCount +=
+            pOutLayout->tileCountX[mipLevel] * pOutLayout->tileCountY[mipLevel];
+        ++pOutLayout->sparseMipCount;
+    }
+}
+
+size_t VirtualTextureTileManager::CalculateMemorySize(const InfoType& info,
+                                                      const TextureInfo& textureInfo) {
+    TileLayout layout;
+    CalculateTileLayout(&layout, info, textureInfo);
+
+    // every mapped tile may evict another one, which takes an unmapping request of its own
+    return sizeof(Mapping) * info.GetMaxRequestCount() * 2 +
+           sizeof(Page) * info.GetPhysicalPageCount() + sizeof(int32_t) * layout.tileCount +
+           sizeof(VirtualTextureTile) * info.GetMaxRequestCount() * 2;
+}
+
+size_t VirtualTextureTileManager::GetMemoryAlignment() {
+    return alignof(Mapping);
+}
+
+size_t VirtualTextureTileManager::CalculatePhysicalPoolSize(DeviceType* pDevice,
+                                                            const InfoType& info,
+                                                            const TextureInfo& textureInfo) {
+    TileLayout layout;
+    CalculateTileLayout(&layout, info, textureInfo);
+
+    size_t pageSize = info.GetPageSize();
+    size_t storageSize = TextureType::CalculateMipDataSize(pDevice, textureInfo);
+    size_t sparseSize = pageSize * layout.tileCount;
+    size_t tailSize = storageSize > sparseSize ? storageSize - sparseSize : 0;
+    return pageSize * info.GetPhysicalPageCount() + nn::util::align_up(tailSize, pageSize);
+}
+
+VirtualTextureTileManager::VirtualTextureTileManager()
+    : m_pVirtualPool(nullptr), m_pPhysicalPool(nullptr), m_TextureOffset(0),
+      m_PhysicalPoolOffset(0), m_PageSize(0), m_StorageClass(0), m_pTilePages(nullptr),
+      m_pPages(nullptr), m_pRequests(nullptr), m_pMappedTiles(nullptr), m_pMappings(nullptr),
+      m_PhysicalPageCount(0), m_TailPageCount(0), m_MaxRequestCount(0), m_RequestCount(0),
+      m_MappedTileCount(0), m_FreePageIndex(InvalidPageIndex), m_LruFront(InvalidPageIndex),
+      m_LruBack(InvalidPageIndex), m_ResidentTileCount(0), m_EvictedTileCount(0), m_Frame(0),
+      m_TileWidth(0), m_TileHeight(0), m_SparseMipCount(0) {}
+
+VirtualTextureTileManager::~VirtualTextureTileManager() {}
+
+bool VirtualTextureTileManager::Initialize(DeviceType* pDevice, const InfoType& info,
+                                           const TextureInfo& textureInfo, TextureType* pTexture,
+                                           MemoryPoolType* pVirtualPool, ptrdiff_t textureOffset,
+                                           MemoryPoolType* pPhysicalPool,
+                                           ptrdiff_t physicalPoolOffset, void* pMemory,
+                                           [[maybe_unused]] size_t memorySize) {
+    const TextureInfoData& textureData = textureInfo.ToData();
+    if (textureInfo.GetImageStorageDimension() != ImageStorageDimension_2d ||
+        textureInfo.GetArrayLength() > 1 ||
+        !textureData.flags.GetBit(textureData.Flag_SparseResidency)) {
+        return false;
+    }
+
+    TileLayout layout;
+    CalculateTileLayout(&layout, info, textureInfo);
+
+    m_pVirtualPool = pVirtualPool;
+    m_pPhysicalPool = pPhysicalPool;
+    m_TextureOffset = textureOffset;
+    m_PhysicalPoolOffset = physicalPoolOffset;
+    m_PageSize = info.GetPageSize();
+    m_StorageClass = nvnTextureGetStorageClass(pTexture->ToData()->pNvnTexture);
+    m_PhysicalPageCount = info.GetPhysicalPageCount();
+    m_MaxRequestCount = info.GetMaxRequestCount();
+    m_TileWidth = layout.tileWidth;
+    m_TileHeight = layout.tileHeight;
+    m_SparseMipCount = layout.sparseMipCount;
+    std::copy(layout.tileCountX, layout.tileCountX + m_SparseMipCount, m_TileCountX);
+    std::copy(layout.tileCountY, layout.tileCountY + m_SparseMipCount, m_TileCountY);
+    std::copy(layout.firstTileIndex, layout.firstTileIndex + m_SparseMipCount, m_FirstTileIndex);
+
+    nn::util::BytePtr ptr(pMemory);
+    m_pMappings = ptr.Get<Mapping>();
+    m_pPages = ptr.Advance(sizeof(Mapping) * m_MaxRequestCount * 2).Get<Page>();
+    m_pTilePages = ptr.Advance(sizeof(Page) * m_PhysicalPageCount).Get<int32_t>();
+    m_pRequests = ptr.Advance(sizeof(int32_t) * layout.tileCount).Get<VirtualTextureTile>();
+    m_pMappedTiles = ptr.Advance(sizeof(VirtualTextureTile) * m_MaxRequestCount)
+                         .Get<VirtualTextureTile>();
+
+    std::fill(m_pTilePages, m_pTilePages + layout.tileCount, int32_t(InvalidPageIndex));
+    for (int idxPage = 0; idxPage < m_PhysicalPageCount; ++idxPage) {
+        Page& page = m_pPages[idxPage];
+        page.tileIndex = InvalidPageIndex;
+        page.prev = InvalidPageIndex;
+        page.next = idxPage + 1 < m_PhysicalPageCount ? idxPage + 1 : InvalidPageIndex;
+        page.lastUsedFrame = 0;
+    }
+    m_FreePageIndex = m_PhysicalPageCount > 0 ? 0 : InvalidPageIndex;
+    m_LruFront = InvalidPageIndex;
+    m_LruBack = InvalidPageIndex;
+    m_RequestCount = 0;
+    m_MappedTileCount = 0;
+    m_ResidentTileCount = 0;
+    m_EvictedTileCount = 0;
+    m_Frame = 1;
+
+    // the tail lives behind the streaming pages for the whole lifetime of the texture
+    size_t sparseSize = m_PageSize * layout.tileCount;
+    size_t storageSize = TextureType::CalculateMipDataSize(pDevice, textureInfo);
+    size_t tailSize =
+        storageSize > sparseSize ? nn::util::align_up(storageSize - sparseSize, m_PageSize) : 0;
+    m_TailPageCount = static_cast<int>(tailSize / m_PageSize);
+
+    if (tailSize > 0) {
+        SetMapping(&m_pMappings[0], m_pPhysicalPool,
+                   m_PhysicalPoolOffset + m_PageSize * m_PhysicalPageCount,
+                   m_TextureOffset + sparseSize, tailSize);
+        if (!nvnMemoryPoolMapVirtual(m_pVirtualPool->ToData()->pNvnMemoryPool, 1,
+                                     &m_pMappings[0].request)) {
+            m_pPages = nullptr;
+            return false;
+        }
+    }
+    return true;
+}
+
+void VirtualTextureTileManager::Finalize() {
+    m_pVirtualPool = nullptr;
+    m_pPhysicalPool = nullptr;
+    m_pTilePages = nullptr;
+    m_pPages = nullptr;
+    m_pRequests = nullptr;
+    m_pMappedTiles = nullptr;
+    m_pMappings = nullptr;
+}
+
+int VirtualTextureTileManager::FindTileIndex(const VirtualTextureTile& tile) const {
+    if (tile.mipLevel >= m_SparseMipCount || tile.x >= m_TileCountX[tile.mipLevel] ||
+        tile.y >= m_TileCountY[tile.mipLevel]) {
+        return -1;
+    }
+    return m_FirstTileIndex[tile.mipLevel] + tile.y * m_TileCountX[tile.mipLevel] + tile.x;
+}
+
+bool VirtualTextureTileManager::IsResident(const VirtualTextureTile& tile) const {
+    if (tile.mipLevel >= m_SparseMipCount) {
+        return true;
+    }
+    int tileIndex = FindTileIndex(tile);
+    return tileIndex >= 0 && m_pTilePages[tileIndex] >= 0;
+}
+
+void VirtualTextureTileManager::Unlink(int pageIndex) {
+    Page& page = m_pPages[pageIndex];
+    if (page.prev != InvalidPageIndex) {
+        m_pPages[page.prev].next = page.next;
+    } else {
+        m_LruFront = page.next;
+    }
+    if (page.next != InvalidPageIndex) {
+        m_pPages[page.next].prev = page.prev;
+    } else {
+        m_LruBack = page.prev;
+    }
+    page.prev = InvalidPageIndex;
+    page.next = InvalidPageIndex;
+}
+
+void VirtualTextureTileManager::LinkFront(int pageIndex) {
+    Page& page = m_pPages[pageIndex];
+    page.prev = InvalidPageIndex;
+    page.next = m_LruFront;
+    if (m_LruFront != InvalidPageIndex) {
+        m_pPages[m_LruFront].prev = pageIndex;
+    } else {
+        m_LruBack = pageIndex;
+    }
+    m_LruFront = pageIndex;
+}
+
+void VirtualTextureTileManager::SetMapping(Mapping* pMapping, MemoryPoolType* pPhysicalPool,
+                                           ptrdiff_t physicalOffset, ptrdiff_t virtualOffset,
+                                           size_t size) const {
+    // a null physical pool unmaps the virtual range
+    pMapping->request.physicalPool =
+        pPhysicalPool ? static_cast<NVNmemoryPool*>(pPhysicalPool->ToData()->pNvnMemoryPool) :
+                        nullptr;
+    pMapping->request.physicalOffset = physicalOffset;
+    pMapping->request.virtualOffset = virtualOffset;
+    pMapping->request.size = size;
+    pMapping->request.storageClass = m_StorageClass;
+}
+
+int VirtualTextureTileManager::Request(const VirtualTextureTile* pTiles, int tileCount) {
+    int acceptedCount = 0;
+
+    for (int idx = 0; idx < tileCount; ++idx) {
+        int tileIndex = FindTileIndex(pTiles[idx]);
+        if (tileIndex < 0) {
+            continue;
+        }
+
+        int32_t state = m_pTilePages[tileIndex];
+        if (state >= 0) {
+            m_pPages[state].lastUsedFrame = m_Frame;
+            Unlink(state);
+            LinkFront(state);
+        } else if (state != TileRequested) {
+            if (m_RequestCount >= m_MaxRequestCount) {
+                continue;
+            }
+            m_pRequests[m_RequestCount++] = pTiles[idx];
+            m_pTilePages[tileIndex] = TileRequested;
+        }
+        ++acceptedCount;
+    }
+    return acceptedCount;
+}
+
+int VirtualTextureTileManager::Update() {
+    m_MappedTileCount = 0;
+
+    // the mappings are planned first and the pages only change hands once NVN accepted them.
+    // applying them takes the pages in the same order as the plan walks them
+    int mappingCount = 0;
+    int processedCount = 0;
+    int freePageIndex = m_FreePageIndex;
+    int evictPageIndex = m_LruBack;
+
+    for (; processedCount < m_RequestCount; ++processedCount) {
+        int pageIndex = freePageIndex;
+        if (pageIndex != InvalidPageIndex) {
+            freePageIndex = m_pPages[pageIndex].next;
+        } else {
+            // the back of the list is the least recently requested tile
+            pageIndex = evictPageIndex;
+            if (pageIndex == InvalidPageIndex || m_pPages[pageIndex].lastUsedFrame == m_Frame) {
+                break;
+            }
+            evictPageIndex = m_pPages[pageIndex].prev;
+            SetMapping(&m_pMappings[mappingCount++], nullptr, 0,
+                       m_TextureOffset + m_PageSize * m_pPages[pageIndex].tileIndex, m_PageSize);
+        }
+
+        int tileIndex = FindTileIndex(m_pRequests[processedCount]);
+        SetMapping(&m_pMappings[mappingCount++], m_pPhysicalPool,
+                   m_PhysicalPoolOffset + m_PageSize * pageIndex,
+                   m_TextureOffset + m_PageSize * tileIndex, m_PageSize);
+    }
+
+    if (mappingCount > 0 &&
+        !nvnMemoryPoolMapVirtual(m_pVirtualPool->ToData()->pNvnMemoryPool, mappingCount,
+                                 &m_pMappings[0].request)) {
+        return -1;
+    }
+
+    for (int idxRequest = 0; idxRequest < processedCount; ++idxRequest) {
+        int pageIndex = m_FreePageIndex;
+        if (pageIndex != InvalidPageIndex) {
+            m_FreePageIndex = m_pPages[pageIndex].next;
+        } else {
+            pageIndex = m_LruBack;
+            Unlink(pageIndex);
+            m_pTilePages[m_pPages[pageIndex].tileIndex] = InvalidPageIndex;
+            --m_ResidentTileCount;
+            ++m_EvictedTileCount;
+        }
+
+        const VirtualTextureTile& tile = m_pRequests[idxRequest];
+        int tileIndex = FindTileIndex(tile);
+
+        Page& page = m_pPages[pageIndex];
+        page.tileIndex = tileIndex;
+        page.lastUsedFrame = m_Frame;
+        LinkFront(pageIndex);
+        m_pTilePages[tileIndex] = pageIndex;
+        ++m_ResidentTileCount;
+        m_pMappedTiles[m_MappedTileCount++] = tile;
+    }
+
+    // requests that did not fit stay pending for the next frame
+    std::memmove(m_pRequests, m_pRequests + processedCount,
+                 sizeof(VirtualTextureTile) * (m_RequestCount - processedCount));
+    m_RequestCount -= processedCount;
+    ++m_Frame;
+
+    return m_MappedTileCount;
+}
+
+}  // namespace nn::gfx::util
@@ -0,0 +1,203 @@
+#include <nn/g3d/AnimLodController.h>
+
+#include <nn/util/util_BytePtr.h>
+
+#include <algorithm>
+#include <cstring>
+
+namespace nn::g3d {
+
+namespace {
+
+const int MtxElementCount = 12;
+
+void SetIdentity(nn::util::FloatColumnMajor4x3* pMtx) {
+    std::memset(pMtx, 0, sizeof(*pMtx));
+    pMtx->m[0][0] = 1.0f;
+    pMtx->m[1][1] = 1.0f;
+    pMtx->m[2][2] = 1.0f;
+}
+
+}  // namespace
+
+size_t AnimLodController::CalculateBufferSize(const InitializeArgument& arg) {
+    int boneCount = arg.GetSkeleton()->GetBoneCount();
+    return sizeof(nn::util::FloatColumnMajor4x3) * 2 * boneCount +
+           sizeof(bool) * CollapseMode_Count * boneCount;
+}
+
+size_t AnimLodController::GetBufferAlignment() {
+    return alignof(nn::util::FloatColumnMajor4x3);
+}
+
+AnimLodController::AnimLodController()
+    : m_Skeleton(nullptr), m_PrevMtxArray(nullptr), m_NextMtxArray(nullptr), m_ActiveArray(),
+      m_MinScreenSize(), m_UpdateInterval(), m_LodLevelCount(0), m_LeafCollapseScreenSize(0.0f),
+      m_LodLevel(-1), m_CollapseMode(-1), m_SegmentFrame(0), m_LookAheadFrameCount(0),
+      m_IsEvaluationFrame(false), m_IsPrevValid(false), m_IsNextValid(false), m_BeginTick(),
+      m_ElapsedTick(), m_FullTick(), m_SavedTick() {}
+
+bool AnimLodController::Initialize(const InitializeArgument& arg, void* buffer,
+                                   size_t bufferSize) {
+    if (buffer == nullptr || bufferSize < CalculateBufferSize(arg) ||
+        arg.GetLodLevelCount() < 1 || arg.GetLodLevelCount() > LodLevelCountMax) {
+        return false;
+    }
+
+    SkeletonEvaluator* pSkeleton = arg.GetSkeleton();
+    const ResSkeleton* pRes = pSkeleton->GetRes();
+    int boneCount = pSkeleton->GetBoneCount();
+
+    nn::util::BytePtr ptr(buffer);
+    m_PrevMtxArray = ptr.Get<nn::util::FloatColumnMajor4x3>();
+    ptr.Advance(sizeof(nn::util::FloatColumnMajor4x3) * boneCount);
+    m_NextMtxArray = ptr.Get<nn::util::FloatColumnMajor4x3>();
+    ptr.Advance(sizeof(nn::util::FloatColumnMajor4x3) * boneCount);
+    for (int idxMode = 0; idxMode < CollapseMode_Count; ++idxMode) {
+        m_ActiveArray[idxMode] = ptr.Get<bool>();
+        ptr.Advance(sizeof(bool) * boneCount);
+    }
+
+    // a bone is needed while anything visible hangs below it
+    bool* pVisibleTree = m_ActiveArray[CollapseMode_Invisible];
+    bool* pBranch = m_ActiveArray[CollapseMode_InvisibleAndLeaf];
+    std::fill_n(pVisibleTree, boneCount, false);
+    std::fill_n(pBranch, boneCount, false);
+    for (int idxBone = 0; idxBone < boneCount; ++idxBone) {
+        const ResBone* pBone = pRes->GetBone(idxBone);
+        int parentIndex = pBone->GetParentIndex();
+        if (parentIndex != ResBone::InvalidBoneIndex) {
+            pBranch[parentIndex] = true;
+        }
+        if (!pBone->IsVisible()) {
+            continue;
+        }
+        for (int idx = idxBone; idx != ResBone::InvalidBoneIndex && !pVisibleTree[idx];
+             idx = pRes->GetBone(idx)->GetParentIndex()) {
+            pVisibleTree[idx] = true;
+        }
+    }
+    for (int idxBone = 0; idxBone < boneCount; ++idxBone) {
+        pBranch[idxBone] = pBranch[idxBone] && pVisibleTree[idxBone];
+    }
+
+    for (int level = 0; level < arg.GetLodLevelCount(); ++level) {
+        m_MinScreenSize[level] = arg.GetMinScreenSize(level);
+        m_UpdateInterval[level] = std::max(arg.GetUpdateInterval(level), 1);
+    }
+    m_LodLevelCount = arg.GetLodLevelCount();
+    m_LeafCollapseScreenSize = arg.GetLeafCollapseScreenSize();
+    m_Skeleton = pSkeleton;
+    m_LodLevel = -1;
+    m_CollapseMode = -1;
+    m_FullTick = nn::os::Tick();
+    Reset();
+    return true;
+}
+
+void AnimLodController::Reset() {
+    m_SegmentFrame = 0;
+    m_IsPrevValid = false;
+    m_IsNextValid = false;
+}
+
+void AnimLodController::Update(float screenSize) {
+    m_BeginTick = nn::os::GetSystemTick();
+
+    int level = 0;
+    while (level < m_LodLevelCount - 1 && screenSize < m_MinScreenSize[level]) {
+        ++level;
+    }
+    int collapseMode = screenSize < m_LeafCollapseScreenSize ? CollapseMode_InvisibleAndLeaf
+                                                               : CollapseMode_Invisible;
+
+    // the held poses were taken with another bone set or another spacing
+    if (collapseMode != m_CollapseMode) {
+        m_Skeleton->SetActiveBones(m_ActiveArray[collapseMode]);
+        m_CollapseMode = collapseMode;
+        Reset();
+    }
+    if (level != m_LodLevel) {
+        if (m_LodLevel < 0 || m_UpdateInterval[level] != m_UpdateInterval[m_LodLevel]) {
+            Reset();
+        }
+        m_LodLevel = level;
+    }
+
+    // a new segment first takes the current pose, then the pose at its end the frame after
+    int interval = m_UpdateInterval[m_LodLevel];
+    if (interval == 1 || !m_IsPrevValid) {
+        m_SegmentFrame = 0;
+        m_IsEvaluationFrame = true;
+        m_LookAheadFrameCount = 0;
+        return;
+    }
+    m_SegmentFrame = (m_SegmentFrame + 1) % interval;
+    if (m_SegmentFrame == 0) {
+        std::swap(m_PrevMtxArray, m_NextMtxArray);
+        m_IsNextValid = false;
+    }
+    m_IsEvaluationFrame = !m_IsNextValid;
+    m_LookAheadFrameCount = interval - m_SegmentFrame;
+}
+
+void AnimLodController::CalculateWorld(const nn::util::FloatColumnMajor4x3& baseMtx,
+                                       ICalculateWorldCallback* pCallback) {
+    int interval = m_UpdateInterval[m_LodLevel];
+    int boneCount = m_Skeleton->GetBoneCount();
+    nn::util::FloatColumnMajor4x3* pWorldMtxArray = m_Skeleton->GetWorldMtxArray();
+
+    if (interval == 1) {
+        m_Skeleton->CalculateWorld(baseMtx, pCallback);
+    } else {
+        if (m_IsEvaluationFrame) {
+            nn::util::FloatColumnMajor4x3 identity;
+            SetIdentity(&identity);
+            m_Skeleton->CalculateWorld(identity, pCallback);
+            if (m_IsPrevValid) {
+                std::copy_n(pWorldMtxArray, boneCount, m_NextMtxArray);
+                m_IsNextValid = true;
+            } else {
+                std::copy_n(pWorldMtxArray, boneCount, m_PrevMtxArray);
+                m_IsPrevValid = true;
+            }
+        }
+
+        float t = static_cast<float>(m_SegmentFrame) / static_cast<float>(interval);
+        const float* b = &baseMtx.m[0][0];
+        const nn::util::FloatColumnMajor4x3* pNextMtxArray =
+            m_IsNextValid ? m_NextMtxArray : m_PrevMtxArray;
+        for (int idxBone = 0; idxBone < boneCount; ++idxBone) {
+            const float* pPrev = &m_PrevMtxArray[idxBone].m[0][0];
+            const float* pNext = &pNextMtxArray[idxBone].m[0][0];
+            float l[MtxElementCount];
+            for (int idxElement = 0; idxElement < MtxElementCount; ++idxElement) {
+                l[idxElement] = pPrev[idxElement] + (pNext[idxElement] - pPrev[idxElement]) * t;
+            }
+
+            float* pOut = &pWorldMtxArray[idxBone].m[0][0];
+            for (int row = 0; row < 3; ++row) {
+                for (int column = 0; column < 4; ++column) {
+                    pOut[row * 4 + column] = b[row * 4 + 0] * l[column] +
+                                             b[row * 4 + 1] * l[4 + column] +
+                                             b[row * 4 + 2] * l[8 + column];
+                }
+                pOut[row * 4 + 3] += b[row * 4 + 3];
+            }
+        }
+    }
+
+    // the cost of an evaluation is taken as proportional to the bones it calculates, so the
+    // collapsed bones count as saved too
+    m_ElapsedTick = nn::os::GetSystemTick() - m_BeginTick;
+    if (m_IsEvaluationFrame) {
+        int64_t fullTick = m_ElapsedTick.GetInt64Value() * boneCount /
+                           std::max(m_Skeleton->GetActiveBoneCount(), 1);
+        int64_t averageTick = m_FullTick.GetInt64Value();
+        m_FullTick = averageTick == 0 ? fullTick : averageTick + (fullTick - averageTick) / 8;
+    }
+    m_SavedTick =
+        std::max(m_FullTick.GetInt64Value() - m_ElapsedTick.GetInt64Value(), int64_t(0));
+}
+
+}  // namespace nn::g3d
@@ -0,0 +1,135 @@
+#include <nn/g3d/HiZBuffer.h>
+
+#include <nn/util/util_BytePtr.h>
+
+#include <algorithm>
+
+namespace nn::g3d {
+
+namespace {
+
+bool IsPowerOfTwo(int value) {
+    return value > 0 && (value & (value - 1)) == 0;
+}
+
+int CalculateLevelCount(int width, int height) {
+    int levelCount = 1;
+    while ((width >> levelCount) > 0 || (height >> levelCount) > 0) {
+        ++levelCount;
+    }
+    return levelCount;
+}
+
+int GetLevelSize(int size, int level) {
+    return std::max(size >> level, 1);
+}
+
+}  // namespace
+
+size_t HiZBuffer::CalculateBufferSize(int width, int height) {
+    size_t size = 0;
+    for (int level = 0; level < CalculateLevelCount(width, height); ++level) {
+        size += sizeof(float) * GetLevelSize(width, level) * GetLevelSize(height, level);
+    }
+    return size;
+}
+
+size_t HiZBuffer::GetBufferAlignment() {
+    return sizeof(float);
+}
+
+HiZBuffer::HiZBuffer() : m_LevelArray(), m_Width(0), m_Height(0), m_LevelCount(0) {}
+
+bool HiZBuffer::Initialize(int width, int height, void* buffer, size_t bufferSize) {
+    if (!IsPowerOfTwo(width) || !IsPowerOfTwo(height) ||
+        CalculateLevelCount(width, height) > LevelCountMax || buffer == nullptr ||
+        bufferSize < CalculateBufferSize(width, height)) {
+        return false;
+    }
+
+    nn::util::BytePtr ptr(buffer);
+    m_LevelCount = CalculateLevelCount(width, height);
+    for (int level = 0; level < m_LevelCount; ++level) {
+        m_LevelArray[level] = ptr.Get<float>();
+        ptr.Advance(sizeof(float) * GetLevelSize(width, level) * GetLevelSize(height, level));
+    }
+    m_Width = width;
+    m_Height = height;
+    std::fill_n(m_LevelArray[0], width * height, 1.0f);
+    return true;
+}
+
+void HiZBuffer::Build(const float* pDepth, int depthWidth, int depthHeight, ptrdiff_t stride) {
+    // every texel of level 0 takes the farthest of the depth pixels under it
+    float* pLevel0 = m_LevelArray[0];
+    for (int y = 0; y < m_Height; ++y) {
+        int beginY = y * depthHeight / m_Height;
+        int endY = std::max((y + 1) * depthHeight / m_Height, beginY + 1);
+        for (int x = 0; x < m_Width; ++x) {
+            int beginX = x * depthWidth / m_Width;
+            int endX = std::max((x + 1) * depthWidth / m_Width, beginX + 1);
+            float maxDepth = 0.0f;
+            for (int depthY = beginY; depthY < endY; ++depthY) {
+                const float* pRow = nn::util::ConstBytePtr(pDepth, stride * depthY).Get<float>();
+                for (int depthX = beginX; depthX < endX; ++depthX) {
+                    maxDepth = std::max(maxDepth, pRow[depthX]);
+                }
+            }
+            pLevel0[y * m_Width + x] = maxDepth;
+        }
+    }
+
+    for (int level = 1; level < m_LevelCount; ++level) {
+        const float* pSrc = m_LevelArray[level - 1];
+        float* pDst = m_LevelArray[level];
+        int srcWidth = GetLevelSize(m_Width, level - 1);
+        int srcHeight = GetLevelSize(m_Height, level - 1);
+        int width = GetLevelSize(m_Width, level);
+        int height = GetLevelSize(m_Height, level);
+        for (int y = 0; y < height; ++y) {
+            const float* pRow0 = &pSrc[std::min(y * 2, srcHeight - 1) * srcWidth];
+            const float* pRow1 = &pSrc[std::min(y * 2 + 1, srcHeight - 1) * srcWidth];
+            for (int x = 0; x < width; ++x) {
+                int x0 = std::min(x * 2, srcWidth - 1);
+                int x1 = std::min(x * 2 + 1, srcWidth - 1);
+                pDst[y * width + x] =
+                    std::max(std::max(pRow0[x0], pRow0[x1]), std::max(pRow1[x0], pRow1[x1]));
+            }
+        }
+    }
+}
+
+bool HiZBuffer::IsOccluded(float left, float top, float right, float bottom,
+                           float minDepth) const {
+    left = std::clamp(left, 0.0f, 1.0f);
+    right = std::clamp(right, 0.0f, 1.0f);
+    top = std::clamp(top, 0.0f, 1.0f);
+    bottom = std::clamp(bottom, 0.0f, 1.0f);
+
+    int level = 0;
+    float sizeX = (right - left) * m_Width;
+    float sizeY = (bottom - top) * m_Height;
+    while (level < m_LevelCount - 1 && (sizeX > 2.0f || sizeY > 2.0f)) {
+        sizeX *= 0.5f;
+        sizeY *= 0.5f;
+        ++level;
+    }
+
+    int width = GetLevelSize(m_Width, level);
+    int height = GetLevelSize(m_Height, level);
+    int beginX = std::min(static_cast<int>(left * width), width - 1);
+    int endX = std::min(static_cast<int>(right * width), width - 1);
+    int beginY = std::min(static_cast<int>(top * height), height - 1);
+    int endY = std::min(static_cast<int>(bottom * height), height - 1);
+    const float* pLevel = m_LevelArray[level];
+    for (int y = beginY; y <= endY; ++y) {
+        for (int x = beginX; x <= endX; ++x) {
+            if (pLevel[y * width + x] >= minDepth) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+}  // namespace nn::g3d
@@ -0,0 +1,379 @@
+#include <nn/g3d/MaterialAnimObj.h>
+
+#include <nn/gfx/detail/gfx_Buffer-api.nvn.8.h>
+#include <nn/util/util_BytePtr.h>
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstring>
+
+#include "detail/MathHelper.h"
+
+namespace nn::g3d {
+
+struct MaterialAnimObj::MaterialState {
+    void* pUniformBlock;
+    uint32_t dirtyBegin;
+    uint32_t dirtyEnd;
+    uint16_t beginShaderParamAnim;
+    uint16_t beginTexturePatternAnim;
+    bool isVisible;
+};
+
+// value is what was last written to the block
+struct MaterialAnimObj::ParamState {
+    const ResShaderParam* pParam;
+    uint8_t src[SrcParamSizeMax];
+    uint8_t value[SrcParamSizeMax];
+    bool isWritten;
+};
+
+namespace {
+
+void ApplyValue(void* pSrc, size_t srcSize, uint32_t targetOffset, float value, bool isFloat) {
+    if (targetOffset + sizeof(float) > srcSize) {
+        return;
+    }
+    if (isFloat) {
+        std::memcpy(nn::util::BytePtr(pSrc, targetOffset).Get(), &value, sizeof(float));
+    } else {
+        int32_t intValue = static_cast<int32_t>(value);
+        std::memcpy(nn::util::BytePtr(pSrc, targetOffset).Get(), &intValue, sizeof(int32_t));
+    }
+}
+
+// scale, rotate, translate into two rows
+void ConvertSrt2d(float (*pOut)[4], const float* pSrt) {
+    float sinR = std::sin(pSrt[2]);
+    float cosR = std::cos(pSrt[2]);
+    pOut[0][0] = pSrt[0] * cosR;
+    pOut[0][1] = -pSrt[1] * sinR;
+    pOut[0][2] = pSrt[3];
+    pOut[1][0] = pSrt[0] * sinR;
+    pOut[1][1] = pSrt[1] * cosR;
+    pOut[1][2] = pSrt[4];
+    pOut[0][3] = 0.0f;
+    pOut[1][3] = 0.0f;
+}
+
+// the tools work with v pointing up while textures are addressed with v pointing down, so each
+// matrix is the composition of the tool flipped on v
+void ConvertTexsrt(float (*pOut)[4], uint32_t mode, const float* pSrt) {
+    float sx = pSrt[0];
+    float sy = pSrt[1];
+    float sinR = std::sin(pSrt[2]);
+    float cosR = std::cos(pSrt[2]);
+    float tx = pSrt[3];
+    float ty = pSrt[4];
+    switch (mode) {
+    case ResShaderParam::TexsrtMode_3dsMax:
+        // translated, then scaled and rotated around the center
+        pOut[0][0] = sx * cosR;
+        pOut[0][1] = sy * sinR;
+        pOut[0][2] = 0.5f - sx * cosR * (tx + 0.5f) + sy * sinR * (ty - 0.5f);
+        pOut[1][0] = -sx * sinR;
+        pOut[1][1] = sy * cosR;
+        pOut[1][2] = 0.5f + sx * sinR * (tx + 0.5f) + sy * cosR * (ty - 0.5f);
+        break;
+    case ResShaderParam::TexsrtMode_Softimage:
+        // scaled and rotated around the origin, then translated
+        pOut[0][0] = sx * cosR;
+        pOut[0][1] = sy * sinR;
+        pOut[0][2] = tx - sy * sinR;
+        pOut[1][0] = -sx * sinR;
+        pOut[1][1] = sy * cosR;
+        pOut[1][2] = 1.0f - sy * cosR - ty;
+        break;
+    default:
+        // maya: rotated around the center, translated, then scaled from the origin
+        pOut[0][0] = sx * cosR;
+        pOut[0][1] = sx * sinR;
+        pOut[0][2] = sx * (0.5f - 0.5f * (cosR + sinR) - tx);
+        pOut[1][0] = -sy * sinR;
+        pOut[1][1] = sy * cosR;
+        pOut[1][2] = 1.0f - sy * (0.5f + 0.5f * (cosR - sinR) - ty);
+        break;
+    }
+    pOut[0][3] = 0.0f;
+    pOut[1][3] = 0.0f;
+}
+
+void ConvertSrt3d(float (*pOut)[4], const float* pSrt) {
+    nn::util::Float3 euler = {{{pSrt[3], pSrt[4], pSrt[5]}}};
+    nn::util::Float4 q = detail::ConvertEulerXyzToQuat(euler);
+    float rotate[3][3] = {
+        {1.0f - 2.0f * (q.y * q.y + q.z * q.z), 2.0f * (q.x * q.y - q.w * q.z),
+         2.0f * (q.x * q.z + q.w * q.y)},
+        {2.0f * (q.x * q.y + q.w * q.z), 1.0f - 2.0f * (q.x * q.x + q.z * q.z),
+         2.0f * (q.y * q.z - q.w * q.x)},
+        {2.0f * (q.x * q.z - q.w * q.y), 2.0f * (q.y * q.z + q.w * q.x),
+         1.0f - 2.0f * (q.x * q.x + q.y * q.y)},
+    };
+    for (int row = 0; row < 3; ++row) {
+        for (int column = 0; column < 3; ++column) {
+            pOut[row][column] = rotate[row][column] * pSrt[column];
+        }
+        pOut[row][3] = pSrt[6 + row];
+    }
+}
+
+}  // namespace
+
+size_t MaterialAnimObj::CalculateBufferSize(const InitializeArgument& arg) {
+    const ResMaterialAnim* pResAnim = arg.GetResource();
+    return sizeof(MaterialState) * pResAnim->GetPerMaterialAnimCount() +
+           sizeof(ParamState) * pResAnim->GetShaderParamAnimCount() +
+           sizeof(uint16_t) * (pResAnim->GetTexturePatternAnimCount() + pResAnim->GetCurveCount());
+}
+
+size_t MaterialAnimObj::GetBufferAlignment() {
+    return alignof(MaterialState);
+}
+
+MaterialAnimObj::MaterialAnimObj()
+    : m_Res(nullptr), m_MaterialArray(nullptr), m_ParamArray(nullptr),
+      m_TextureIndexArray(nullptr), m_CursorArray(nullptr), m_Frame(0.0f) {}
+
+bool MaterialAnimObj::Initialize(const InitializeArgument& arg, void* buffer, size_t bufferSize) {
+    if (buffer == nullptr || bufferSize < CalculateBufferSize(arg)) {
+        return false;
+    }
+
+    const ResMaterialAnim* pResAnim = arg.GetResource();
+    nn::util::BytePtr ptr(buffer);
+    m_MaterialArray = ptr.Get<MaterialState>();
+    m_ParamArray =
+        ptr.Advance(sizeof(MaterialState) * pResAnim->GetPerMaterialAnimCount()).Get<ParamState>();
+    m_TextureIndexArray =
+        ptr.Advance(sizeof(ParamState) * pResAnim->GetShaderParamAnimCount()).Get<uint16_t>();
+    m_CursorArray =
+        ptr.Advance(sizeof(uint16_t) * pResAnim->GetTexturePatternAnimCount()).Get<uint16_t>();
+
+    m_Res = pResAnim;
+    m_Frame = 0.0f;
+    std::fill_n(m_CursorArray, pResAnim->GetCurveCount(), uint16_t(0));
+    std::fill_n(m_TextureIndexArray, pResAnim->GetTexturePatternAnimCount(), uint16_t(0));
+
+    // the parameter and texture pattern animations of the materials follow each other
+    int beginShaderParamAnim = 0;
+    int beginTexturePatternAnim = 0;
+    for (int idxMaterial = 0; idxMaterial < pResAnim->GetPerMaterialAnimCount(); ++idxMaterial) {
+        const ResPerMaterialAnim* pMaterialAnim = pResAnim->GetPerMaterialAnim(idxMaterial);
+        MaterialState& material = m_MaterialArray[idxMaterial];
+        material.pUniformBlock = nullptr;
+        material.dirtyBegin = UINT_MAX;
+        material.dirtyEnd = 0;
+        material.beginShaderParamAnim = beginShaderParamAnim;
+        material.beginTexturePatternAnim = beginTexturePatternAnim;
+        material.isVisible = true;
+        beginShaderParamAnim += pMaterialAnim->GetShaderParamAnimCount();
+        beginTexturePatternAnim += pMaterialAnim->GetTexturePatternAnimCount();
+    }
+    for (int idxParam = 0; idxParam < pResAnim->GetShaderParamAnimCount(); ++idxParam) {
+        m_ParamArray[idxParam].pParam = nullptr;
+    }
+    return true;
+}
+
+int MaterialAnimObj::Bind(const BindArgument& arg) {
+    int materialAnimIndex = -1;
+    for (int idxMaterial = 0; idxMaterial < m_Res->GetPerMaterialAnimCount(); ++idxMaterial) {
+        if (std::strcmp(m_Res->GetPerMaterialAnim(idxMaterial)->GetName(),
+                        arg.GetMaterialName()) == 0) {
+            materialAnimIndex = idxMaterial;
+            break;
+        }
+    }
+    if (materialAnimIndex < 0) {
+        return -1;
+    }
+
+    const ResPerMaterialAnim* pMaterialAnim = m_Res->GetPerMaterialAnim(materialAnimIndex);
+    MaterialState& material = m_MaterialArray[materialAnimIndex];
+    material.pUniformBlock = arg.GetUniformBlock();
+    material.dirtyBegin = UINT_MAX;
+    material.dirtyEnd = 0;
+
+    for (int idxAnim = 0; idxAnim < pMaterialAnim->GetShaderParamAnimCount(); ++idxAnim) {
+        const ResShaderParamAnimInfo* pInfo = pMaterialAnim->GetShaderParamAnimInfo(idxAnim);
+        ParamState& param = m_ParamArray[material.beginShaderParamAnim + idxAnim];
+        param.pParam = nullptr;
+        param.isWritten = false;
+        for (int idxParam = 0; idxParam < arg.GetShaderParamCount(); ++idxParam) {
+            const ResShaderParam* pParam = &arg.GetShaderParamArray()[idxParam];
+            if (std::strcmp(pParam->GetId(), pInfo->GetName()) == 0) {
+                param.pParam = pParam;
+                break;
+            }
+        }
+        if (param.pParam == nullptr || param.pParam->GetSrcSize() > SrcParamSizeMax) {
+            param.pParam = nullptr;
+            continue;
+        }
+
+        // the source starts from the material and takes the constants once
+        std::memcpy(param.src,
+                    nn::util::ConstBytePtr(arg.GetSrcParam(), param.pParam->GetSrcOffset()).Get(),
+                    param.pParam->GetSrcSize());
+        for (int idxConstant = 0; idxConstant < pInfo->GetConstantCount(); ++idxConstant) {
+            const ResAnimConstant* pConstant =
+                pMaterialAnim->GetConstant(pInfo->GetBeginConstant() + idxConstant);
+            if (pConstant->GetTargetOffset() + sizeof(float) <= param.pParam->GetSrcSize()) {
+                std::memcpy(&param.src[pConstant->GetTargetOffset()], &pConstant->ToData().fValue,
+                            sizeof(float));
+            }
+        }
+        WriteParam(&material, &param);
+    }
+
+    CalculateMaterial(materialAnimIndex);
+    return materialAnimIndex;
+}
+
+void MaterialAnimObj::SetFrame(float frame) {
+    float frameCount = static_cast<float>(m_Res->GetFrameCount());
+    if (!m_Res->IsLooped()) {
+        m_Frame = std::clamp(frame, 0.0f, frameCount);
+    } else if (frameCount > 0.0f) {
+        m_Frame = std::fmod(frame, frameCount);
+        m_Frame = m_Frame < 0.0f ? m_Frame + frameCount : m_Frame;
+    } else {
+        m_Frame = 0.0f;
+    }
+}
+
+void MaterialAnimObj::Calculate() {
+    for (int idxMaterial = 0; idxMaterial < m_Res->GetPerMaterialAnimCount(); ++idxMaterial) {
+        if (IsBound(idxMaterial)) {
+            CalculateMaterial(idxMaterial);
+        }
+    }
+}
+
+void MaterialAnimObj::CalculateMaterial(int materialAnimIndex) {
+    const ResPerMaterialAnim* pMaterialAnim = m_Res->GetPerMaterialAnim(materialAnimIndex);
+    MaterialState& material = m_MaterialArray[materialAnimIndex];
+    uint16_t* pCursors = &m_CursorArray[pMaterialAnim->GetBeginCurve()];
+
+    for (int idxAnim = 0; idxAnim < pMaterialAnim->GetShaderParamAnimCount(); ++idxAnim) {
+        ParamState& param = m_ParamArray[material.beginShaderParamAnim + idxAnim];
+        const ResShaderParamAnimInfo* pInfo = pMaterialAnim->GetShaderParamAnimInfo(idxAnim);
+        if (param.pParam == nullptr || pInfo->GetCurveCount() == 0) {
+            continue;
+        }
+
+        for (int idxCurve = pInfo->GetBeginCurve();
+             idxCurve < pInfo->GetBeginCurve() + pInfo->GetCurveCount(); ++idxCurve) {
+            const ResAnimCurve* pCurve = pMaterialAnim->GetCurve(idxCurve);
+            ApplyValue(param.src, param.pParam->GetSrcSize(), pCurve->GetTargetOffset(),
+                       pCurve->EvaluateFloat(m_Frame, &pCursors[idxCurve]),
+                       pCurve->IsFloatCurve());
+        }
+        WriteParam(&material, &param);
+    }
+
+    int textureCount = m_Res->GetTextureCount();
+    for (int idxAnim = 0; idxAnim < pMaterialAnim->GetTexturePatternAnimCount(); ++idxAnim) {
+        const ResTexturePatternAnimInfo* pInfo = pMaterialAnim->GetTexturePatternAnimInfo(idxAnim);
+        int textureIndex;
+        if (pInfo->GetCurveIndex() >= 0) {
+            textureIndex = static_cast<int>(pMaterialAnim->GetCurve(pInfo->GetCurveIndex())
+                                                ->EvaluateFloat(m_Frame,
+                                                                &pCursors[pInfo->GetCurveIndex()]));
+        } else if (pInfo->GetConstantIndex() >= 0) {
+            textureIndex = pMaterialAnim->GetConstant(pInfo->GetConstantIndex())->GetInt();
+        } else {
+            continue;
+        }
+        m_TextureIndexArray[material.beginTexturePatternAnim + idxAnim] =
+            std::clamp(textureIndex, 0, std::max(textureCount - 1, 0));
+    }
+
+    int visibilityCurveIndex = pMaterialAnim->GetVisibilityCurveIndex();
+    if (visibilityCurveIndex >= 0) {
+        material.isVisible = pMaterialAnim->GetCurve(visibilityCurveIndex)
+                                 ->EvaluateFloat(m_Frame, &pCursors[visibilityCurveIndex]) != 0.0f;
+    } else if (pMaterialAnim->GetVisibilityConstantIndex() >= 0) {
+        material.isVisible =
+            pMaterialAnim->GetConstant(pMaterialAnim->GetVisibilityConstantIndex())->GetInt() != 0;
+    }
+}
+
+void MaterialAnimObj::WriteParam(MaterialState* pMaterial, ParamState* pParamState) {
+    const ParamState& param = *pParamState;
+    const ResShaderParam* pParam = param.pParam;
+    float converted[3][4];
+    const void* pValue = converted;
+    switch (pParam->GetType()) {
+    case ResShaderParam::Type_Srt2d:
+        ConvertSrt2d(converted, reinterpret_cast<const float*>(param.src));
+        break;
+    case ResShaderParam::Type_Texsrt: {
+        uint32_t mode;
+        std::memcpy(&mode, param.src, sizeof(mode));
+        ConvertTexsrt(converted, mode,
+                      reinterpret_cast<const float*>(&param.src[sizeof(uint32_t)]));
+        break;
+    }
+    case ResShaderParam::Type_Srt3d:
+        ConvertSrt3d(converted, reinterpret_cast<const float*>(param.src));
+        break;
+    default:
+        pValue = param.src;
+        break;
+    }
+
+    // unchanged values leave the block and its dirty range alone
+    size_t size = pParam->GetSize();
+    if (param.isWritten && std::memcmp(param.value, pValue, size) == 0) {
+        return;
+    }
+    std::memcpy(pParamState->value, pValue, size);
+    pParamState->isWritten = true;
+    std::memcpy(nn::util::BytePtr(pMaterial->pUniformBlock, pParam->GetOffset()).Get(), pValue,
+                size);
+    pMaterial->dirtyBegin = std::min(pMaterial->dirtyBegin, uint32_t(pParam->GetOffset()));
+    pMaterial->dirtyEnd = std::max(pMaterial->dirtyEnd, uint32_t(pParam->GetOffset() + size));
+}
+
+bool MaterialAnimObj::IsVisible(int materialAnimIndex) const {
+    return m_MaterialArray[materialAnimIndex].isVisible;
+}
+
+bool MaterialAnimObj::IsBound(int materialAnimIndex) const {
+    return m_MaterialArray[materialAnimIndex].pUniformBlock != nullptr;
+}
+
+int MaterialAnimObj::GetTextureIndex(int materialAnimIndex, int patternIndex) const {
+    return m_TextureIndexArray[m_MaterialArray[materialAnimIndex].beginTexturePatternAnim +
+                               patternIndex];
+}
+
+size_t MaterialAnimObj::GetDirtyRange(int materialAnimIndex, ptrdiff_t* pOutOffset) const {
+    const MaterialState& material = m_MaterialArray[materialAnimIndex];
+    if (material.dirtyEnd <= material.dirtyBegin) {
+        *pOutOffset = 0;
+        return 0;
+    }
+    *pOutOffset = material.dirtyBegin;
+    return material.dirtyEnd - material.dirtyBegin;
+}
+
+void MaterialAnimObj::ClearDirtyRange(int materialAnimIndex) {
+    m_MaterialArray[materialAnimIndex].dirtyBegin = UINT_MAX;
+    m_MaterialArray[materialAnimIndex].dirtyEnd = 0;
+}
+
+size_t MaterialAnimObj::FlushDirtyRange(int materialAnimIndex, BufferType* pBuffer,
+                                        ptrdiff_t blockOffset) {
+    ptrdiff_t offset;
+    size_t size = GetDirtyRange(materialAnimIndex, &offset);
+    if (size > 0) {
+        pBuffer->FlushMappedRange(blockOffset + offset, size);
+        ClearDirtyRange(materialAnimIndex);
+    }
+    return size;
+}
+
+}  // namespace nn::g3d
@@ -0,0 +1,203 @@
+#include <nn/g3d/RenderQueue.h>
+
+#include <nn/gfx/detail/gfx_Buffer-api.nvn.8.h>
+#include <nn/gfx/detail/gfx_CommandBuffer-api.nvn.8.h>
+#include <nn/util/util_BytePtr.h>
+
+#include <cstring>
+
+namespace nn::g3d {
+
+struct RenderQueue::DrawRecord {
+    const PipelineType* pPipeline;
+    const void* pMaterial;
+    const void* pShape;
+    const Mesh* pMesh;
+    const void* pInstanceData;
+};
+
+size_t RenderQueue::CalculateBufferSize(const InitializeArgument& arg) {
+    int maxDrawCount = arg.GetMaxDrawCount();
+    return (sizeof(DrawRecord) + (sizeof(uint64_t) + sizeof(uint32_t)) * 2) * maxDrawCount;
+}
+
+size_t RenderQueue::GetBufferAlignment() {
+    return alignof(DrawRecord);
+}
+
+uint32_t RenderQueue::QuantizeDepth(float depth, bool isBackToFront) {
+    // the bits of a positive float grow with its value
+    uint32_t bits;
+    std::memcpy(&bits, &depth, sizeof(bits));
+    return isBackToFront ? ~bits : bits;
+}
+
+RenderQueue::RenderQueue()
+    : m_pDrawArray(nullptr), m_KeyArray(), m_IndexArray(), m_pMaterialCallback(nullptr),
+      m_pMaterialUserData(nullptr), m_pShapeCallback(nullptr), m_pShapeUserData(nullptr),
+      m_InstanceDataSize(0), m_InstanceBufferIndex(0), m_MaxDrawCount(0), m_DrawCount(0),
+      m_SortedBuffer(0), m_DrawCallCount(0), m_PipelineChangeCount(0), m_MaterialChangeCount(0),
+      m_ShapeChangeCount(0) {}
+
+bool RenderQueue::Initialize(const InitializeArgument& arg, void* buffer, size_t bufferSize) {
+    if (buffer == nullptr || bufferSize < CalculateBufferSize(arg)) {
+        return false;
+    }
+
+    int maxDrawCount = arg.GetMaxDrawCount();
+    nn::util::BytePtr ptr(buffer);
+    m_pDrawArray = ptr.Get<DrawRecord>();
+    ptr.Advance(sizeof(DrawRecord) * maxDrawCount);
+    for (int idxBuffer = 0; idxBuffer < 2; ++idxBuffer) {
+        m_KeyArray[idxBuffer] = ptr.Get<uint64_t>();
+        ptr.Advance(sizeof(uint64_t) * maxDrawCount);
+    }
+    for (int idxBuffer = 0; idxBuffer < 2; ++idxBuffer) {
+        m_IndexArray[idxBuffer] = ptr.Get<uint32_t>();
+        ptr.Advance(sizeof(uint32_t) * maxDrawCount);
+    }
+
+    m_InstanceDataSize = arg.GetInstanceDataSize();
+    m_InstanceBufferIndex = arg.GetInstanceBufferIndex();
+    m_MaxDrawCount = maxDrawCount;
+    Clear();
+    return true;
+}
+
+void RenderQueue::Clear() {
+    m_DrawCount = 0;
+    m_SortedBuffer = 0;
+}
+
+bool RenderQueue::Add(uint64_t sortKey, const PipelineType* pPipeline, const void* pMaterial,
+                      const void* pShape, const Mesh* pMesh, const void* pInstanceData) {
+    if (m_DrawCount >= m_MaxDrawCount) {
+        return false;
+    }
+
+    int index = m_DrawCount++;
+    DrawRecord& draw = m_pDrawArray[index];
+    draw.pPipeline = pPipeline;
+    draw.pMaterial = pMaterial;
+    draw.pShape = pShape;
+    draw.pMesh = pMesh;
+    draw.pInstanceData = pInstanceData;
+    m_KeyArray[m_SortedBuffer][index] = sortKey;
+    m_IndexArray[m_SortedBuffer][index] = index;
+    return true;
+}
+
+void RenderQueue::Sort() {
+    // the counts of every digit are gathered for all passes in one read of the keys
+    int histogram[RadixPassCount][RadixSize] = {};
+    const uint64_t* pKeys = m_KeyArray[m_SortedBuffer];
+    for (int idxDraw = 0; idxDraw < m_DrawCount; ++idxDraw) {
+        uint64_t key = pKeys[idxDraw];
+        for (int pass = 0; pass < RadixPassCount; ++pass) {
+            ++histogram[pass][(key >> (pass * RadixBits)) & (RadixSize - 1)];
+        }
+    }
+
+    for (int pass = 0; pass < RadixPassCount && m_DrawCount > 0; ++pass) {
+        int shift = pass * RadixBits;
+        const uint64_t* pSrcKeys = m_KeyArray[m_SortedBuffer];
+        const uint32_t* pSrcIndices = m_IndexArray[m_SortedBuffer];
+
+        // a digit every key shares leaves the order as it is
+        int* pCounts = histogram[pass];
+        if (pCounts[(pSrcKeys[0] >> shift) & (RadixSize - 1)] == m_DrawCount) {
+            continue;
+        }
+
+        int offset = 0;
+        for (int digit = 0; digit < RadixSize; ++digit) {
+            int count = pCounts[digit];
+            pCounts[digit] = offset;
+            offset += count;
+        }
+
+        uint64_t* pDstKeys = m_KeyArray[1 - m_SortedBuffer];
+        uint32_t* pDstIndices = m_IndexArray[1 - m_SortedBuffer];
+        for (int idxDraw = 0; idxDraw < m_DrawCount; ++idxDraw) {
+            uint64_t key = pSrcKeys[idxDraw];
+            int position = pCounts[(key >> shift) & (RadixSize - 1)]++;
+            pDstKeys[position] = key;
+            pDstIndices[position] = pSrcIndices[idxDraw];
+        }
+        m_SortedBuffer = 1 - m_SortedBuffer;
+    }
+}
+
+void RenderQueue::Submit(CommandBufferType* pCommandBuffer, BufferType* pInstanceBuffer,
+                         void* pMappedInstanceBuffer, ptrdiff_t instanceBufferOffset) {
+    m_DrawCallCount = 0;
+    m_PipelineChangeCount = 0;
+    m_MaterialChangeCount = 0;
+    m_ShapeChangeCount = 0;
+    if (m_DrawCount == 0) {
+        return;
+    }
+
+    size_t instanceSize = m_InstanceDataSize * m_DrawCount;
+    gfx::GpuAddress instanceAddress;
+    pInstanceBuffer->GetGpuAddress(&instanceAddress);
+    instanceAddress.Offset(instanceBufferOffset);
+
+    const uint32_t* pOrder = m_IndexArray[m_SortedBuffer];
+    const DrawRecord* pPrevDraw = nullptr;
+    int idxDraw = 0;
+    while (idxDraw < m_DrawCount) {
+        // the run takes the following draws of the same mesh and state
+        const DrawRecord& draw = m_pDrawArray[pOrder[idxDraw]];
+        int runEnd = idxDraw;
+        for (; runEnd < m_DrawCount; ++runEnd) {
+            const DrawRecord& next = m_pDrawArray[pOrder[runEnd]];
+            if (next.pMesh != draw.pMesh || next.pShape != draw.pShape ||
+                next.pMaterial != draw.pMaterial || next.pPipeline != draw.pPipeline) {
+                break;
+            }
+            // a draw without instance data reads zeros rather than what the last frame left
+            void* pDst = nn::util::BytePtr(pMappedInstanceBuffer,
+                                           instanceBufferOffset + m_InstanceDataSize * runEnd)
+                             .Get();
+            if (next.pInstanceData != nullptr) {
+                std::memcpy(pDst, next.pInstanceData, m_InstanceDataSize);
+            } else {
+                std::memset(pDst, 0, m_InstanceDataSize);
+            }
+        }
+
+        if (pPrevDraw == nullptr || draw.pPipeline != pPrevDraw->pPipeline) {
+            pCommandBuffer->SetPipeline(draw.pPipeline);
+            ++m_PipelineChangeCount;
+        }
+        if (pPrevDraw == nullptr || draw.pMaterial != pPrevDraw->pMaterial) {
+            if (m_pMaterialCallback != nullptr) {
+                m_pMaterialCallback(pCommandBuffer, draw.pMaterial, m_pMaterialUserData);
+            }
+            ++m_MaterialChangeCount;
+        }
+        if (pPrevDraw == nullptr || draw.pShape != pPrevDraw->pShape) {
+            if (m_pShapeCallback != nullptr) {
+                m_pShapeCallback(pCommandBuffer, draw.pShape, m_pShapeUserData);
+            }
+            // the callback binds the vertex buffers of the shape, which may include the slot of
+            // the instance buffer
+            pCommandBuffer->SetVertexBuffer(m_InstanceBufferIndex, instanceAddress,
+                                            m_InstanceDataSize, instanceSize);
+            ++m_ShapeChangeCount;
+        }
+
+        const Mesh& mesh = *draw.pMesh;
+        pCommandBuffer->DrawIndexed(mesh.primitiveTopology, mesh.indexFormat,
+                                    mesh.indexBufferAddress, mesh.indexCount, mesh.baseVertex,
+                                    runEnd - idxDraw, idxDraw);
+        ++m_DrawCallCount;
+        pPrevDraw = &draw;
+        idxDraw = runEnd;
+    }
+
+    pInstanceBuffer->FlushMappedRange(instanceBufferOffset, instanceSize);
+}
+
+}  // namespace nn::g3d
@@ -0,0 +1,158 @@
+#include <nn/g3d/ResAnimCurve.h>
+
+#include <nn/util.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace nn::g3d {
+
+float ResAnimCurve::WrapFrame(float frame, float* pOutCycle) const {
+    *pOutCycle = 0.0f;
+
+    float duration = endFrame - startFrame;
+    WrapMode mode;
+    if (frame < startFrame) {
+        mode = GetPreWrapMode();
+    } else if (frame > endFrame) {
+        mode = GetPostWrapMode();
+    } else {
+        return frame;
+    }
+
+    if (mode == WrapMode_Clamp || duration <= 0.0f) {
+        return std::clamp(frame, startFrame, endFrame);
+    }
+
+    float cycle = std::floor((frame - startFrame) / duration);
+    float localFrame = frame - startFrame - cycle * duration;
+    switch (mode) {
+    case WrapMode_Repeat:
+        return startFrame + localFrame;
+    case WrapMode_Mirror:
+        return std::fmod(std::fabs(cycle), 2.0f) != 0.0f ? endFrame - localFrame
+                                                         : startFrame + localFrame;
+    case WrapMode_RelativeRepeat:
+        *pOutCycle = cycle;
+        return startFrame + localFrame;
+    default:
+        NN_UNEXPECTED_DEFAULT;
+    }
+}
+
+float ResAnimCurve::GetFrame(int keyIndex) const {
+    const void* pFrames = pFrameArray.Get();
+    switch (GetFrameType()) {
+    case FrameType_Quant32:
+        return static_cast<const float*>(pFrames)[keyIndex];
+    case FrameType_Quant16:
+        return static_cast<const int16_t*>(pFrames)[keyIndex] * (1.0f / 32.0f);
+    case FrameType_Quant8:
+        return static_cast<const uint8_t*>(pFrames)[keyIndex];
+    default:
+        NN_UNEXPECTED_DEFAULT;
+    }
+}
+
+float ResAnimCurve::GetKey(int index) const {
+    const void* pKeys = pKeyArray.Get();
+    switch (GetKeyType()) {
+    case KeyType_Quant32:
+        return static_cast<const float*>(pKeys)[index];
+    case KeyType_Quant16:
+        return static_cast<const int16_t*>(pKeys)[index];
+    case KeyType_Quant8:
+        return static_cast<const int8_t*>(pKeys)[index];
+    default:
+        NN_UNEXPECTED_DEFAULT;
+    }
+}
+
+int ResAnimCurve::FindKey(float frame, uint16_t* pCursor) const {
+    int lastKey = keyCount - 1;
+    if (pCursor == nullptr) {
+        int low = 0;
+        int high = lastKey;
+        while (low < high) {
+            int middle = (low + high + 1) / 2;
+            if (GetFrame(middle) <= frame) {
+                low = middle;
+            } else {
+                high = middle - 1;
+            }
+        }
+        return low;
+    }
+
+    int keyIndex = std::min(int(*pCursor), lastKey);
+    while (keyIndex > 0 && GetFrame(keyIndex) > frame) {
+        --keyIndex;
+    }
+    while (keyIndex < lastKey && GetFrame(keyIndex + 1) <= frame) {
+        ++keyIndex;
+    }
+    *pCursor = keyIndex;
+    return keyIndex;
+}
+
+float ResAnimCurve::EvaluateFloat(float frame, uint16_t* pCursor) const {
+    // a curve without keys holds its offset, which integer curves keep in iOffset
+    if (keyCount == 0) {
+        return IsFloatCurve() ? fOffset : float(iOffset);
+    }
+
+    // relative repeat shifts the values by fDelta, or iDelta, every cycle
+    float cycle;
+    float localFrame = WrapFrame(frame, &cycle);
+    float valueOffset = IsFloatCurve() ? cycle * fDelta : cycle * iDelta;
+
+    switch (GetCurveType()) {
+    case CurveType_Cubic:
+    case CurveType_Linear: {
+        int keyIndex = FindKey(localFrame, pCursor);
+        float ratio = 0.0f;
+        if (keyIndex + 1 < keyCount) {
+            float startKeyFrame = GetFrame(keyIndex);
+            float endKeyFrame = GetFrame(keyIndex + 1);
+            ratio = (localFrame - startKeyFrame) / (endKeyFrame - startKeyFrame);
+        }
+
+        if (GetCurveType() == CurveType_Linear) {
+            float c0 = GetKey(keyIndex * 2) * fScale + fOffset;
+            float c1 = GetKey(keyIndex * 2 + 1) * fScale;
+            return c0 + c1 * ratio + valueOffset;
+        }
+        float c0 = GetKey(keyIndex * 4) * fScale + fOffset;
+        float c1 = GetKey(keyIndex * 4 + 1) * fScale;
+        float c2 = GetKey(keyIndex * 4 + 2) * fScale;
+        float c3 = GetKey(keyIndex * 4 + 3) * fScale;
+        return ((c3 * ratio + c2) * ratio + c1) * ratio + c0 + valueOffset;
+    }
+    case CurveType_BakedFloat: {
+        float position = std::max(localFrame - startFrame, 0.0f);
+        int keyIndex = std::min(int(position), keyCount - 1);
+        int nextIndex = std::min(keyIndex + 1, keyCount - 1);
+        float ratio = position - keyIndex;
+        float key = GetKey(keyIndex) + (GetKey(nextIndex) - GetKey(keyIndex)) * ratio;
+        return key * fScale + fOffset + valueOffset;
+    }
+    case CurveType_StepInt:
+        return GetKey(FindKey(localFrame, pCursor)) + iOffset + valueOffset;
+    case CurveType_BakedInt: {
+        int keyIndex = std::clamp(int(localFrame - startFrame), 0, keyCount - 1);
+        return GetKey(keyIndex) + iOffset + valueOffset;
+    }
+    case CurveType_StepBool:
+    case CurveType_BakedBool: {
+        int keyIndex = GetCurveType() == CurveType_StepBool
+                           ? FindKey(localFrame, pCursor)
+                           : std::clamp(int(localFrame - startFrame), 0, keyCount - 1);
+        const uint32_t* pBits = static_cast<const uint32_t*>(pKeyArray.Get());
+        return (pBits[keyIndex / 32] >> (keyIndex % 32)) & 1 ? 1.0f : 0.0f;
+    }
+    default:
+        NN_UNEXPECTED_DEFAULT;
+    }
+}
+
+}  // namespace nn::g3d
@@ -0,0 +1,212 @@
+#include <nn/g3d/ResFileSetupScheduler.h>
+
+#include <nn/g3d/ResFile.h>
+#include <nn/g3d/ResModel.h>
+#include <nn/os.h>
+#include <nn/util/util_BytePtr.h>
+
+#include <algorithm>
+
+namespace nn::g3d {
+
+struct ResFileSetupScheduler::Entry {
+    ResFile* pResFile;
+    ptrdiff_t memoryPoolOffset;
+    size_t memoryPoolSize;
+    int firstJobIndex;
+    int modelJobCount;  // 0 for a whole-file job
+};
+
+struct ResFileSetupScheduler::Worker {
+    nn::os::ThreadType thread;
+    nn::os::EventType startEvent;
+    nn::os::EventType doneEvent;
+    ResFileSetupScheduler* pScheduler;
+};
+
+namespace {
+
+size_t AlignStackSize(size_t size) {
+    return (size + nn::os::ThreadStackAlignment - 1) & ~(nn::os::ThreadStackAlignment - 1);
+}
+
+int CountModelJobs(const ResFile* pResFile) {
+    return pResFile->mExternalFileCount == 0 ? pResFile->mModelCount : 0;
+}
+
+}  // namespace
+
+size_t ResFileSetupScheduler::CalculateMemorySize(const InfoType& info) {
+    // the stacks come first to keep their alignment
+    return AlignStackSize(info.GetThreadStackSize()) * info.GetWorkerCount() +
+           sizeof(Worker) * info.GetWorkerCount() + sizeof(Entry) * info.GetMaxFileCount();
+}
+
+size_t ResFileSetupScheduler::GetMemoryAlignment() {
+    return nn::os::ThreadStackAlignment;
+}
+
+ResFileSetupScheduler::ResFileSetupScheduler()
+    : m_pEntries(nullptr), m_pWorkers(nullptr), m_pDevice(nullptr), m_pMemoryPool(nullptr),
+      m_MemoryPoolOffset(0), m_MemoryPoolAlignment(1), m_RequiredSize(0), m_WorkerCount(0),
+      m_MaxFileCount(0), m_FileCount(0), m_JobCount(0), m_NextIndex(0), m_CompletedCount(0),
+      m_IsExitRequested(false) {}
+
+ResFileSetupScheduler::~ResFileSetupScheduler() {}
+
+bool ResFileSetupScheduler::Initialize(const InfoType& info, void* pMemory, size_t memorySize) {
+    int workerCount = info.GetWorkerCount();
+    if (workerCount <= 0 || pMemory == nullptr || memorySize < CalculateMemorySize(info)) {
+        return false;
+    }
+
+    size_t stackSize = AlignStackSize(info.GetThreadStackSize());
+
+    nn::util::BytePtr ptr(pMemory);
+    void* pStacks = ptr.Get();
+    m_pWorkers = ptr.Advance(stackSize * workerCount).Get<Worker>();
+    m_pEntries = ptr.Advance(sizeof(Worker) * workerCount).Get<Entry>();
+
+    m_IsExitRequested = false;
+    for (int idxWorker = 0; idxWorker < workerCount; ++idxWorker) {
+        Worker& worker = m_pWorkers[idxWorker];
+        worker.pScheduler = this;
+
+        // no ideal core, the workers go wherever the loading thread leaves room
+        nn::os::InitializeEvent(&worker.startEvent, false, nn::os::EventClearMode_AutoClear);
+        nn::os::InitializeEvent(&worker.doneEvent, false, nn::os::EventClearMode_AutoClear);
+        void* pStack = nn::util::BytePtr(pStacks, stackSize * idxWorker).Get();
+        if (nn::os::CreateThread(&worker.thread, WorkerThreadFunc, &worker, pStack, stackSize,
+                                 info.GetThreadPriority())
+                .IsFailure()) {
+            nn::os::FinalizeEvent(&worker.startEvent);
+            nn::os::FinalizeEvent(&worker.doneEvent);
+            m_WorkerCount = idxWorker;
+            Finalize();
+            return false;
+        }
+        nn::os::SetThreadNamePointer(&worker.thread, "g3d::ResFileSetup");
+        nn::os::StartThread(&worker.thread);
+        m_WorkerCount = idxWorker + 1;
+    }
+
+    m_MemoryPoolAlignment = info.GetMemoryPoolAlignment();
+    m_MaxFileCount = info.GetMaxFileCount();
+    Clear();
+    return true;
+}
+
+void ResFileSetupScheduler::Finalize() {
+    m_IsExitRequested = true;
+    for (int idxWorker = 0; idxWorker < m_WorkerCount; ++idxWorker) {
+        Worker& worker = m_pWorkers[idxWorker];
+        nn::os::SignalEvent(&worker.startEvent);
+        nn::os::WaitThread(&worker.thread);
+        nn::os::DestroyThread(&worker.thread);
+        nn::os::FinalizeEvent(&worker.startEvent);
+        nn::os::FinalizeEvent(&worker.doneEvent);
+    }
+
+    m_pEntries = nullptr;
+    m_pWorkers = nullptr;
+    m_WorkerCount = 0;
+    m_FileCount = 0;
+    m_JobCount = 0;
+}
+
+void ResFileSetupScheduler::Clear() {
+    m_FileCount = 0;
+    m_JobCount = 0;
+    m_RequiredSize = 0;
+    m_NextIndex.store(0, std::memory_order_relaxed);
+    m_CompletedCount.store(0, std::memory_order_relaxed);
+}
+
+bool ResFileSetupScheduler::Add(ResFile* pResFile) {
+    if (m_FileCount >= m_MaxFileCount) {
+        return false;
+    }
+
+    Entry& entry = m_pEntries[m_FileCount++];
+    entry.pResFile = pResFile;
+    entry.memoryPoolSize = pResFile->GetBufferMemoryPoolSize();
+    entry.memoryPoolOffset = m_RequiredSize;
+    entry.firstJobIndex = 0;
+    entry.modelJobCount = 0;
+    m_RequiredSize = (m_RequiredSize + entry.memoryPoolSize + m_MemoryPoolAlignment - 1) &
+                     ~(m_MemoryPoolAlignment - 1);
+    return true;
+}
+
+ptrdiff_t ResFileSetupScheduler::GetMemoryPoolOffset(int fileIndex) const {
+    return m_pEntries[fileIndex].memoryPoolOffset;
+}
+
+void ResFileSetupScheduler::Start(gfx::Device* pDevice, gfx::MemoryPool* pMemoryPool,
+                                  ptrdiff_t memoryPoolOffset) {
+    m_pDevice = pDevice;
+    m_pMemoryPool = pMemoryPool;
+    m_MemoryPoolOffset = memoryPoolOffset;
+
+    m_JobCount = 0;
+    for (int idxFile = 0; idxFile < m_FileCount; ++idxFile) {
+        Entry& entry = m_pEntries[idxFile];
+        entry.firstJobIndex = m_JobCount;
+        entry.modelJobCount = pMemoryPool == nullptr ? CountModelJobs(entry.pResFile) : 0;
+        m_JobCount += std::max(entry.modelJobCount, 1);
+    }
+
+    m_NextIndex.store(0, std::memory_order_relaxed);
+    m_CompletedCount.store(0, std::memory_order_release);
+    for (int idxWorker = 0; idxWorker < m_WorkerCount; ++idxWorker) {
+        nn::os::SignalEvent(&m_pWorkers[idxWorker].startEvent);
+    }
+}
+
+void ResFileSetupScheduler::Wait() {
+    for (int idxWorker = 0; idxWorker < m_WorkerCount; ++idxWorker) {
+        nn::os::WaitEvent(&m_pWorkers[idxWorker].doneEvent);
+    }
+}
+
+void ResFileSetupScheduler::WorkerThreadFunc(void* pArg) {
+    Worker* pWorker = static_cast<Worker*>(pArg);
+    for (;;) {
+        nn::os::WaitEvent(&pWorker->startEvent);
+        if (pWorker->pScheduler->m_IsExitRequested) {
+            break;
+        }
+        pWorker->pScheduler->Execute();
+        nn::os::SignalEvent(&pWorker->doneEvent);
+    }
+}
+
+void ResFileSetupScheduler::Execute() {
+    for (;;) {
+        int index = m_NextIndex.fetch_add(1, std::memory_order_relaxed);
+        if (index >= m_JobCount) {
+            break;
+        }
+
+        ExecuteJob(index);
+        m_CompletedCount.fetch_add(1, std::memory_order_release);
+    }
+}
+
+void ResFileSetupScheduler::ExecuteJob(int jobIndex) {
+    // the last file whose first job is at or before jobIndex
+    auto isBefore = [](int index, const Entry& entry) { return index < entry.firstJobIndex; };
+    const Entry& entry =
+        *(std::upper_bound(m_pEntries, m_pEntries + m_FileCount, jobIndex, isBefore) - 1);
+
+    if (entry.modelJobCount > 0) {
+        entry.pResFile->mModels[jobIndex - entry.firstJobIndex].Setup(m_pDevice);
+    } else if (m_pMemoryPool == nullptr) {
+        entry.pResFile->Setup(m_pDevice);
+    } else {
+        entry.pResFile->Setup(m_pDevice, m_pMemoryPool, m_MemoryPoolOffset + entry.memoryPoolOffset,
+                              entry.memoryPoolSize);
+    }
+}
+
+}  // namespace nn::g3d
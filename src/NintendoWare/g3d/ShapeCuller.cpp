@@ -0,0 +1,233 @@
+#include <nn/g3d/ShapeCuller.h>
+
+#include <nn/g3d/HiZBuffer.h>
+#include <nn/g3d/ResShape.h>
+#include <nn/g3d/SkeletonEvaluator.h>
+#include <nn/util/util_BytePtr.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace nn::g3d {
+
+namespace {
+
+int AlignShapeCount(int shapeCount) {
+    return (shapeCount + ShapeCuller::CullWidth - 1) & ~(ShapeCuller::CullWidth - 1);
+}
+
+void Multiply(nn::util::FloatColumnMajor4x3* pOut, const nn::util::FloatColumnMajor4x3& lhs,
+              const nn::util::FloatColumnMajor4x3& rhs) {
+    for (int row = 0; row < 3; ++row) {
+        for (int column = 0; column < 4; ++column) {
+            pOut->m[row][column] = lhs.m[row][0] * rhs.m[0][column] +
+                                   lhs.m[row][1] * rhs.m[1][column] +
+                                   lhs.m[row][2] * rhs.m[2][column];
+        }
+        pOut->m[row][3] += lhs.m[row][3];
+    }
+}
+
+// the box stays axis aligned by growing to hold the rotated one
+void ExpandBounds(nn::util::Float3* pMin, nn::util::Float3* pMax,
+                  const nn::util::FloatColumnMajor4x3& mtx, const Bounding& bounding) {
+    for (int row = 0; row < 3; ++row) {
+        float center = mtx.m[row][3];
+        float extent = 0.0f;
+        for (int column = 0; column < 3; ++column) {
+            center += mtx.m[row][column] * bounding.center.v[column];
+            extent += std::abs(mtx.m[row][column]) * bounding.extent.v[column];
+        }
+        pMin->v[row] = std::min(pMin->v[row], center - extent);
+        pMax->v[row] = std::max(pMax->v[row], center + extent);
+    }
+}
+
+}  // namespace
+
+size_t ShapeCuller::CalculateBufferSize(int maxShapeCount) {
+    int alignedCount = AlignShapeCount(maxShapeCount);
+    return sizeof(float) * BoundsElement_Count * alignedCount +
+           sizeof(uint32_t) * (alignedCount + maxShapeCount);
+}
+
+size_t ShapeCuller::GetBufferAlignment() {
+    return sizeof(float) * CullWidth;
+}
+
+ShapeCuller::ShapeCuller()
+    : m_BoundsArray(), m_IdArray(nullptr), m_VisibleIdArray(nullptr), m_PlaneArray(),
+      m_ViewProj(), m_MaxShapeCount(0), m_ShapeCount(0), m_VisibleCount(0),
+      m_FrustumCulledCount(0), m_OcclusionCulledCount(0) {}
+
+bool ShapeCuller::Initialize(int maxShapeCount, void* buffer, size_t bufferSize) {
+    if (buffer == nullptr || bufferSize < CalculateBufferSize(maxShapeCount)) {
+        return false;
+    }
+
+    int alignedCount = AlignShapeCount(maxShapeCount);
+    nn::util::BytePtr ptr(buffer);
+    for (int idxElement = 0; idxElement < BoundsElement_Count; ++idxElement) {
+        m_BoundsArray[idxElement] = ptr.Get<float>();
+        ptr.Advance(sizeof(float) * alignedCount);
+        std::fill_n(m_BoundsArray[idxElement], alignedCount, 0.0f);
+    }
+    m_IdArray = ptr.Get<uint32_t>();
+    m_VisibleIdArray = ptr.Advance(sizeof(uint32_t) * alignedCount).Get<uint32_t>();
+    m_MaxShapeCount = maxShapeCount;
+    Clear();
+    return true;
+}
+
+void ShapeCuller::Clear() {
+    m_ShapeCount = 0;
+    m_VisibleCount = 0;
+    m_FrustumCulledCount = 0;
+    m_OcclusionCulledCount = 0;
+}
+
+bool ShapeCuller::AddShape(uint32_t id, const ResShape* pShape, const SkeletonEvaluator& skeleton) {
+    const Bounding& bounding = pShape->GetBounding();
+    const nn::util::FloatColumnMajor4x3* pWorldMtxArray = skeleton.GetWorldMtxArray();
+    nn::util::Float3 min = {{{INFINITY, INFINITY, INFINITY}}};
+    nn::util::Float3 max = {{{-INFINITY, -INFINITY, -INFINITY}}};
+
+    // rigid skinning vertices are in the space of their bone, smooth skinning ones in the space
+    // of the model and are brought there by the inverse bind matrix first
+    if (pShape->IsRigidBody()) {
+        ExpandBounds(&min, &max, pWorldMtxArray[pShape->GetBoneIndex()], bounding);
+    } else {
+        const ResSkeleton* pRes = skeleton.GetRes();
+        const nn::util::FloatColumnMajor4x3* pInvModelMtxArray =
+            pRes->ToData().pInvModelMatrixArray.Get();
+        for (int idxSkin = 0; idxSkin < pShape->GetSkinBoneIndexCount(); ++idxSkin) {
+            int boneIndex = pShape->GetSkinBoneIndex(idxSkin);
+            int smoothMtxIndex = pRes->GetBone(boneIndex)->GetSmoothMtxIndex();
+            if (pShape->IsSmoothSkinning() && smoothMtxIndex >= 0) {
+                nn::util::FloatColumnMajor4x3 skinMtx;
+                Multiply(&skinMtx, pWorldMtxArray[boneIndex], pInvModelMtxArray[smoothMtxIndex]);
+                ExpandBounds(&min, &max, skinMtx, bounding);
+            } else {
+                ExpandBounds(&min, &max, pWorldMtxArray[boneIndex], bounding);
+            }
+        }
+    }
+
+    nn::util::Float3 center;
+    nn::util::Float3 extent;
+    for (int axis = 0; axis < 3; ++axis) {
+        center.v[axis] = (min.v[axis] + max.v[axis]) * 0.5f;
+        extent.v[axis] = (max.v[axis] - min.v[axis]) * 0.5f;
+    }
+    return AddBounds(id, center, extent);
+}
+
+bool ShapeCuller::AddBounds(uint32_t id, const nn::util::Float3& center,
+                            const nn::util::Float3& extent) {
+    if (m_ShapeCount >= m_MaxShapeCount) {
+        return false;
+    }
+
+    int index = m_ShapeCount++;
+    for (int axis = 0; axis < 3; ++axis) {
+        m_BoundsArray[BoundsElement_CenterX + axis][index] = center.v[axis];
+        m_BoundsArray[BoundsElement_ExtentX + axis][index] = extent.v[axis];
+    }
+    m_IdArray[index] = id;
+    return true;
+}
+
+void ShapeCuller::SetViewProjection(const nn::util::FloatColumnMajor4x4& viewProj) {
+    // every plane keeps the volume on its positive side: left, right, bottom, top, near, far
+    const float(&m)[4][4] = viewProj.m;
+    for (int column = 0; column < 4; ++column) {
+        m_PlaneArray[0].v[column] = m[3][column] + m[0][column];
+        m_PlaneArray[1].v[column] = m[3][column] - m[0][column];
+        m_PlaneArray[2].v[column] = m[3][column] + m[1][column];
+        m_PlaneArray[3].v[column] = m[3][column] - m[1][column];
+        m_PlaneArray[4].v[column] = m[2][column];
+        m_PlaneArray[5].v[column] = m[3][column] - m[2][column];
+    }
+    m_ViewProj = viewProj;
+}
+
+void ShapeCuller::Cull(const HiZBuffer* pHiZBuffer) {
+    m_VisibleCount = 0;
+    m_FrustumCulledCount = 0;
+    m_OcclusionCulledCount = 0;
+
+    // the lane loops have no dependency between bounds and are left to the vectorizer
+    for (int idxBatch = 0; idxBatch < m_ShapeCount; idxBatch += CullWidth) {
+        const float* cx = &m_BoundsArray[BoundsElement_CenterX][idxBatch];
+        const float* cy = &m_BoundsArray[BoundsElement_CenterY][idxBatch];
+        const float* cz = &m_BoundsArray[BoundsElement_CenterZ][idxBatch];
+        const float* ex = &m_BoundsArray[BoundsElement_ExtentX][idxBatch];
+        const float* ey = &m_BoundsArray[BoundsElement_ExtentY][idxBatch];
+        const float* ez = &m_BoundsArray[BoundsElement_ExtentZ][idxBatch];
+
+        // a box is outside when its nearest corner to a plane is behind it
+        int isInside[CullWidth];
+        std::fill_n(isInside, CullWidth, 1);
+        for (int idxPlane = 0; idxPlane < PlaneCount; ++idxPlane) {
+            const nn::util::Float4& plane = m_PlaneArray[idxPlane];
+            float ax = std::abs(plane.x);
+            float ay = std::abs(plane.y);
+            float az = std::abs(plane.z);
+            for (int lane = 0; lane < CullWidth; ++lane) {
+                float distance = plane.x * cx[lane] + plane.y * cy[lane] + plane.z * cz[lane] +
+                                 plane.w + ax * ex[lane] + ay * ey[lane] + az * ez[lane];
+                isInside[lane] &= distance >= 0.0f;
+            }
+        }
+
+        int laneCount = std::min(int(CullWidth), m_ShapeCount - idxBatch);
+        for (int lane = 0; lane < laneCount; ++lane) {
+            if (!isInside[lane]) {
+                ++m_FrustumCulledCount;
+            } else if (pHiZBuffer != nullptr && IsOccluded(*pHiZBuffer, idxBatch + lane)) {
+                ++m_OcclusionCulledCount;
+            } else {
+                m_VisibleIdArray[m_VisibleCount++] = m_IdArray[idxBatch + lane];
+            }
+        }
+    }
+}
+
+bool ShapeCuller::IsOccluded(const HiZBuffer& hiZBuffer, int index) const {
+    float left = INFINITY;
+    float top = INFINITY;
+    float right = -INFINITY;
+    float bottom = -INFINITY;
+    float minDepth = INFINITY;
+    for (int corner = 0; corner < 8; ++corner) {
+        float position[4] = {};
+        for (int axis = 0; axis < 3; ++axis) {
+            float sign = (corner >> axis) & 1 ? 1.0f : -1.0f;
+            position[axis] = m_BoundsArray[BoundsElement_CenterX + axis][index] +
+                             sign * m_BoundsArray[BoundsElement_ExtentX + axis][index];
+        }
+        position[3] = 1.0f;
+
+        float clip[4];
+        for (int row = 0; row < 4; ++row) {
+            clip[row] = m_ViewProj.m[row][0] * position[0] + m_ViewProj.m[row][1] * position[1] +
+                        m_ViewProj.m[row][2] * position[2] + m_ViewProj.m[row][3];
+        }
+
+        // a box reaching behind the eye cannot be projected and is kept
+        if (clip[3] <= 0.0f) {
+            return false;
+        }
+        float invW = 1.0f / clip[3];
+        float u = clip[0] * invW * 0.5f + 0.5f;
+        float v = 0.5f - clip[1] * invW * 0.5f;
+        left = std::min(left, u);
+        right = std::max(right, u);
+        top = std::min(top, v);
+        bottom = std::max(bottom, v);
+        minDepth = std::min(minDepth, clip[2] * invW);
+    }
+    return hiZBuffer.IsOccluded(left, top, right, bottom, minDepth);
+}
+
+}  // namespace nn::g3d
@@ -0,0 +1,126 @@
+#include <nn/g3d/SkeletalAnimBlender.h>
+
+#include <nn/g3d/SkeletalAnimObj.h>
+#include <nn/util/util_BytePtr.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace nn::g3d {
+
+namespace {
+
+int AlignBoneCount(int boneCount) {
+    return (boneCount + SkeletonEvaluator::SimdWidth - 1) & ~(SkeletonEvaluator::SimdWidth - 1);
+}
+
+}  // namespace
+
+size_t SkeletalAnimBlender::CalculateBufferSize(int boneCount) {
+    return sizeof(float) * (SkeletonEvaluator::LocalElement_Count + 1) * AlignBoneCount(boneCount);
+}
+
+size_t SkeletalAnimBlender::GetBufferAlignment() {
+    return sizeof(float) * SkeletonEvaluator::SimdWidth;
+}
+
+SkeletalAnimBlender::SkeletalAnimBlender()
+    : m_SumArray(), m_WeightSumArray(nullptr), m_BoneCount(0) {}
+
+bool SkeletalAnimBlender::Initialize(int boneCount, void* buffer, size_t bufferSize) {
+    if (buffer == nullptr || bufferSize < CalculateBufferSize(boneCount)) {
+        return false;
+    }
+
+    int alignedCount = AlignBoneCount(boneCount);
+    nn::util::BytePtr ptr(buffer);
+    for (int idxElement = 0; idxElement < SkeletonEvaluator::LocalElement_Count; ++idxElement) {
+        m_SumArray[idxElement] = ptr.Get<float>();
+        ptr.Advance(sizeof(float) * alignedCount);
+    }
+    m_WeightSumArray = ptr.Get<float>();
+    m_BoneCount = boneCount;
+    return true;
+}
+
+void SkeletalAnimBlender::Blend(SkeletonEvaluator* pSkeleton, const SkeletalAnimObj* const* ppAnims,
+                                const float* pWeights, int animCount) {
+    int alignedCount = AlignBoneCount(std::min(m_BoneCount, pSkeleton->GetBoneCount()));
+    for (int idxElement = 0; idxElement < SkeletonEvaluator::LocalElement_Count; ++idxElement) {
+        std::fill_n(m_SumArray[idxElement], alignedCount, 0.0f);
+    }
+    std::fill_n(m_WeightSumArray, alignedCount, 0.0f);
+
+    float* sx = m_SumArray[SkeletonEvaluator::LocalElement_ScaleX];
+    float* sy = m_SumArray[SkeletonEvaluator::LocalElement_ScaleY];
+    float* sz = m_SumArray[SkeletonEvaluator::LocalElement_ScaleZ];
+    float* qx = m_SumArray[SkeletonEvaluator::LocalElement_RotateX];
+    float* qy = m_SumArray[SkeletonEvaluator::LocalElement_RotateY];
+    float* qz = m_SumArray[SkeletonEvaluator::LocalElement_RotateZ];
+    float* qw = m_SumArray[SkeletonEvaluator::LocalElement_RotateW];
+    float* tx = m_SumArray[SkeletonEvaluator::LocalElement_TranslateX];
+    float* ty = m_SumArray[SkeletonEvaluator::LocalElement_TranslateY];
+    float* tz = m_SumArray[SkeletonEvaluator::LocalElement_TranslateZ];
+    float* ws = m_WeightSumArray;
+
+    // the loops over bones carry no dependency and are left to the vectorizer
+    for (int idxAnim = 0; idxAnim < animCount; ++idxAnim) {
+        const SkeletalAnimObj* pAnim = ppAnims[idxAnim];
+        float weight = pWeights[idxAnim];
+        const float* bw = pAnim->GetBoneWeightArray();
+        const float* asx = pAnim->GetResultArray(SkeletonEvaluator::LocalElement_ScaleX);
+        const float* asy = pAnim->GetResultArray(SkeletonEvaluator::LocalElement_ScaleY);
+        const float* asz = pAnim->GetResultArray(SkeletonEvaluator::LocalElement_ScaleZ);
+        const float* aqx = pAnim->GetResultArray(SkeletonEvaluator::LocalElement_RotateX);
+        const float* aqy = pAnim->GetResultArray(SkeletonEvaluator::LocalElement_RotateY);
+        const float* aqz = pAnim->GetResultArray(SkeletonEvaluator::LocalElement_RotateZ);
+        const float* aqw = pAnim->GetResultArray(SkeletonEvaluator::LocalElement_RotateW);
+        const float* atx = pAnim->GetResultArray(SkeletonEvaluator::LocalElement_TranslateX);
+        const float* aty = pAnim->GetResultArray(SkeletonEvaluator::LocalElement_TranslateY);
+        const float* atz = pAnim->GetResultArray(SkeletonEvaluator::LocalElement_TranslateZ);
+
+        for (int idxBone = 0; idxBone < alignedCount; ++idxBone) {
+            float w = weight * bw[idxBone];
+            float dot = qx[idxBone] * aqx[idxBone] + qy[idxBone] * aqy[idxBone] +
+                        qz[idxBone] * aqz[idxBone] + qw[idxBone] * aqw[idxBone];
+            float wq = dot < 0.0f ? -w : w;
+
+            sx[idxBone] += w * asx[idxBone];
+            sy[idxBone] += w * asy[idxBone];
+            sz[idxBone] += w * asz[idxBone];
+            qx[idxBone] += wq * aqx[idxBone];
+            qy[idxBone] += wq * aqy[idxBone];
+            qz[idxBone] += wq * aqz[idxBone];
+            qw[idxBone] += wq * aqw[idxBone];
+            tx[idxBone] += w * atx[idxBone];
+            ty[idxBone] += w * aty[idxBone];
+            tz[idxBone] += w * atz[idxBone];
+            ws[idxBone] += w;
+        }
+    }
+
+    float* dst[SkeletonEvaluator::LocalElement_Count];
+    for (int idxElement = 0; idxElement < SkeletonEvaluator::LocalElement_Count; ++idxElement) {
+        dst[idxElement] = pSkeleton->GetLocalArray(SkeletonEvaluator::LocalElement(idxElement));
+    }
+    for (int idxBone = 0; idxBone < alignedCount; ++idxBone) {
+        bool isBlended = ws[idxBone] > 0.0f;
+        float invWeight = isBlended ? 1.0f / ws[idxBone] : 0.0f;
+        float lengthSq = qx[idxBone] * qx[idxBone] + qy[idxBone] * qy[idxBone] +
+                         qz[idxBone] * qz[idxBone] + qw[idxBone] * qw[idxBone];
+        float invLength = lengthSq > 0.0f ? 1.0f / std::sqrt(lengthSq) : 0.0f;
+
+        float value[SkeletonEvaluator::LocalElement_Count] = {
+            sx[idxBone] * invWeight, sy[idxBone] * invWeight, sz[idxBone] * invWeight,
+            qx[idxBone] * invLength, qy[idxBone] * invLength, qz[idxBone] * invLength,
+            qw[idxBone] * invLength, tx[idxBone] * invWeight, ty[idxBone] * invWeight,
+            tz[idxBone] * invWeight};
+        for (int idxElement = 0; idxElement < SkeletonEvaluator::LocalElement_Count; ++idxElement) {
+            dst[idxElement][idxBone] = isBlended ? value[idxElement] : dst[idxElement][idxBone];
+        }
+    }
+
+    pSkeleton->UpdateLocalFlags();
+}
+
+}  // namespace nn::g3d
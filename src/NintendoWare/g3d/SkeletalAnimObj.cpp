@@ -0,0 +1,218 @@
+#include <nn/g3d/SkeletalAnimObj.h>
+
+#include <nn/util/util_BytePtr.h>
+
+#include <algorithm>
+#include <cmath>
+
+#include "detail/MathHelper.h"
+
+namespace nn::g3d {
+
+namespace {
+
+int AlignBoneCount(int boneCount) {
+    return (boneCount + SkeletonEvaluator::SimdWidth - 1) & ~(SkeletonEvaluator::SimdWidth - 1);
+}
+
+const nn::Bit32 CurveRotateMask =
+    ResBoneAnim::Flag_CurveRotateX | ResBoneAnim::Flag_CurveRotateY |
+    ResBoneAnim::Flag_CurveRotateZ | ResBoneAnim::Flag_CurveRotateW;
+
+}  // namespace
+
+size_t SkeletalAnimObj::CalculateBufferSize(const InitializeArgument& arg) {
+    const ResSkeletalAnim* pResAnim = arg.GetResource();
+    int alignedCount = AlignBoneCount(arg.GetSkeleton()->GetBoneCount());
+    int eulerCount =
+        pResAnim->GetRotateMode() == ResSkeletalAnim::RotateMode_EulerXyz ? EulerElementCount : 0;
+
+    return sizeof(float) * (SkeletonEvaluator::LocalElement_Count + eulerCount + 1) * alignedCount +
+           sizeof(uint16_t) * (pResAnim->GetBoneAnimCount() + pResAnim->GetCurveCount());
+}
+
+size_t SkeletalAnimObj::GetBufferAlignment() {
+    return sizeof(float) * SkeletonEvaluator::SimdWidth;
+}
+
+SkeletalAnimObj::SkeletalAnimObj()
+    : m_Res(nullptr), m_ResultArray(), m_EulerArray(), m_BoneWeightArray(nullptr),
+      m_TargetBoneArray(nullptr), m_CursorArray(nullptr), m_Frame(0.0f), m_BoneCount(0),
+      m_BoundBoneCount(0), m_IsEuler(false) {}
+
+bool SkeletalAnimObj::Initialize(const InitializeArgument& arg, void* buffer, size_t bufferSize) {
+    if (buffer == nullptr || bufferSize < CalculateBufferSize(arg)) {
+        return false;
+    }
+
+    const ResSkeletalAnim* pResAnim = arg.GetResource();
+    const ResSkeleton* pResSkeleton = arg.GetSkeleton();
+    int boneCount = pResSkeleton->GetBoneCount();
+    int alignedCount = AlignBoneCount(boneCount);
+    m_IsEuler = pResAnim->GetRotateMode() == ResSkeletalAnim::RotateMode_EulerXyz;
+
+    nn::util::BytePtr ptr(buffer);
+    for (int idxElement = 0; idxElement < SkeletonEvaluator::LocalElement_Count; ++idxElement) {
+        m_ResultArray[idxElement] = ptr.Get<float>();
+        ptr.Advance(sizeof(float) * alignedCount);
+    }
+    for (int idxElement = 0; idxElement < EulerElementCount; ++idxElement) {
+        m_EulerArray[idxElement] = m_IsEuler ? ptr.Get<float>() : nullptr;
+        ptr.Advance(m_IsEuler ? sizeof(float) * alignedCount : 0);
+    }
+    m_BoneWeightArray = ptr.Get<float>();
+    m_TargetBoneArray = ptr.Advance(sizeof(float) * alignedCount).Get<uint16_t>();
+    m_CursorArray = ptr.Advance(sizeof(uint16_t) * pResAnim->GetBoneAnimCount()).Get<uint16_t>();
+
+    m_Res = pResAnim;
+    m_BoneCount = boneCount;
+    m_Frame = 0.0f;
+    std::fill_n(m_CursorArray, pResAnim->GetCurveCount(), uint16_t(0));
+    std::fill_n(m_BoneWeightArray, alignedCount, 0.0f);
+
+    // every bone starts from its bind pose, the padding lanes from identity
+    for (int idxBone = 0; idxBone < alignedCount; ++idxBone) {
+        nn::util::Float3 scale = {{{1.0f, 1.0f, 1.0f}}};
+        nn::util::Float4 quat = {{{0.0f, 0.0f, 0.0f, 1.0f}}};
+        nn::util::Float3 translate = {{{0.0f, 0.0f, 0.0f}}};
+        nn::util::Float3 euler = {{{0.0f, 0.0f, 0.0f}}};
+        if (idxBone < boneCount) {
+            const ResBone* pBone = pResSkeleton->GetBone(idxBone);
+            scale = pBone->GetScale();
+            translate = pBone->GetTranslate();
+            if (pBone->GetRotateMode() == ResBone::RotateMode_EulerXyz) {
+                euler = pBone->GetRotateEuler();
+                quat = detail::ConvertEulerXyzToQuat(euler);
+            } else {
+                quat = pBone->GetRotateQuat();
+            }
+        }
+
+        for (int axis = 0; axis < 3; ++axis) {
+            m_ResultArray[SkeletonEvaluator::LocalElement_ScaleX + axis][idxBone] = scale.v[axis];
+            m_ResultArray[SkeletonEvaluator::LocalElement_TranslateX + axis][idxBone] =
+                translate.v[axis];
+            if (m_IsEuler) {
+                m_EulerArray[axis][idxBone] = euler.v[axis];
+            }
+        }
+        for (int axis = 0; axis < 4; ++axis) {
+            m_ResultArray[SkeletonEvaluator::LocalElement_RotateX + axis][idxBone] = quat.v[axis];
+        }
+    }
+
+    // then the base values of the bone animations replace what they hold
+    m_BoundBoneCount = 0;
+    for (int idxAnim = 0; idxAnim < pResAnim->GetBoneAnimCount(); ++idxAnim) {
+        const ResBoneAnim* pBoneAnim = pResAnim->GetBoneAnim(idxAnim);
+        int boneIndex = pResSkeleton->FindBoneIndex(pBoneAnim->GetName());
+        if (boneIndex == nn::util::ResDic::Npos) {
+            m_TargetBoneArray[idxAnim] = ResBone::InvalidBoneIndex;
+            continue;
+        }
+        m_TargetBoneArray[idxAnim] = boneIndex;
+        m_BoneWeightArray[boneIndex] = 1.0f;
+        ++m_BoundBoneCount;
+
+        nn::Bit32 flag = pBoneAnim->GetFlag();
+        const float* pBase = pBoneAnim->GetBaseValueArray();
+        if (flag & ResBoneAnim::Flag_BaseScale) {
+            for (int axis = 0; axis < 3; ++axis) {
+                m_ResultArray[SkeletonEvaluator::LocalElement_ScaleX + axis][boneIndex] = *pBase++;
+            }
+        }
+        if (flag & ResBoneAnim::Flag_BaseRotate) {
+            for (int axis = 0; axis < 4; ++axis, ++pBase) {
+                if (!m_IsEuler) {
+                    m_ResultArray[SkeletonEvaluator::LocalElement_RotateX + axis][boneIndex] =
+                        *pBase;
+                } else if (axis < EulerElementCount) {
+                    m_EulerArray[axis][boneIndex] = *pBase;
+                }
+            }
+            UpdateRotate(boneIndex);
+        }
+        if (flag & ResBoneAnim::Flag_BaseTranslate) {
+            for (int axis = 0; axis < 3; ++axis) {
+                m_ResultArray[SkeletonEvaluator::LocalElement_TranslateX + axis][boneIndex] =
+                    *pBase++;
+            }
+        }
+    }
+    return true;
+}
+
+void SkeletalAnimObj::SetFrame(float frame) {
+    float frameCount = static_cast<float>(m_Res->GetFrameCount());
+    if (!m_Res->IsLooped()) {
+        m_Frame = std::clamp(frame, 0.0f, frameCount);
+    } else if (frameCount > 0.0f) {
+        m_Frame = std::fmod(frame, frameCount);
+        m_Frame = m_Frame < 0.0f ? m_Frame + frameCount : m_Frame;
+    } else {
+        m_Frame = 0.0f;
+    }
+}
+
+void SkeletalAnimObj::Calculate() {
+    for (int idxAnim = 0; idxAnim < m_Res->GetBoneAnimCount(); ++idxAnim) {
+        int boneIndex = m_TargetBoneArray[idxAnim];
+        if (boneIndex == ResBone::InvalidBoneIndex) {
+            continue;
+        }
+
+        const ResBoneAnim* pBoneAnim = m_Res->GetBoneAnim(idxAnim);
+        uint16_t* pCursors = &m_CursorArray[pBoneAnim->GetBeginCurve()];
+        for (int idxCurve = 0; idxCurve < pBoneAnim->GetCurveCount(); ++idxCurve) {
+            const ResAnimCurve* pCurve = pBoneAnim->GetCurve(idxCurve);
+            float* pTarget = GetTarget(pCurve->GetTargetOffset(), boneIndex);
+            if (pTarget != nullptr) {
+                *pTarget = pCurve->EvaluateFloat(m_Frame, &pCursors[idxCurve]);
+            }
+        }
+
+        if (pBoneAnim->GetFlag() & CurveRotateMask) {
+            UpdateRotate(boneIndex);
+        }
+    }
+}
+
+float* SkeletalAnimObj::GetTarget(uint32_t targetOffset, int boneIndex) {
+    int element;
+    if (targetOffset >= ResBoneAnim::TargetOffset_RotateX &&
+        targetOffset <= ResBoneAnim::TargetOffset_RotateW) {
+        int axis = (targetOffset - ResBoneAnim::TargetOffset_RotateX) / sizeof(float);
+        if (m_IsEuler) {
+            return axis < EulerElementCount ? &m_EulerArray[axis][boneIndex] : nullptr;
+        }
+        element = SkeletonEvaluator::LocalElement_RotateX + axis;
+    } else if (targetOffset >= ResBoneAnim::TargetOffset_TranslateX &&
+               targetOffset <= ResBoneAnim::TargetOffset_TranslateZ) {
+        element = SkeletonEvaluator::LocalElement_TranslateX +
+                  (targetOffset - ResBoneAnim::TargetOffset_TranslateX) / sizeof(float);
+    } else if (targetOffset >= ResBoneAnim::TargetOffset_ScaleX &&
+               targetOffset <= ResBoneAnim::TargetOffset_ScaleZ) {
+        element = SkeletonEvaluator::LocalElement_ScaleX +
+                  (targetOffset - ResBoneAnim::TargetOffset_ScaleX) / sizeof(float);
+    } else {
+        return nullptr;
+    }
+    return &m_ResultArray[element][boneIndex];
+}
+
+void SkeletalAnimObj::UpdateRotate(int boneIndex) {
+    if (!m_IsEuler) {
+        return;
+    }
+
+    nn::util::Float3 euler;
+    for (int axis = 0; axis < EulerElementCount; ++axis) {
+        euler.v[axis] = m_EulerArray[axis][boneIndex];
+    }
+    nn::util::Float4 quat = detail::ConvertEulerXyzToQuat(euler);
+    for (int axis = 0; axis < 4; ++axis) {
+        m_ResultArray[SkeletonEvaluator::LocalElement_RotateX + axis][boneIndex] = quat.v[axis];
+    }
+}
+
+}  // namespace nn::g3d
@@ -0,0 +1,257 @@
+#include <nn/g3d/SkeletonEvaluationScheduler.h>
+
+#include <nn/g3d/SkeletonEvaluator.h>
+#include <nn/g3d/SkinningPaletteBuilder.h>
+#include <nn/gfx/detail/gfx_Buffer-api.nvn.8.h>
+#include <nn/os.h>
+#include <nn/util/util_BytePtr.h>
+
+#include <algorithm>
+
+namespace nn::g3d {
+
+struct SkeletonEvaluationScheduler::Entry {
+    SkeletonEvaluator* pSkeleton;
+    const SkinningPaletteBuilder* pPaletteBuilder;
+    nn::util::FloatColumnMajor4x3 baseMtx;
+    ptrdiff_t paletteOffset;
+    size_t paletteSize;
+};
+
+struct SkeletonEvaluationScheduler::Worker {
+    nn::os::ThreadType thread;
+    nn::os::EventType startEvent;
+    nn::os::EventType doneEvent;
+    SkeletonEvaluationScheduler* pScheduler;
+    int index;
+    int beginEntry;
+    int endEntry;
+    int boneCount;
+};
+
+namespace {
+
+size_t AlignStackSize(size_t size) {
+    return (size + nn::os::ThreadStackAlignment - 1) & ~(nn::os::ThreadStackAlignment - 1);
+}
+
+// worker n + 1 takes the n-th set bit of the mask, starting over past the last one
+int GetIdealCore(nn::Bit32 coreMask, int workerIndex) {
+    if (coreMask == 0) {
+        return nn::os::IdealCoreUseDefaultValue;
+    }
+
+    int order = (workerIndex - 1) % __builtin_popcount(coreMask);
+    for (int core = 0;; ++core) {
+        if (((coreMask >> core) & 1) != 0 && order-- == 0) {
+            return core;
+        }
+    }
+}
+
+}  // namespace
+
+size_t SkeletonEvaluationScheduler::CalculateMemorySize(const InfoType& info) {
+    // the stacks come first to keep their alignment
+    return AlignStackSize(info.GetThreadStackSize()) * (info.GetWorkerCount() - 1) +
+           sizeof(Worker) * info.GetWorkerCount() + sizeof(Entry) * info.GetMaxSkeletonCount();
+}
+
+size_t SkeletonEvaluationScheduler::GetMemoryAlignment() {
+    return nn::os::ThreadStackAlignment;
+}
+
+size_t SkeletonEvaluationScheduler::CalculatePaletteBufferSize(const InfoType& info) {
+    return info.GetPaletteSectionSize() * info.GetBufferingCount();
+}
+
+SkeletonEvaluationScheduler::SkeletonEvaluationScheduler()
+    : m_pBuffer(nullptr), m_pMappedBuffer(nullptr), m_BufferOffset(0), m_SectionSize(0),
+      m_pEntries(nullptr), m_pWorkers(nullptr), m_WorkerCount(0), m_MaxEntryCount(0),
+      m_EntryCount(0), m_BufferingCount(0), m_SectionIndex(0), m_UsedSize(0),
+      m_IsExitRequested(false) {}
+
+SkeletonEvaluationScheduler::~SkeletonEvaluationScheduler() {}
+
+bool SkeletonEvaluationScheduler::Initialize(const InfoType& info, BufferType* pBuffer,
+                                             ptrdiff_t bufferOffset, void* pMemory,
+                                             [[maybe_unused]] size_t memorySize) {
+    int workerCount = info.GetWorkerCount();
+    size_t stackSize = AlignStackSize(info.GetThreadStackSize());
+
+    nn::util::BytePtr ptr(pMemory);
+    void* pStacks = ptr.Get();
+    m_pWorkers = ptr.Advance(stackSize * (workerCount - 1)).Get<Worker>();
+    m_pEntries = ptr.Advance(sizeof(Worker) * workerCount).Get<Entry>();
+
+    m_WorkerCount = workerCount;
+    m_IsExitRequested = false;
+    for (int idxWorker = 0; idxWorker < workerCount; ++idxWorker) {
+        Worker& worker = m_pWorkers[idxWorker];
+        worker.pScheduler = this;
+        worker.index = idxWorker;
+        worker.beginEntry = 0;
+        worker.endEntry = 0;
+        worker.boneCount = 0;
+        if (idxWorker == 0) {
+            continue;
+        }
+
+        nn::os::InitializeEvent(&worker.startEvent, false, nn::os::EventClearMode_AutoClear);
+        nn::os::InitializeEvent(&worker.doneEvent, false, nn::os::EventClearMode_AutoClear);
+        void* pStack = nn::util::BytePtr(pStacks, stackSize * (idxWorker - 1)).Get();
+        if (nn::os::CreateThread(&worker.thread, WorkerThreadFunc, &worker, pStack, stackSize,
+                                 info.GetThreadPriority(),
+                                 GetIdealCore(info.GetWorkerCoreMask(), idxWorker))
+                .IsFailure()) {
+            nn::os::FinalizeEvent(&worker.startEvent);
+            nn::os::FinalizeEvent(&worker.doneEvent);
+            m_WorkerCount = idxWorker;
+            Finalize();
+            return false;
+        }
+        nn::os::SetThreadNamePointer(&worker.thread, "g3d::SkeletonEvaluation");
+        nn::os::StartThread(&worker.thread);
+    }
+
+    m_pBuffer = pBuffer;
+    m_pMappedBuffer = pBuffer->Map();
+    m_BufferOffset = bufferOffset;
+    m_SectionSize = info.GetPaletteSectionSize();
+    m_MaxEntryCount = info.GetMaxSkeletonCount();
+    m_BufferingCount = info.GetBufferingCount();
+    m_SectionIndex = 0;
+    m_EntryCount = 0;
+    m_UsedSize = 0;
+    return true;
+}
+
+void SkeletonEvaluationScheduler::Finalize() {
+    m_IsExitRequested = true;
+    for (int idxWorker = 1; idxWorker < m_WorkerCount; ++idxWorker) {
+        Worker& worker = m_pWorkers[idxWorker];
+        nn::os::SignalEvent(&worker.startEvent);
+        nn::os::WaitThread(&worker.thread);
+        nn::os::DestroyThread(&worker.thread);
+        nn::os::FinalizeEvent(&worker.startEvent);
+        nn::os::FinalizeEvent(&worker.doneEvent);
+    }
+
+    if (m_pBuffer != nullptr) {
+        m_pBuffer->Unmap();
+    }
+    m_pBuffer = nullptr;
+    m_pMappedBuffer = nullptr;
+    m_pEntries = nullptr;
+    m_pWorkers = nullptr;
+    m_WorkerCount = 0;
+    m_EntryCount = 0;
+}
+
+void SkeletonEvaluationScheduler::BeginFrame() {
+    m_SectionIndex = (m_SectionIndex + 1) % m_BufferingCount;
+    m_EntryCount = 0;
+    m_UsedSize = 0;
+}
+
+bool SkeletonEvaluationScheduler::Add(SkeletonEvaluator* pSkeleton,
+                                      const SkinningPaletteBuilder* pPaletteBuilder,
+                                      const nn::util::FloatColumnMajor4x3& baseMtx,
+                                      gfx::GpuAddress* pOutPaletteAddress) {
+    size_t paletteSize = pPaletteBuilder->GetPaletteSize();
+    if (m_EntryCount >= m_MaxEntryCount || m_UsedSize + paletteSize > m_SectionSize) {
+        return false;
+    }
+
+    Entry& entry = m_pEntries[m_EntryCount++];
+    entry.pSkeleton = pSkeleton;
+    entry.pPaletteBuilder = pPaletteBuilder;
+    entry.baseMtx = baseMtx;
+    entry.paletteOffset = m_UsedSize;
+    entry.paletteSize = paletteSize;
+    m_UsedSize = std::min(m_SectionSize, (m_UsedSize + paletteSize + PaletteAlignment - 1) &
+                                             ~(PaletteAlignment - 1));
+
+    m_pBuffer->GetGpuAddress(pOutPaletteAddress);
+    pOutPaletteAddress->Offset(GetSectionOffset() + entry.paletteOffset);
+    return true;
+}
+
+void SkeletonEvaluationScheduler::Start() {
+    int64_t totalBoneCount = 0;
+    for (int idxEntry = 0; idxEntry < m_EntryCount; ++idxEntry) {
+        totalBoneCount += m_pEntries[idxEntry].pSkeleton->GetBoneCount();
+    }
+
+    // contiguous runs keep the palettes of a worker in one range of the section
+    int idxEntry = 0;
+    int64_t accumulatedCount = 0;
+    for (int idxWorker = 0; idxWorker < m_WorkerCount; ++idxWorker) {
+        Worker& worker = m_pWorkers[idxWorker];
+        int64_t targetCount = totalBoneCount * (idxWorker + 1) / m_WorkerCount;
+        worker.beginEntry = idxEntry;
+        while (idxEntry < m_EntryCount &&
+               (accumulatedCount < targetCount || idxWorker == m_WorkerCount - 1)) {
+            accumulatedCount += m_pEntries[idxEntry++].pSkeleton->GetBoneCount();
+        }
+        worker.endEntry = idxEntry;
+        worker.boneCount = 0;
+    }
+
+    for (int idxWorker = 1; idxWorker < m_WorkerCount; ++idxWorker) {
+        nn::os::SignalEvent(&m_pWorkers[idxWorker].startEvent);
+    }
+}
+
+void SkeletonEvaluationScheduler::Wait() {
+    Execute(0);
+    for (int idxWorker = 1; idxWorker < m_WorkerCount; ++idxWorker) {
+        nn::os::WaitEvent(&m_pWorkers[idxWorker].doneEvent);
+    }
+}
+
+int SkeletonEvaluationScheduler::GetWorkerBoneCount(int workerIndex) const {
+    return m_pWorkers[workerIndex].boneCount;
+}
+
+void SkeletonEvaluationScheduler::WorkerThreadFunc(void* pArg) {
+    Worker* pWorker = static_cast<Worker*>(pArg);
+    for (;;) {
+        nn::os::WaitEvent(&pWorker->startEvent);
+        if (pWorker->pScheduler->m_IsExitRequested) {
+            break;
+        }
+        pWorker->pScheduler->Execute(pWorker->index);
+        nn::os::SignalEvent(&pWorker->doneEvent);
+    }
+}
+
+void SkeletonEvaluationScheduler::Execute(int workerIndex) {
+    Worker& worker = m_pWorkers[workerIndex];
+    if (worker.beginEntry == worker.endEntry) {
+        return;
+    }
+
+    ptrdiff_t sectionOffset = GetSectionOffset();
+    for (int idxEntry = worker.beginEntry; idxEntry < worker.endEntry; ++idxEntry) {
+        Entry& entry = m_pEntries[idxEntry];
+        entry.pSkeleton->CalculateWorld(entry.baseMtx);
+        nn::util::FloatColumnMajor4x3* pPalette =
+            nn::util::BytePtr(m_pMappedBuffer, sectionOffset + entry.paletteOffset)
+                .Get<nn::util::FloatColumnMajor4x3>();
+        entry.pPaletteBuilder->Build(pPalette, *entry.pSkeleton);
+        worker.boneCount += entry.pSkeleton->GetBoneCount();
+    }
+
+    // one flush covers the palettes of the run
+    const Entry& first = m_pEntries[worker.beginEntry];
+    const Entry& last = m_pEntries[worker.endEntry - 1];
+    m_pBuffer->FlushMappedRange(sectionOffset + first.paletteOffset,
+                                last.paletteOffset + last.paletteSize - first.paletteOffset);
+}
+
+ptrdiff_t SkeletonEvaluationScheduler::GetSectionOffset() const {
+    return m_BufferOffset + m_SectionSize * m_SectionIndex;
+}
+
+}  // namespace nn::g3d
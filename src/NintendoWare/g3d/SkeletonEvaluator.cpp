@@ -0,0 +1,434 @@
+#include <nn/g3d/SkeletonEvaluator.h>
+
+#include <nn/util/util_BytePtr.h>
+
+#include <algorithm>
+#include <cstring>
+
+#include "detail/MathHelper.h"
+
+namespace nn::g3d {
+
+namespace {
+
+int AlignBoneCount(int boneCount) {
+    return (boneCount + SkeletonEvaluator::SimdWidth - 1) & ~(SkeletonEvaluator::SimdWidth - 1);
+}
+
+int CalculateDepth(const ResSkeleton* pRes, int boneIndex) {
+    int depth = 0;
+    for (int idx = pRes->GetBone(boneIndex)->GetParentIndex(); idx != ResBone::InvalidBoneIndex;
+         idx = pRes->GetBone(idx)->GetParentIndex()) {
+        ++depth;
+    }
+    return depth;
+}
+
+bool IsBoneActive(const ResSkeleton* pRes, const bool* pActiveArray, int boneIndex) {
+    for (int idx = boneIndex; idx != ResBone::InvalidBoneIndex;
+         idx = pRes->GetBone(idx)->GetParentIndex()) {
+        if (!pActiveArray[idx]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void SetIdentity(nn::util::FloatColumnMajor4x3* pMtx) {
+    std::memset(pMtx, 0, sizeof(*pMtx));
+    pMtx->m[0][0] = 1.0f;
+    pMtx->m[1][1] = 1.0f;
+    pMtx->m[2][2] = 1.0f;
+}
+
+}  // namespace
+
+size_t SkeletonEvaluator::CalculateBufferSize(const InitializeArgument& arg) {
+    int boneCount = arg.GetResource()->GetBoneCount();
+    int alignedCount = AlignBoneCount(boneCount);
+
+    size_t size = sizeof(nn::util::FloatColumnMajor4x3) * boneCount;
+    size += sizeof(float) * (LocalElement_Count + LocalMtxElementCount) * alignedCount;
+    size += sizeof(nn::Bit32) * alignedCount;
+    size += sizeof(uint16_t) * alignedCount;
+    size += sizeof(uint16_t) * boneCount;
+    size += sizeof(uint16_t) * (boneCount + 1);
+    size += sizeof(uint16_t) * boneCount;
+    size += sizeof(uint16_t) * (boneCount + 1);
+    return size;
+}
+
+size_t SkeletonEvaluator::GetBufferAlignment() {
+    return sizeof(float) * SimdWidth;
+}
+
+SkeletonEvaluator::SkeletonEvaluator()
+    : m_Res(nullptr), m_WorldMtxArray(nullptr), m_LocalArray(), m_LocalMtxArray(),
+      m_BoneFlagArray(nullptr), m_ParentIndexArray(nullptr), m_BoneOrder(nullptr),
+      m_LevelOffsetArray(nullptr), m_ActiveOrder(nullptr), m_ActiveLevelOffsetArray(nullptr),
+      m_BoneCount(0), m_LevelCount(0), m_ActiveBoneCount(0), m_ActiveLevelCount(0) {}
+
+bool SkeletonEvaluator::Initialize(const InitializeArgument& arg, void* buffer, size_t bufferSize) {
+    if (buffer == nullptr || bufferSize < CalculateBufferSize(arg)) {
+        return false;
+    }
+
+    const ResSkeleton* pRes = arg.GetResource();
+    int boneCount = pRes->GetBoneCount();
+    int alignedCount = AlignBoneCount(boneCount);
+
+    nn::util::BytePtr ptr(buffer);
+    m_WorldMtxArray = ptr.Get<nn::util::FloatColumnMajor4x3>();
+    ptr.Advance(sizeof(nn::util::FloatColumnMajor4x3) * boneCount);
+    for (int idxElement = 0; idxElement < LocalElement_Count; ++idxElement) {
+        m_LocalArray[idxElement] = ptr.Get<float>();
+        ptr.Advance(sizeof(float) * alignedCount);
+    }
+    for (int idxElement = 0; idxElement < LocalMtxElementCount; ++idxElement) {
+        m_LocalMtxArray[idxElement] = ptr.Get<float>();
+        ptr.Advance(sizeof(float) * alignedCount);
+    }
+    m_BoneFlagArray = ptr.Get<nn::Bit32>();
+    m_ParentIndexArray = ptr.Advance(sizeof(nn::Bit32) * alignedCount).Get<uint16_t>();
+    m_BoneOrder = ptr.Advance(sizeof(uint16_t) * alignedCount).Get<uint16_t>();
+    m_LevelOffsetArray = ptr.Advance(sizeof(uint16_t) * boneCount).Get<uint16_t>();
+    m_ActiveOrder = ptr.Advance(sizeof(uint16_t) * (boneCount + 1)).Get<uint16_t>();
+    m_ActiveLevelOffsetArray = ptr.Advance(sizeof(uint16_t) * boneCount).Get<uint16_t>();
+
+    m_Res = pRes;
+    m_BoneCount = boneCount;
+
+    // the padding lanes hold an identity bone without a parent
+    for (int idxBone = 0; idxBone < alignedCount; ++idxBone) {
+        m_ParentIndexArray[idxBone] =
+            idxBone < boneCount ? pRes->GetBone(idxBone)->GetParentIndex()
+                                : uint16_t(ResBone::InvalidBoneIndex);
+    }
+    for (int idxBone = boneCount; idxBone < alignedCount; ++idxBone) {
+        m_LocalArray[LocalElement_ScaleX][idxBone] = 1.0f;
+        m_LocalArray[LocalElement_ScaleY][idxBone] = 1.0f;
+        m_LocalArray[LocalElement_ScaleZ][idxBone] = 1.0f;
+        m_LocalArray[LocalElement_RotateX][idxBone] = 0.0f;
+        m_LocalArray[LocalElement_RotateY][idxBone] = 0.0f;
+        m_LocalArray[LocalElement_RotateZ][idxBone] = 0.0f;
+        m_LocalArray[LocalElement_RotateW][idxBone] = 1.0f;
+        m_LocalArray[LocalElement_TranslateX][idxBone] = 0.0f;
+        m_LocalArray[LocalElement_TranslateY][idxBone] = 0.0f;
+        m_LocalArray[LocalElement_TranslateZ][idxBone] = 0.0f;
+        m_BoneFlagArray[idxBone] = ResBone::Flag_Identity;
+    }
+
+    // counting sort by depth, the level offsets are the running counts
+    m_LevelCount = 0;
+    std::fill(m_LevelOffsetArray, m_LevelOffsetArray + boneCount + 1, uint16_t(0));
+    for (int idxBone = 0; idxBone < boneCount; ++idxBone) {
+        int depth = CalculateDepth(pRes, idxBone);
+        ++m_LevelOffsetArray[depth + 1];
+        m_LevelCount = std::max(m_LevelCount, depth + 1);
+    }
+    for (int idxLevel = 0; idxLevel < m_LevelCount; ++idxLevel) {
+        m_LevelOffsetArray[idxLevel + 1] += m_LevelOffsetArray[idxLevel];
+    }
+    for (int idxBone = 0; idxBone < boneCount; ++idxBone) {
+        int depth = CalculateDepth(pRes, idxBone);
+        m_BoneOrder[m_LevelOffsetArray[depth]++] = idxBone;
+    }
+    for (int idxLevel = m_LevelCount; idxLevel > 0; --idxLevel) {
+        m_LevelOffsetArray[idxLevel] = m_LevelOffsetArray[idxLevel - 1];
+    }
+    m_LevelOffsetArray[0] = 0;
+
+    SetActiveBones(nullptr);
+    ClearLocal();
+    for (int idxBone = 0; idxBone < boneCount; ++idxBone) {
+        SetIdentity(&m_WorldMtxArray[idxBone]);
+    }
+    return true;
+}
+
+void SkeletonEvaluator::ClearLocal() {
+    for (int idxBone = 0; idxBone < m_BoneCount; ++idxBone) {
+        const ResBone* pBone = m_Res->GetBone(idxBone);
+
+        nn::util::Float4 quat = pBone->GetRotateMode() == ResBone::RotateMode_EulerXyz
+                                    ? detail::ConvertEulerXyzToQuat(pBone->GetRotateEuler())
+                                    : pBone->GetRotateQuat();
+        const nn::util::Float3& scale = pBone->GetScale();
+        const nn::util::Float3& translate = pBone->GetTranslate();
+
+        m_LocalArray[LocalElement_ScaleX][idxBone] = scale.x;
+        m_LocalArray[LocalElement_ScaleY][idxBone] = scale.y;
+        m_LocalArray[LocalElement_ScaleZ][idxBone] = scale.z;
+        m_LocalArray[LocalElement_RotateX][idxBone] = quat.x;
+        m_LocalArray[LocalElement_RotateY][idxBone] = quat.y;
+        m_LocalArray[LocalElement_RotateZ][idxBone] = quat.z;
+        m_LocalArray[LocalElement_RotateW][idxBone] = quat.w;
+        m_LocalArray[LocalElement_TranslateX][idxBone] = translate.x;
+        m_LocalArray[LocalElement_TranslateY][idxBone] = translate.y;
+        m_LocalArray[LocalElement_TranslateZ][idxBone] = translate.z;
+
+        // the converter already computed the transform flags of the bind pose
+        m_BoneFlagArray[idxBone] = pBone->ToData().flag & ResBone::Mask_Transform;
+    }
+}
+
+void SkeletonEvaluator::SetLocalScale(int boneIndex, const nn::util::Float3& scale) {
+    m_LocalArray[LocalElement_ScaleX][boneIndex] = scale.x;
+    m_LocalArray[LocalElement_ScaleY][boneIndex] = scale.y;
+    m_LocalArray[LocalElement_ScaleZ][boneIndex] = scale.z;
+    UpdateLocalFlag(boneIndex);
+}
+
+void SkeletonEvaluator::SetLocalRotate(int boneIndex, const nn::util::Float4& quat) {
+    m_LocalArray[LocalElement_RotateX][boneIndex] = quat.x;
+    m_LocalArray[LocalElement_RotateY][boneIndex] = quat.y;
+    m_LocalArray[LocalElement_RotateZ][boneIndex] = quat.z;
+    m_LocalArray[LocalElement_RotateW][boneIndex] = quat.w;
+    UpdateLocalFlag(boneIndex);
+}
+
+void SkeletonEvaluator::SetLocalTranslate(int boneIndex, const nn::util::Float3& translate) {
+    m_LocalArray[LocalElement_TranslateX][boneIndex] = translate.x;
+    m_LocalArray[LocalElement_TranslateY][boneIndex] = translate.y;
+    m_LocalArray[LocalElement_TranslateZ][boneIndex] = translate.z;
+    UpdateLocalFlag(boneIndex);
+}
+
+void SkeletonEvaluator::UpdateLocalFlags() {
+    for (int idxBone = 0; idxBone < m_BoneCount; ++idxBone) {
+        UpdateLocalFlag(idxBone);
+    }
+}
+
+void SkeletonEvaluator::SetActiveBones(const bool* pActiveArray) {
+    // the active bones keep the depth order and are followed by the collapsed ones, which are in
+    // depth order as well. descendants of collapsed bones are collapsed, so the active levels
+    // are a prefix of the levels
+    int activeCount = 0;
+    for (int idxBone = 0; idxBone < m_BoneCount; ++idxBone) {
+        activeCount += pActiveArray == nullptr || IsBoneActive(m_Res, pActiveArray, idxBone);
+    }
+
+    int activeIndex = 0;
+    int collapsedIndex = activeCount;
+    m_ActiveLevelCount = 0;
+    for (int idxLevel = 0; idxLevel < m_LevelCount; ++idxLevel) {
+        m_ActiveLevelOffsetArray[idxLevel] = activeIndex;
+        for (int idxOrder = m_LevelOffsetArray[idxLevel];
+             idxOrder < m_LevelOffsetArray[idxLevel + 1]; ++idxOrder) {
+            int boneIndex = m_BoneOrder[idxOrder];
+            if (pActiveArray == nullptr || IsBoneActive(m_Res, pActiveArray, boneIndex)) {
+                m_ActiveOrder[activeIndex++] = boneIndex;
+            } else {
+                m_ActiveOrder[collapsedIndex++] = boneIndex;
+            }
+        }
+        m_ActiveLevelCount += activeIndex > m_ActiveLevelOffsetArray[idxLevel];
+    }
+    m_ActiveLevelOffsetArray[m_ActiveLevelCount] = activeIndex;
+    m_ActiveBoneCount = activeCount;
+}
+
+void SkeletonEvaluator::UpdateLocalFlag(int boneIndex) {
+    float sx = m_LocalArray[LocalElement_ScaleX][boneIndex];
+    float sy = m_LocalArray[LocalElement_ScaleY][boneIndex];
+    float sz = m_LocalArray[LocalElement_ScaleZ][boneIndex];
+
+    nn::Bit32 flag = m_BoneFlagArray[boneIndex] & ~nn::Bit32(ResBone::Flag_Identity);
+    if (sx == sy && sy == sz) {
+        flag |= ResBone::Flag_ScaleUniform;
+    }
+    if (sx * sy * sz == 1.0f) {
+        flag |= ResBone::Flag_ScaleVolumeOne;
+    }
+    if (m_LocalArray[LocalElement_RotateX][boneIndex] == 0.0f &&
+        m_LocalArray[LocalElement_RotateY][boneIndex] == 0.0f &&
+        m_LocalArray[LocalElement_RotateZ][boneIndex] == 0.0f) {
+        flag |= ResBone::Flag_RotateZero;
+    }
+    if (m_LocalArray[LocalElement_TranslateX][boneIndex] == 0.0f &&
+        m_LocalArray[LocalElement_TranslateY][boneIndex] == 0.0f &&
+        m_LocalArray[LocalElement_TranslateZ][boneIndex] == 0.0f) {
+        flag |= ResBone::Flag_TranslateZero;
+    }
+    m_BoneFlagArray[boneIndex] = flag;
+}
+
+void SkeletonEvaluator::CalculateLocalMtx() {
+    // the lane loops have no dependency between bones and are left to the vectorizer
+    int alignedCount = AlignBoneCount(m_BoneCount);
+    for (int idxBatch = 0; idxBatch < alignedCount; idxBatch += SimdWidth) {
+        const nn::Bit32* pFlags = &m_BoneFlagArray[idxBatch];
+        bool isIdentity = true;
+        for (int lane = 0; lane < SimdWidth; ++lane) {
+            isIdentity &= (pFlags[lane] & ResBone::Mask_Transform) == ResBone::Flag_Identity;
+        }
+        if (isIdentity) {
+            for (int idxElement = 0; idxElement < LocalMtxElementCount; ++idxElement) {
+                float value = idxElement % 5 == 0 ? 1.0f : 0.0f;
+                std::fill_n(&m_LocalMtxArray[idxElement][idxBatch], SimdWidth, value);
+            }
+            continue;
+        }
+
+        // segment scale compensation removes the scale of the parent from the child rotation
+        float invParentScale[3][SimdWidth];
+        for (int lane = 0; lane < SimdWidth; ++lane) {
+            int parentIndex = m_ParentIndexArray[idxBatch + lane];
+            bool isCompensated = (pFlags[lane] & ResBone::Flag_SegmentScaleCompensate) != 0 &&
+                                 parentIndex != ResBone::InvalidBoneIndex;
+            for (int axis = 0; axis < 3; ++axis) {
+                invParentScale[axis][lane] =
+                    isCompensated
+                        ? 1.0f / m_LocalArray[LocalElement_ScaleX + axis][parentIndex]
+                        : 1.0f;
+            }
+        }
+
+        const float* sx = &m_LocalArray[LocalElement_ScaleX][idxBatch];
+        const float* sy = &m_LocalArray[LocalElement_ScaleY][idxBatch];
+        const float* sz = &m_LocalArray[LocalElement_ScaleZ][idxBatch];
+        const float* qx = &m_LocalArray[LocalElement_RotateX][idxBatch];
+        const float* qy = &m_LocalArray[LocalElement_RotateY][idxBatch];
+        const float* qz = &m_LocalArray[LocalElement_RotateZ][idxBatch];
+        const float* qw = &m_LocalArray[LocalElement_RotateW][idxBatch];
+        float* m[LocalMtxElementCount];
+        for (int idxElement = 0; idxElement < LocalMtxElementCount; ++idxElement) {
+            m[idxElement] = &m_LocalMtxArray[idxElement][idxBatch];
+        }
+
+        for (int lane = 0; lane < SimdWidth; ++lane) {
+            float xx = qx[lane] * qx[lane];
+            float yy = qy[lane] * qy[lane];
+            float zz = qz[lane] * qz[lane];
+            float xy = qx[lane] * qy[lane];
+            float xz = qx[lane] * qz[lane];
+            float yz = qy[lane] * qz[lane];
+            float wx = qw[lane] * qx[lane];
+            float wy = qw[lane] * qy[lane];
+            float wz = qw[lane] * qz[lane];
+            float isx = invParentScale[0][lane];
+            float isy = invParentScale[1][lane];
+            float isz = invParentScale[2][lane];
+
+            m[0][lane] = isx * (1.0f - 2.0f * (yy + zz)) * sx[lane];
+            m[1][lane] = isx * 2.0f * (xy - wz) * sy[lane];
+            m[2][lane] = isx * 2.0f * (xz + wy) * sz[lane];
+            m[4][lane] = isy * 2.0f * (xy + wz) * sx[lane];
+            m[5][lane] = isy * (1.0f - 2.0f * (xx + zz)) * sy[lane];
+            m[6][lane] = isy * 2.0f * (yz - wx) * sz[lane];
+            m[8][lane] = isz * 2.0f * (xz - wy) * sx[lane];
+            m[9][lane] = isz * 2.0f * (yz + wx) * sy[lane];
+            m[10][lane] = isz * (1.0f - 2.0f * (xx + yy)) * sz[lane];
+        }
+        std::copy_n(&m_LocalArray[LocalElement_TranslateX][idxBatch], SimdWidth, m[3]);
+        std::copy_n(&m_LocalArray[LocalElement_TranslateY][idxBatch], SimdWidth, m[7]);
+        std::copy_n(&m_LocalArray[LocalElement_TranslateZ][idxBatch], SimdWidth, m[11]);
+    }
+}
+
+void SkeletonEvaluator::CalculateWorld(const nn::util::FloatColumnMajor4x3& baseMtx,
+                                 ICalculateWorldCallback* pCallback) {
+    CalculateLocalMtx();
+
+    const nn::Bit32 HiMask = ResBone::Flag_HiIdentity;
+    for (int idxLevel = 0; idxLevel < m_ActiveLevelCount; ++idxLevel) {
+        int levelEnd = m_ActiveLevelOffsetArray[idxLevel + 1];
+        for (int idxBatch = m_ActiveLevelOffsetArray[idxLevel]; idxBatch < levelEnd;
+             idxBatch += SimdWidth) {
+            const uint16_t* pBones = &m_ActiveOrder[idxBatch];
+            int laneCount = std::min(SimdWidth, levelEnd - idxBatch);
+
+            // a bone keeps a Flag_Hi* bit only when it and every ancestor have the local bit
+            bool isHiIdentity = true;
+            for (int lane = 0; lane < laneCount; ++lane) {
+                int boneIndex = pBones[lane];
+                int parentIndex = m_ParentIndexArray[boneIndex];
+                nn::Bit32 flag = m_BoneFlagArray[boneIndex];
+                nn::Bit32 parentHi = parentIndex == ResBone::InvalidBoneIndex
+                                         ? HiMask
+                                         : m_BoneFlagArray[parentIndex] & HiMask;
+                nn::Bit32 hi = ((flag & ResBone::Flag_Identity) << ResBone::Shift_Hierarchy) &
+                               parentHi;
+                m_BoneFlagArray[boneIndex] = (flag & ~HiMask) | hi;
+                isHiIdentity &= hi == HiMask;
+            }
+
+            if (isHiIdentity) {
+                for (int lane = 0; lane < laneCount; ++lane) {
+                    m_WorldMtxArray[pBones[lane]] = baseMtx;
+                }
+            } else {
+                float p[LocalMtxElementCount][SimdWidth] = {};
+                float l[LocalMtxElementCount][SimdWidth] = {};
+                for (int lane = 0; lane < laneCount; ++lane) {
+                    int boneIndex = pBones[lane];
+                    int parentIndex = m_ParentIndexArray[boneIndex];
+                    const float* pParent =
+                        &(parentIndex == ResBone::InvalidBoneIndex
+                              ? baseMtx
+                              : m_WorldMtxArray[parentIndex])
+                             .m[0][0];
+                    for (int idxElement = 0; idxElement < LocalMtxElementCount; ++idxElement) {
+                        p[idxElement][lane] = pParent[idxElement];
+                        l[idxElement][lane] = m_LocalMtxArray[idxElement][boneIndex];
+                    }
+                }
+
+                float w[LocalMtxElementCount][SimdWidth];
+                for (int row = 0; row < 3; ++row) {
+                    const float* p0 = p[row * 4 + 0];
+                    const float* p1 = p[row * 4 + 1];
+                    const float* p2 = p[row * 4 + 2];
+                    const float* p3 = p[row * 4 + 3];
+                    for (int column = 0; column < 4; ++column) {
+                        float* pOut = w[row * 4 + column];
+                        for (int lane = 0; lane < SimdWidth; ++lane) {
+                            pOut[lane] = p0[lane] * l[column][lane] +
+                                         p1[lane] * l[4 + column][lane] +
+                                         p2[lane] * l[8 + column][lane];
+                        }
+                    }
+                    for (int lane = 0; lane < SimdWidth; ++lane) {
+                        w[row * 4 + 3][lane] += p3[lane];
+                    }
+                }
+
+                for (int lane = 0; lane < laneCount; ++lane) {
+                    float* pWorld = &m_WorldMtxArray[pBones[lane]].m[0][0];
+                    for (int idxElement = 0; idxElement < LocalMtxElementCount; ++idxElement) {
+                        pWorld[idxElement] = w[idxElement][lane];
+                    }
+                }
+            }
+
+            if (pCallback != nullptr) {
+                for (int lane = 0; lane < laneCount; ++lane) {
+                    InvokeCallback(pCallback, pBones[lane]);
+                }
+            }
+        }
+    }
+
+    // every ancestor of a collapsed bone comes before it in the order
+    for (int idxOrder = m_ActiveBoneCount; idxOrder < m_BoneCount; ++idxOrder) {
+        int boneIndex = m_ActiveOrder[idxOrder];
+        int parentIndex = m_ParentIndexArray[boneIndex];
+        bool isRoot = parentIndex == ResBone::InvalidBoneIndex;
+        nn::Bit32 parentHi = isRoot ? HiMask : m_BoneFlagArray[parentIndex] & HiMask;
+        m_WorldMtxArray[boneIndex] = isRoot ? baseMtx : m_WorldMtxArray[parentIndex];
+        m_BoneFlagArray[boneIndex] = (m_BoneFlagArray[boneIndex] & ~HiMask) | parentHi;
+        if (pCallback != nullptr) {
+            InvokeCallback(pCallback, boneIndex);
+        }
+    }
+}
+
+void SkeletonEvaluator::InvokeCallback(ICalculateWorldCallback* pCallback, int boneIndex) {
+    ICalculateWorldCallback::CallbackArg arg(boneIndex);
+    WorldMtxManip manip(&m_WorldMtxArray[boneIndex], &m_BoneFlagArray[boneIndex]);
+    pCallback->Exec(arg, manip);
+    m_BoneFlagArray[boneIndex] &= ~ResBone::Flag_HiIdentity;
+}
+
+}  // namespace nn::g3d
@@ -0,0 +1,144 @@
+#include <nn/g3d/SkinningPaletteBuilder.h>
+
+#include <nn/g3d/ResSkeleton.h>
+#include <nn/g3d/SkeletonEvaluator.h>
+#include <nn/gfx/detail/gfx_Buffer-api.nvn.8.h>
+#include <nn/util/util_BytePtr.h>
+
+#include <algorithm>
+
+namespace nn::g3d {
+
+namespace {
+
+constexpr int SimdWidth = SkeletonEvaluator::SimdWidth;
+
+int AlignMtxCount(int mtxCount) {
+    return (mtxCount + SimdWidth - 1) & ~(SimdWidth - 1);
+}
+
+}  // namespace
+
+size_t SkinningPaletteBuilder::CalculateBufferSize(const ResSkeleton* pRes) {
+    int alignedSmoothCount = AlignMtxCount(pRes->GetSmoothMtxCount());
+    return sizeof(float) * MtxElementCount * alignedSmoothCount +
+           sizeof(uint16_t) * (alignedSmoothCount + pRes->GetRigidMtxCount());
+}
+
+size_t SkinningPaletteBuilder::GetBufferAlignment() {
+    return sizeof(float) * SimdWidth;
+}
+
+SkinningPaletteBuilder::SkinningPaletteBuilder()
+    : m_Res(nullptr), m_InvModelMtxArray(), m_SmoothBoneIndexArray(nullptr),
+      m_RigidBoneIndexArray(nullptr), m_SmoothMtxCount(0), m_RigidMtxCount(0) {}
+
+bool SkinningPaletteBuilder::Initialize(const ResSkeleton* pRes, void* buffer,
+                                        size_t bufferSize) {
+    if (buffer == nullptr || bufferSize < CalculateBufferSize(pRes)) {
+        return false;
+    }
+
+    int smoothMtxCount = pRes->GetSmoothMtxCount();
+    int rigidMtxCount = pRes->GetRigidMtxCount();
+    int alignedSmoothCount = AlignMtxCount(smoothMtxCount);
+
+    nn::util::BytePtr ptr(buffer);
+    for (int idxElement = 0; idxElement < MtxElementCount; ++idxElement) {
+        m_InvModelMtxArray[idxElement] = ptr.Get<float>();
+        ptr.Advance(sizeof(float) * alignedSmoothCount);
+    }
+    m_SmoothBoneIndexArray = ptr.Get<uint16_t>();
+    m_RigidBoneIndexArray = ptr.Advance(sizeof(uint16_t) * alignedSmoothCount).Get<uint16_t>();
+
+    // slots no bone claims take the root, the padding lanes an identity inverse bind matrix
+    std::fill_n(m_SmoothBoneIndexArray, alignedSmoothCount, uint16_t(0));
+    std::fill_n(m_RigidBoneIndexArray, rigidMtxCount, uint16_t(0));
+    for (int idxBone = 0; idxBone < pRes->GetBoneCount(); ++idxBone) {
+        const ResBone* pBone = pRes->GetBone(idxBone);
+        int smoothMtxIndex = pBone->GetSmoothMtxIndex();
+        int rigidMtxIndex = pBone->GetRigidMtxIndex() - smoothMtxCount;
+        if (smoothMtxIndex >= 0 && smoothMtxIndex < smoothMtxCount) {
+            m_SmoothBoneIndexArray[smoothMtxIndex] = idxBone;
+        }
+        if (rigidMtxIndex >= 0 && rigidMtxIndex < rigidMtxCount) {
+            m_RigidBoneIndexArray[rigidMtxIndex] = idxBone;
+        }
+    }
+
+    const nn::util::FloatColumnMajor4x3* pInvModelMtx = pRes->ToData().pInvModelMatrixArray.Get();
+    for (int idxMtx = 0; idxMtx < alignedSmoothCount; ++idxMtx) {
+        for (int idxElement = 0; idxElement < MtxElementCount; ++idxElement) {
+            m_InvModelMtxArray[idxElement][idxMtx] =
+                idxMtx < smoothMtxCount ? pInvModelMtx[idxMtx].m[idxElement / 4][idxElement % 4]
+                : idxElement % 5 == 0   ? 1.0f
+                                        : 0.0f;
+        }
+    }
+
+    m_Res = pRes;
+    m_SmoothMtxCount = smoothMtxCount;
+    m_RigidMtxCount = rigidMtxCount;
+    return true;
+}
+
+size_t SkinningPaletteBuilder::Build(nn::util::FloatColumnMajor4x3* pOutMtxArray,
+                                     const SkeletonEvaluator& skeleton) const {
+    const nn::util::FloatColumnMajor4x3* pWorldMtx = skeleton.GetWorldMtxArray();
+
+    for (int idxBatch = 0; idxBatch < m_SmoothMtxCount; idxBatch += SimdWidth) {
+        int laneCount = std::min(SimdWidth, m_SmoothMtxCount - idxBatch);
+
+        float w[MtxElementCount][SimdWidth];
+        for (int lane = 0; lane < SimdWidth; ++lane) {
+            const float* pWorld = &pWorldMtx[m_SmoothBoneIndexArray[idxBatch + lane]].m[0][0];
+            for (int idxElement = 0; idxElement < MtxElementCount; ++idxElement) {
+                w[idxElement][lane] = pWorld[idxElement];
+            }
+        }
+
+        const float* i[MtxElementCount];
+        for (int idxElement = 0; idxElement < MtxElementCount; ++idxElement) {
+            i[idxElement] = &m_InvModelMtxArray[idxElement][idxBatch];
+        }
+
+        float out[MtxElementCount][SimdWidth];
+        for (int row = 0; row < 3; ++row) {
+            for (int column = 0; column < 4; ++column) {
+                for (int lane = 0; lane < SimdWidth; ++lane) {
+                    out[row * 4 + column][lane] = w[row * 4 + 0][lane] * i[column][lane] +
+                                                  w[row * 4 + 1][lane] * i[4 + column][lane] +
+                                                  w[row * 4 + 2][lane] * i[8 + column][lane];
+                }
+            }
+            for (int lane = 0; lane < SimdWidth; ++lane) {
+                out[row * 4 + 3][lane] += w[row * 4 + 3][lane];
+            }
+        }
+
+        // whole matrices in palette order, the destination is usually write combined
+        for (int lane = 0; lane < laneCount; ++lane) {
+            float* pOut = &pOutMtxArray[idxBatch + lane].m[0][0];
+            for (int idxElement = 0; idxElement < MtxElementCount; ++idxElement) {
+                pOut[idxElement] = out[idxElement][lane];
+            }
+        }
+    }
+
+    nn::util::FloatColumnMajor4x3* pOutRigid = pOutMtxArray + m_SmoothMtxCount;
+    for (int idxMtx = 0; idxMtx < m_RigidMtxCount; ++idxMtx) {
+        pOutRigid[idxMtx] = pWorldMtx[m_RigidBoneIndexArray[idxMtx]];
+    }
+    return GetPaletteSize();
+}
+
+size_t SkinningPaletteBuilder::Build(BufferType* pBuffer, void* pMappedBuffer, ptrdiff_t offset,
+                                     const SkeletonEvaluator& skeleton) const {
+    size_t size = Build(nn::util::BytePtr(pMappedBuffer, offset)
+                            .Get<nn::util::FloatColumnMajor4x3>(),
+                        skeleton);
+    pBuffer->FlushMappedRange(offset, size);
+    return size;
+}
+
+}  // namespace nn::g3d
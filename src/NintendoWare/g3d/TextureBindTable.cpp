@@ -0,0 +1,160 @@
+#include <nn/g3d/TextureBindTable.h>
+
+#include <nn/gfx/gfx_ResTextureData.h>
+#include <nn/util/util_BytePtr.h>
+#include <nn/util/util_ResDic.h>
+
+#include <cstring>
+
+namespace nn::g3d {
+
+struct TextureBindTable::Entry {
+    const char* name;
+    uint32_t length;
+    TextureRef textureRef;
+};
+
+// entryIndex is InvalidIndex for a name the table does not hold
+struct TextureBindTable::CacheEntry {
+    const char* name;
+    int entryIndex;
+};
+
+namespace {
+
+typedef nn::gfx::util::detail::ObjectCacheIndex IndexType;
+
+uint32_t HashPointer(const char* name) {
+    return nn::gfx::util::detail::CalculateObjectCacheHash(&name, sizeof(name));
+}
+
+}  // namespace
+
+size_t TextureBindTable::CalculateBufferSize(int maxTextureCount) {
+    // one index over the names and one over the remembered pointers, each as large as the table
+    int bucketCount = IndexType::CalculateBucketCount(maxTextureCount);
+    return (sizeof(Entry) + sizeof(CacheEntry)) * maxTextureCount +
+           (sizeof(int32_t) + sizeof(uint32_t)) * bucketCount * 2;
+}
+
+size_t TextureBindTable::GetBufferAlignment() {
+    return alignof(Entry);
+}
+
+TextureRef TextureBindTable::BindCallback(const char* name, void* pUserData) {
+    return static_cast<TextureBindTable*>(pUserData)->Find(name);
+}
+
+TextureBindTable::TextureBindTable()
+    : m_EntryArray(nullptr), m_CacheArray(nullptr), m_EntryIndex(), m_CacheIndex(),
+      m_MaxTextureCount(0), m_TextureCount(0), m_CacheCount(0), m_UnresolvedCount(0) {}
+
+bool TextureBindTable::Initialize(int maxTextureCount, void* buffer, size_t bufferSize) {
+    if (buffer == nullptr || bufferSize < CalculateBufferSize(maxTextureCount)) {
+        return false;
+    }
+
+    int bucketCount = IndexType::CalculateBucketCount(maxTextureCount);
+    nn::util::BytePtr ptr(buffer);
+    m_EntryArray = ptr.Get<Entry>();
+    m_CacheArray = ptr.Advance(sizeof(Entry) * maxTextureCount).Get<CacheEntry>();
+    ptr.Advance(sizeof(CacheEntry) * maxTextureCount);
+    IndexType* pIndices[] = {&m_EntryIndex, &m_CacheIndex};
+    for (IndexType* pIndex : pIndices) {
+        int32_t* pBuckets = ptr.Get<int32_t>();
+        uint32_t* pHashes = ptr.Advance(sizeof(int32_t) * bucketCount).Get<uint32_t>();
+        ptr.Advance(sizeof(uint32_t) * bucketCount);
+        pIndex->Initialize(pBuckets, pHashes, bucketCount);
+    }
+    m_MaxTextureCount = maxTextureCount;
+    m_TextureCount = 0;
+    ClearCache();
+    return true;
+}
+
+bool TextureBindTable::Register(const char* name, TextureRef textureRef) {
+    size_t length = std::strlen(name);
+    uint32_t hash = nn::gfx::util::detail::CalculateObjectCacheHash(name, length);
+    int entryIndex = FindEntry(name, length, hash);
+    if (entryIndex == IndexType::InvalidIndex) {
+        if (m_TextureCount >= m_MaxTextureCount) {
+            return false;
+        }
+        entryIndex = m_TextureCount++;
+        m_EntryArray[entryIndex].name = name;
+        m_EntryArray[entryIndex].length = static_cast<uint32_t>(length);
+        m_EntryIndex.Insert(hash, entryIndex);
+
+        // a pointer remembered as unresolved may be this name. the count of what went
+        // unresolved so far stays as it is
+        ClearCacheSlots();
+    }
+    m_EntryArray[entryIndex].textureRef = textureRef;
+    return true;
+}
+
+int TextureBindTable::Register(const nn::gfx::ResTextureContainerData* pContainer,
+                               MakeTextureRefCallback pMakeTextureRef, void* pUserData) {
+    const nn::util::ResDic* pTextureDic = pContainer->pTextureDic.Get();
+    const nn::util::BinTPtr<nn::gfx::ResTexture>* pTexturePtrArray =
+        pContainer->pTexturePtrArray.Get();
+    int registeredCount = 0;
+    for (int idxTexture = 0; idxTexture < static_cast<int>(pContainer->textureCount);
+         ++idxTexture) {
+        const char* name = pTextureDic->GetKey(idxTexture).data();
+        TextureRef textureRef = pMakeTextureRef(pTexturePtrArray[idxTexture].Get(), pUserData);
+        registeredCount += Register(name, textureRef);
+    }
+    return registeredCount;
+}
+
+TextureRef TextureBindTable::Find(const char* name) {
+    uint32_t pointerHash = HashPointer(name);
+    int cacheIndex = m_CacheIndex.Find(
+        pointerHash, [&](int idxCache) { return m_CacheArray[idxCache].name == name; });
+
+    int entryIndex;
+    if (cacheIndex != IndexType::InvalidIndex) {
+        entryIndex = m_CacheArray[cacheIndex].entryIndex;
+    } else {
+        // the first reference through this pointer
+        size_t length = std::strlen(name);
+        entryIndex =
+            FindEntry(name, length, nn::gfx::util::detail::CalculateObjectCacheHash(name, length));
+        if (m_CacheCount < m_MaxTextureCount) {
+            m_CacheArray[m_CacheCount].name = name;
+            m_CacheArray[m_CacheCount].entryIndex = entryIndex;
+            m_CacheIndex.Insert(pointerHash, m_CacheCount++);
+        }
+    }
+
+    if (entryIndex == IndexType::InvalidIndex) {
+        ++m_UnresolvedCount;
+        return TextureRef();
+    }
+    return m_EntryArray[entryIndex].textureRef;
+}
+
+void TextureBindTable::ClearCache() {
+    ClearCacheSlots();
+    m_UnresolvedCount = 0;
+}
+
+int TextureBindTable::FindEntry(const char* name, size_t length, uint32_t hash) const {
+    // the string is only compared once the hash and the length match
+    return m_EntryIndex.Find(hash, [&](int entryIndex) {
+        const Entry& entry = m_EntryArray[entryIndex];
+        return entry.length == length && std::memcmp(entry.name, name, length) == 0;
+    });
+}
+
+void TextureBindTable::ClearCacheSlots() {
+    // clearing walks every bucket, which registering a whole level one name at a time must not do
+    if (m_CacheCount == 0) {
+        return;
+    }
+    m_CacheIndex.Clear();
+    m_CacheCount = 0;
+}
+
+}  // namespace nn::g3d
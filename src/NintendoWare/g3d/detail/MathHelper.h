@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cmath>
+
+#include "nn/util/MathTypes.h"
+
+namespace nn::g3d::detail {
+
+// x is applied first, then y, then z
+inline nn::util::Float4 ConvertEulerXyzToQuat(const nn::util::Float3& euler) {
+    float sx = std::sin(euler.x * 0.5f);
+    float cx = std::cos(euler.x * 0.5f);
+    float sy = std::sin(euler.y * 0.5f);
+    float cy = std::cos(euler.y * 0.5f);
+    float sz = std::sin(euler.z * 0.5f);
+    float cz = std::cos(euler.z * 0.5f);
+
+    nn::util::Float4 quat;
+    quat.x = sx * cy * cz - cx * sy * sz;
+    quat.y = cx * sy * cz + sx * cy * sz;
+    quat.z = cx * cy * sz - sx * sy * cz;
+    quat.w = cx * cy * cz + sx * sy * sz;
+    return quat;
+}
+
+}  // namespace nn::g3d::detail